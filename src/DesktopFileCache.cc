@@ -0,0 +1,227 @@
+/*  ---------------------------------------------------------
+               __  __            _
+              |  \/  |_   _ _ __| |_   _ _ __
+              | |\/| | | | | '__| | | | | '_ \
+              | |  | | |_| | |  | | |_| | | | |
+              |_|  |_|\__, |_|  |_|\__, |_| |_|
+                      |___/        |___/
+    ---------------------------------------------------------
+
+    Project:  Myrlyn Package Manager GUI
+    Copyright (c) Stefan Hundhammer <Stefan.Hundhammer@gmx.de>
+    License:  GPL V2 - See file LICENSE for details.
+
+    Textdomain "qt-pkg"
+ */
+
+
+#include <QCoreApplication>
+#include <QDataStream>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QRegularExpression>
+#include <QStandardPaths>
+
+#include "Exception.h"
+#include "Logger.h"
+#include "PoolGeneration.h"
+#include "DesktopFileCache.h"
+
+
+#define CACHE_FILE_NAME         "desktop-files.cache"
+#define CACHE_FILE_MAGIC        0x4d594443      // "MYDC"
+#define CACHE_FILE_VERSION      1
+
+// Drop the whole cache if it grows beyond this
+#define MAX_ENTRIES             5000
+
+
+DesktopFileCache *
+DesktopFileCache::instance()
+{
+    static DesktopFileCache * cache = 0;
+
+    if ( ! cache )
+    {
+        cache = new DesktopFileCache();
+        CHECK_NEW( cache );
+
+        cache->load();
+    }
+
+    return cache;
+}
+
+
+DesktopFileCache::DesktopFileCache()
+    : QObject()
+    , _dirty( false )
+{
+    if ( qApp )
+    {
+        connect( qApp, SIGNAL( aboutToQuit() ),
+                 this, SLOT  ( save()        ) );
+    }
+}
+
+
+DesktopFileCache::~DesktopFileCache()
+{
+    // NOP
+}
+
+
+bool
+DesktopFileCache::isDesktopFile( const QString & path )
+{
+    static const QRegularExpression desktopFileRegex( "/share/applications/.*\\.desktop$" );
+
+    // Check the cheap part first; this is called for each file of a package
+
+    return path.endsWith( ".desktop" ) && desktopFileRegex.match( path ).hasMatch();
+}
+
+
+bool
+DesktopFileCache::lookup( const QString & path, const QString & lang, DesktopFileEntry & entry )
+{
+    auto it = _entries.find( key( path, lang ) );
+
+    if ( it == _entries.end() )
+        return false;
+
+    int generation = PoolGeneration::contentGeneration();
+
+    if ( it->checkedGeneration != generation )
+    {
+        if ( mtime( path ) != it->mtime )
+        {
+            _entries.erase( it );
+            _dirty = true;
+
+            return false;
+        }
+
+        it->checkedGeneration = generation;
+    }
+
+    entry = it.value();
+
+    return true;
+}
+
+
+void
+DesktopFileCache::insert( const QString & path, const QString & lang, const DesktopFileEntry & entry )
+{
+    if ( _entries.size() >= MAX_ENTRIES )
+        _entries.clear();
+
+    DesktopFileEntry newEntry = entry;
+    newEntry.mtime             = mtime( path );
+    newEntry.checkedGeneration = PoolGeneration::contentGeneration();
+
+    _entries.insert( key( path, lang ), newEntry );
+    _dirty = true;
+}
+
+
+qint64
+DesktopFileCache::mtime( const QString & path )
+{
+    QFileInfo fileInfo( path );
+
+    return fileInfo.exists() ? fileInfo.lastModified().toMSecsSinceEpoch() : 0;
+}
+
+
+QString
+DesktopFileCache::cacheFileName()
+{
+    QString dir = QStandardPaths::writableLocation( QStandardPaths::CacheLocation );
+
+    return dir + "/" + CACHE_FILE_NAME;
+}
+
+
+void
+DesktopFileCache::load()
+{
+    QFile file( cacheFileName() );
+
+    if ( ! file.open( QIODevice::ReadOnly ) )
+        return;
+
+    QDataStream in( &file );
+    quint32 magic   = 0;
+    qint32  version = 0;
+    qint32  count   = 0;
+
+    in >> magic >> version >> count;
+
+    if ( magic != CACHE_FILE_MAGIC || version != CACHE_FILE_VERSION || count < 0 )
+    {
+        logWarning() << "Ignoring invalid cache file " << file.fileName() << endl;
+        return;
+    }
+
+    for ( int i = 0; i < count && in.status() == QDataStream::Ok; ++i )
+    {
+        QString          entryKey;
+        DesktopFileEntry entry;
+
+        in >> entryKey
+           >> entry.name
+           >> entry.exec
+           >> entry.icon
+           >> entry.iconPng
+           >> entry.mtime;
+
+        if ( in.status() == QDataStream::Ok )
+            _entries.insert( entryKey, entry );
+    }
+
+    logDebug() << "Loaded " << _entries.size() << " desktop file entries from "
+               << file.fileName() << endl;
+}
+
+
+void
+DesktopFileCache::save()
+{
+    if ( ! _dirty )
+        return;
+
+    QString fileName = cacheFileName();
+    QDir().mkpath( QFileInfo( fileName ).absolutePath() );
+
+    QFile file( fileName );
+
+    if ( ! file.open( QIODevice::WriteOnly | QIODevice::Truncate ) )
+    {
+        logWarning() << "Can't write " << fileName << endl;
+        return;
+    }
+
+    QDataStream out( &file );
+
+    out << (quint32) CACHE_FILE_MAGIC
+        << (qint32)  CACHE_FILE_VERSION
+        << (qint32)  _entries.size();
+
+    for ( auto it = _entries.constBegin(); it != _entries.constEnd(); ++it )
+    {
+        out << it.key()
+            << it->name
+            << it->exec
+            << it->icon
+            << it->iconPng
+            << it->mtime;
+    }
+
+    _dirty = false;
+
+    logDebug() << "Saved " << _entries.size() << " desktop file entries to "
+               << fileName << endl;
+}
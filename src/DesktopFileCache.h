@@ -0,0 +1,139 @@
+/*  ---------------------------------------------------------
+               __  __            _
+              |  \/  |_   _ _ __| |_   _ _ __
+              | |\/| | | | | '__| | | | | '_ \
+              | |  | | |_| | |  | | |_| | | | |
+              |_|  |_|\__, |_|  |_|\__, |_| |_|
+                      |___/        |___/
+    ---------------------------------------------------------
+
+    Project:  Myrlyn Package Manager GUI
+    Copyright (c) Stefan Hundhammer <Stefan.Hundhammer@gmx.de>
+    License:  GPL V2 - See file LICENSE for details.
+
+    Textdomain "qt-pkg"
+ */
+
+
+#ifndef DesktopFileCache_h
+#define DesktopFileCache_h
+
+#include <QByteArray>
+#include <QHash>
+#include <QObject>
+#include <QString>
+
+
+/**
+ * Parsed desktop file together with its application icon, ready to be
+ * embedded in HTML.
+ **/
+struct DesktopFileEntry
+{
+    DesktopFileEntry()
+        : mtime( 0 )
+        , checkedGeneration( -1 )
+        {}
+
+    QString    name;            // Translated application name
+    QString    exec;
+    QString    icon;            // Icon name from the desktop file
+    QByteArray iconPng;         // Base64-encoded 32x32 PNG; empty if no icon
+    qint64     mtime;           // Modification time of the desktop file
+    int        checkedGeneration;
+};
+
+
+/**
+ * Process-wide cache of parsed desktop files and their encoded application
+ * icons, keyed by the path of the desktop file and the language. An entry
+ * is only valid as long as the modification time of the desktop file is
+ * unchanged; that is checked at most once per pool content generation, so
+ * showing the same package again does not touch the disk.
+ *
+ * The cache is saved in the user's cache directory when the application
+ * quits and loaded again on the next start.
+ *
+ * This is a singleton; use instance().
+ **/
+class DesktopFileCache: public QObject
+{
+    Q_OBJECT
+
+public:
+
+    /**
+     * Return the singleton instance of this class. Create it and load the
+     * cache file if it doesn't exist yet.
+     **/
+    static DesktopFileCache * instance();
+
+    /**
+     * Return 'true' if 'path' is the path of a desktop file of an
+     * application.
+     **/
+    static bool isDesktopFile( const QString & path );
+
+    /**
+     * Look up the entry for the desktop file 'path' in language 'lang'.
+     * Return 'true' and set 'entry' if there is a valid one.
+     **/
+    bool lookup( const QString & path, const QString & lang, DesktopFileEntry & entry );
+
+    /**
+     * Store the entry for the desktop file 'path' in language 'lang'.
+     * This takes the modification time from the file.
+     **/
+    void insert( const QString & path, const QString & lang, const DesktopFileEntry & entry );
+
+
+public slots:
+
+    /**
+     * Save the cache to the cache file if anything changed.
+     **/
+    void save();
+
+
+protected:
+
+    /**
+     * Constructor. Use instance() instead.
+     **/
+    DesktopFileCache();
+
+    /**
+     * Destructor.
+     **/
+    virtual ~DesktopFileCache();
+
+    /**
+     * Load the cache from the cache file if there is one.
+     **/
+    void load();
+
+    /**
+     * Return the full path of the cache file.
+     **/
+    static QString cacheFileName();
+
+    /**
+     * Return the modification time of 'path' or 0 if it doesn't exist.
+     **/
+    static qint64 mtime( const QString & path );
+
+    /**
+     * Return the key for 'path' and 'lang'.
+     **/
+    static QString key( const QString & path, const QString & lang )
+        { return lang + '|' + path; }
+
+
+    // Data members
+
+    QHash<QString, DesktopFileEntry> _entries;
+    bool                             _dirty;
+};
+
+
+#endif // DesktopFileCache_h
@@ -0,0 +1,372 @@
+/*  ---------------------------------------------------------
+               __  __            _
+              |  \/  |_   _ _ __| |_   _ _ __
+              | |\/| | | | | '__| | | | | '_ \
+              | |  | | |_| | |  | | |_| | | | |
+              |_|  |_|\__, |_|  |_|\__, |_| |_|
+                      |___/        |___/
+    ---------------------------------------------------------
+
+    Project:  Myrlyn Package Manager GUI
+    Copyright (c) Stefan Hundhammer <Stefan.Hundhammer@gmx.de>
+    License:  GPL V2 - See file LICENSE for details.
+
+    Textdomain "qt-pkg"
+ */
+
+
+#include <algorithm>
+
+#include <QApplication>
+#include <QFont>
+#include <QHash>
+#include <QStyle>
+
+#include "Exception.h"
+#include "utf8.h"
+#include "FileListModel.h"
+
+
+// Number of children to add to the model at once
+#define FETCH_BATCH     500
+
+
+FileListModel::Node::Node( Node *          parent,
+                           const QString & name,
+                           int             first,
+                           int             last,
+                           bool            isDir )
+    : parent( parent )
+    , name( name )
+    , first( first )
+    , last( last )
+    , isDir( isDir )
+    , populated( false )
+    , fetched( 0 )
+    , row( 0 )
+{
+}
+
+
+FileListModel::Node::~Node()
+{
+    qDeleteAll( children );
+}
+
+
+FileListModel::FileListModel( QObject * parent )
+    : QAbstractItemModel( parent )
+    , _root( 0 )
+{
+    _root = new Node( 0, "", 0, 0, true );
+    CHECK_NEW( _root );
+}
+
+
+FileListModel::~FileListModel()
+{
+    delete _root;
+}
+
+
+void
+FileListModel::setFileList( const std::list<std::string> & fileList )
+{
+    beginResetModel();
+
+    delete _root;
+    _paths.clear();
+    _paths.reserve( fileList.size() );
+
+    for ( const std::string & path: fileList )
+        _paths.append( fromUTF8( path ) );
+
+    std::sort( _paths.begin(), _paths.end() );
+
+    _root = new Node( 0, "", 0, _paths.size(), true );
+    CHECK_NEW( _root );
+
+    endResetModel();
+}
+
+
+void
+FileListModel::clear()
+{
+    setFileList( std::list<std::string>() );
+}
+
+
+QStringList
+FileListModel::find( const QString & text ) const
+{
+    QStringList result;
+
+    for ( const QString & path: _paths )
+    {
+        if ( path.contains( text, Qt::CaseInsensitive ) )
+            result << path;
+    }
+
+    return result;
+}
+
+
+bool
+FileListModel::isBinary( const QString & path )
+{
+    return path.contains( "/bin/" ) || path.contains( "/sbin/" );
+}
+
+
+FileListModel::Node *
+FileListModel::node( const QModelIndex & index ) const
+{
+    return index.isValid() ? static_cast<Node *>( index.internalPointer() ) : _root;
+}
+
+
+QString
+FileListModel::path( const Node * node ) const
+{
+    if ( ! node->parent )
+        return "/";
+
+    QString result = path( node->parent ) + node->name;
+
+    if ( node->isDir )
+        result += '/';
+
+    return result;
+}
+
+
+int
+FileListModel::lowerBound( const QString & prefix, int first, int last ) const
+{
+    auto it = std::lower_bound( _paths.begin() + first,
+                                _paths.begin() + last,
+                                prefix );
+
+    return it - _paths.begin();
+}
+
+
+void
+FileListModel::populate( Node * node ) const
+{
+    if ( node->populated )
+        return;
+
+    node->populated = true;
+
+    QString prefix = path( node );
+    int     len    = prefix.size();
+
+    QHash<QString, Node *> dirs;
+    QVector<Node *>        dirNodes;
+    QVector<Node *>        fileNodes;
+
+    int i = node->first;
+
+    while ( i < node->last )
+    {
+        const QString & current = _paths[ i ];
+
+        if ( current.size() <= len || ! current.startsWith( prefix ) )
+        {
+            ++i;    // The directory entry of 'node' itself
+            continue;
+        }
+
+        int     slash = current.indexOf( '/', len );
+        QString name  = current.mid( len, slash < 0 ? -1 : slash - len );
+
+        if ( name.isEmpty() )
+        {
+            ++i;
+            continue;
+        }
+
+        // All paths below a directory are one contiguous range in _paths.
+        // Notice that a directory may also have an entry of its own
+        // ("/usr/lib" before "/usr/lib-foo" before "/usr/lib/bar").
+
+        QString dirPrefix = prefix + name + '/';
+        int     dirFirst  = lowerBound( dirPrefix, i, node->last );
+        bool    isDir     = dirFirst < node->last && _paths[ dirFirst ].startsWith( dirPrefix );
+
+        if ( isDir )
+        {
+            Node * dir = dirs.value( name );
+
+            if ( ! dir )
+            {
+                // '0' is the character after '/'
+                int dirLast = lowerBound( prefix + name + '0', dirFirst, node->last );
+
+                dir = new Node( node, name, dirFirst, dirLast, true );
+                CHECK_NEW( dir );
+
+                dirs.insert( name, dir );
+                dirNodes << dir;
+            }
+
+            i = slash >= 0 ? dir->last : i + 1;
+        }
+        else
+        {
+            Node * file = new Node( node, name, i, i + 1, false );
+            CHECK_NEW( file );
+
+            fileNodes << file;
+            ++i;
+        }
+    }
+
+    // Directories first, then files, each in path order
+
+    node->children = dirNodes + fileNodes;
+
+    for ( int row = 0; row < node->children.size(); ++row )
+        node->children[ row ]->row = row;
+}
+
+
+QModelIndex
+FileListModel::index( int row, int column, const QModelIndex & parent ) const
+{
+    Node * parentNode = node( parent );
+
+    if ( column != 0 || row < 0 || row >= parentNode->fetched )
+        return QModelIndex();
+
+    return createIndex( row, column, parentNode->children[ row ] );
+}
+
+
+QModelIndex
+FileListModel::parent( const QModelIndex & index ) const
+{
+    if ( ! index.isValid() )
+        return QModelIndex();
+
+    Node * parentNode = node( index )->parent;
+
+    if ( ! parentNode || parentNode == _root )
+        return QModelIndex();
+
+    return createIndex( parentNode->row, 0, parentNode );
+}
+
+
+int
+FileListModel::rowCount( const QModelIndex & parent ) const
+{
+    return node( parent )->fetched;
+}
+
+
+int
+FileListModel::columnCount( const QModelIndex & parent ) const
+{
+    Q_UNUSED( parent );
+
+    return 1;
+}
+
+
+bool
+FileListModel::hasChildren( const QModelIndex & parent ) const
+{
+    Node * parentNode = node( parent );
+
+    return parentNode->isDir && parentNode->last > parentNode->first;
+}
+
+
+QVariant
+FileListModel::data( const QModelIndex & index, int role ) const
+{
+    if ( ! index.isValid() )
+        return QVariant();
+
+    Node * itemNode = node( index );
+
+    switch ( role )
+    {
+        case Qt::DisplayRole:
+            return itemNode->name;
+
+        case Qt::ToolTipRole:
+            return path( itemNode );
+
+        case Qt::DecorationRole:
+            return QApplication::style()->standardIcon( itemNode->isDir ?
+                                                        QStyle::SP_DirIcon :
+                                                        QStyle::SP_FileIcon );
+
+        case Qt::FontRole:
+            if ( ! itemNode->isDir && isBinary( path( itemNode ) ) )
+            {
+                QFont font;
+                font.setBold( true );
+
+                return font;
+            }
+            break;
+
+        default:
+            break;
+    }
+
+    return QVariant();
+}
+
+
+QVariant
+FileSearchModel::data( const QModelIndex & index, int role ) const
+{
+    if ( role == Qt::FontRole && index.isValid() &&
+         FileListModel::isBinary( QStringListModel::data( index, Qt::DisplayRole ).toString() ) )
+    {
+        QFont font;
+        font.setBold( true );
+
+        return font;
+    }
+
+    return QStringListModel::data( index, role );
+}
+
+
+bool
+FileListModel::canFetchMore( const QModelIndex & parent ) const
+{
+    Node * parentNode = node( parent );
+
+    if ( ! parentNode->isDir )
+        return false;
+
+    if ( ! parentNode->populated )
+        return parentNode->last > parentNode->first;
+
+    return parentNode->fetched < parentNode->children.size();
+}
+
+
+void
+FileListModel::fetchMore( const QModelIndex & parent )
+{
+    Node * parentNode = node( parent );
+    populate( parentNode );
+
+    int count = std::min( FETCH_BATCH, parentNode->children.size() - parentNode->fetched );
+
+    if ( count <= 0 )
+        return;
+
+    beginInsertRows( parent, parentNode->fetched, parentNode->fetched + count - 1 );
+    parentNode->fetched += count;
+    endInsertRows();
+}
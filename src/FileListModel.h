@@ -0,0 +1,178 @@
+/*  ---------------------------------------------------------
+               __  __            _
+              |  \/  |_   _ _ __| |_   _ _ __
+              | |\/| | | | | '__| | | | | '_ \
+              | |  | | |_| | |  | | |_| | | | |
+              |_|  |_|\__, |_|  |_|\__, |_| |_|
+                      |___/        |___/
+    ---------------------------------------------------------
+
+    Project:  Myrlyn Package Manager GUI
+    Copyright (c) Stefan Hundhammer <Stefan.Hundhammer@gmx.de>
+    License:  GPL V2 - See file LICENSE for details.
+
+    Textdomain "qt-pkg"
+ */
+
+
+#ifndef FileListModel_h
+#define FileListModel_h
+
+#include <list>
+#include <string>
+#include <vector>
+
+#include <QAbstractItemModel>
+#include <QString>
+#include <QStringListModel>
+#include <QVector>
+
+
+/**
+ * Item model for a file list (e.g. of an installed package) as a
+ * collapsible directory tree.
+ *
+ * The model keeps one sorted copy of the paths. Tree nodes are only created
+ * for directories that are actually expanded, and their children are added
+ * in batches with fetchMore(), so even file lists with 100k entries show up
+ * instantly and use little memory beyond the paths themselves.
+ *
+ * Since all paths below a directory are a contiguous range of the sorted
+ * paths, each directory node only needs to know that range.
+ **/
+class FileListModel: public QAbstractItemModel
+{
+    Q_OBJECT
+
+public:
+
+    /**
+     * Constructor.
+     **/
+    FileListModel( QObject * parent = 0 );
+
+    /**
+     * Destructor.
+     **/
+    virtual ~FileListModel();
+
+    /**
+     * Set the file list to show. This resets the model.
+     **/
+    void setFileList( const std::list<std::string> & fileList );
+
+    /**
+     * Clear the file list. This resets the model.
+     **/
+    void clear();
+
+    /**
+     * Return the total number of paths.
+     **/
+    int pathCount() const { return _paths.size(); }
+
+    /**
+     * Return all paths that contain 'text', case-insensitive, in sort order.
+     **/
+    QStringList find( const QString & text ) const;
+
+    /**
+     * Return 'true' if 'path' should be highlighted, i.e. it is a binary.
+     **/
+    static bool isBinary( const QString & path );
+
+
+    //
+    // Implemented from QAbstractItemModel
+    //
+
+    virtual QModelIndex index( int row,
+                               int column,
+                               const QModelIndex & parent = QModelIndex() ) const override;
+
+    virtual QModelIndex parent( const QModelIndex & index ) const override;
+
+    virtual int rowCount   ( const QModelIndex & parent = QModelIndex() ) const override;
+    virtual int columnCount( const QModelIndex & parent = QModelIndex() ) const override;
+    virtual bool hasChildren( const QModelIndex & parent = QModelIndex() ) const override;
+
+    virtual QVariant data( const QModelIndex & index,
+                           int role = Qt::DisplayRole ) const override;
+
+    virtual bool canFetchMore( const QModelIndex & parent ) const override;
+    virtual void fetchMore   ( const QModelIndex & parent ) override;
+
+
+protected:
+
+    struct Node
+    {
+        Node( Node * parent, const QString & name, int first, int last, bool isDir );
+        ~Node();
+
+        Node *          parent;
+        QString         name;
+        int             first;          // Range of _paths below this node
+        int             last;           // (exclusive) or the path of a file
+        bool            isDir;
+        bool            populated;      // children calculated
+        int             fetched;        // children visible in the model
+        int             row;
+        QVector<Node *> children;
+    };
+
+    /**
+     * Return the node of 'index' or the root node for an invalid index.
+     **/
+    Node * node( const QModelIndex & index ) const;
+
+    /**
+     * Return the full path of 'node' with a trailing slash for
+     * directories.
+     **/
+    QString path( const Node * node ) const;
+
+    /**
+     * Calculate the children of 'node' from its range of paths.
+     **/
+    void populate( Node * node ) const;
+
+    /**
+     * Return the first index in _paths that is not less than 'prefix'.
+     **/
+    int lowerBound( const QString & prefix, int first, int last ) const;
+
+
+    // Data members
+
+    QVector<QString> _paths;    // Sorted
+    Node *           _root;
+};
+
+
+/**
+ * Flat list of full paths, e.g. the search results of a FileListModel,
+ * with binaries in bold like in the tree.
+ **/
+class FileSearchModel: public QStringListModel
+{
+    Q_OBJECT
+
+public:
+
+    /**
+     * Constructor.
+     **/
+    FileSearchModel( QObject * parent = 0 )
+        : QStringListModel( parent )
+        {}
+
+    /**
+     * Reimplemented from QStringListModel.
+     **/
+    virtual QVariant data( const QModelIndex & index,
+                           int role = Qt::DisplayRole ) const override;
+};
+
+
+#endif // FileListModel_h
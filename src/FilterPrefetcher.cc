@@ -0,0 +1,279 @@
+/*  ---------------------------------------------------------
+               __  __            _
+              |  \/  |_   _ _ __| |_   _ _ __
+              | |\/| | | | | '__| | | | | '_ \
+              | |  | | |_| | |  | | |_| | | | |
+              |_|  |_|\__, |_|  |_|\__, |_| |_|
+                      |___/        |___/
+    ---------------------------------------------------------
+
+    Project:  Myrlyn Package Manager GUI
+    Copyright (c) Stefan Hundhammer <Stefan.Hundhammer@gmx.de>
+    License:  GPL V2 - See file LICENSE for details.
+
+    Textdomain "qt-pkg"
+ */
+
+
+#include <algorithm>
+
+#include <QApplication>
+#include <QEvent>
+#include <QSettings>
+
+#include "Exception.h"
+#include "Logger.h"
+#include "PoolGeneration.h"
+#include "YQPkgFilterTab.h"
+#include "FilterPrefetcher.h"
+
+
+// Milliseconds without user input before prefetching starts
+#define IDLE_DELAY_MILLISEC     800
+
+// Number of items to process in one slice before returning to the event loop
+#define SLICE_SIZE              500
+
+// Prefetch only for this many of the most-used inactive tabs
+#define MAX_PREFETCH_TABS       3
+
+#define VERBOSE_PREFETCH        0
+
+
+void
+PkgMatchList::clear()
+{
+    _matches.clear();
+    _generation = -1;
+}
+
+
+bool
+PkgMatchList::isValid() const
+{
+    return _generation >= 0 && _generation == PoolGeneration::current();
+}
+
+
+
+
+FilterPrefetcher::FilterPrefetcher( YQPkgFilterTab * filters )
+    : QObject( filters )
+    , _filters( filters )
+{
+    CHECK_PTR( _filters );
+
+    _idleTimer.setSingleShot( true );
+    _idleTimer.setInterval( IDLE_DELAY_MILLISEC );
+
+    // A zero timer fires whenever the event loop has processed all pending
+    // events, so each slice is done only when the GUI has nothing else to do.
+    _sliceTimer.setInterval( 0 );
+
+    connect( &_idleTimer,  SIGNAL( timeout()  ),
+             &_sliceTimer, SLOT  ( start()    ) );
+
+    connect( &_sliceTimer, SIGNAL( timeout()       ),
+             this,         SLOT  ( prefetchSlice() ) );
+
+    connect( _filters,     SIGNAL( currentChanged( QWidget * ) ),
+             this,         SLOT  ( pageActivated ( QWidget * ) ) );
+
+    readSettings();
+    qApp->installEventFilter( this );
+}
+
+
+FilterPrefetcher::~FilterPrefetcher()
+{
+    qApp->removeEventFilter( this );
+    writeSettings();
+}
+
+
+void
+FilterPrefetcher::addFilter( QWidget * page, PrefetchableFilter * filter )
+{
+    if ( page && filter )
+        _prefetchFilters[ page ] = filter;
+}
+
+
+bool
+FilterPrefetcher::eventFilter( QObject * watchedObj, QEvent * event )
+{
+    if ( event )
+    {
+        switch ( event->type() )
+        {
+            case QEvent::KeyPress:
+            case QEvent::MouseButtonPress:
+            case QEvent::MouseButtonDblClick:
+            case QEvent::Wheel:
+
+                // Yield to the user right away and wait until the user is
+                // idle again. This input might also change package states, so
+                // check again afterwards even if all results were complete.
+
+                restartIdleTimer();
+                break;
+
+            default:
+                break;
+        }
+    }
+
+    return QObject::eventFilter( watchedObj, event ); // Never consume the event
+}
+
+
+void
+FilterPrefetcher::restartIdleTimer()
+{
+    _sliceTimer.stop();
+    _idleTimer.start();
+}
+
+
+void
+FilterPrefetcher::pageActivated( QWidget * page )
+{
+    YQPkgFilterPage * filterPage = _filters->findPage( page );
+
+    if ( filterPage && ! filterPage->id.isEmpty() )
+        _usageCount[ filterPage->id ]++;
+
+    // Package states might have changed in the previous page,
+    // so check again when the user is idle.
+
+    restartIdleTimer();
+}
+
+
+void
+FilterPrefetcher::prefetchSlice()
+{
+    YQPkgFilterPage * lazyPage = nextLazyPage();
+
+    if ( lazyPage )
+    {
+#if VERBOSE_PREFETCH
+        logVerbose() << "Creating lazy page " << lazyPage->id << endl;
+#endif
+        // This might register a new filter with addFilter()
+
+        _filters->createPageContent( lazyPage );
+
+        if ( lazyPage->lazy ) // Content not created: Don't try again and again
+            _sliceTimer.stop();
+
+        return;
+    }
+
+    PrefetchableFilter * filter = nextFilter();
+
+    if ( ! filter )
+    {
+#if VERBOSE_PREFETCH
+        logVerbose() << "Nothing (more) to prefetch" << endl;
+#endif
+        _sliceTimer.stop();
+
+        return;
+    }
+
+    filter->prefetchSlice( SLICE_SIZE );
+}
+
+
+PrefetchableFilter *
+FilterPrefetcher::nextFilter() const
+{
+    YQPkgFilterPage * currentPage = _filters->currentPage();
+    std::vector<YQPkgFilterPage *> candidates;
+
+    for ( QWidget * content: _prefetchFilters.keys() )
+    {
+        YQPkgFilterPage * page = _filters->findPage( content );
+
+        // Only pages with an open tab, but not the page that is currently
+        // shown: That one is up to date anyway.
+
+        if ( page && page->tabIndex >= 0 && page != currentPage )
+            candidates.push_back( page );
+    }
+
+    std::stable_sort( candidates.begin(), candidates.end(),
+                      [this]( YQPkgFilterPage * a, YQPkgFilterPage * b )
+                      {
+                          return _usageCount.value( a->id ) > _usageCount.value( b->id );
+                      } );
+
+    if ( candidates.size() > MAX_PREFETCH_TABS )
+        candidates.resize( MAX_PREFETCH_TABS );
+
+    for ( YQPkgFilterPage * page: candidates )
+    {
+        PrefetchableFilter * filter = _prefetchFilters.value( page->content );
+
+        if ( filter && ! filter->prefetchValid() )
+        {
+#if VERBOSE_PREFETCH
+            logVerbose() << "Prefetching for page " << page->id << endl;
+#endif
+            return filter;
+        }
+    }
+
+    return 0;
+}
+
+
+YQPkgFilterPage *
+FilterPrefetcher::nextLazyPage() const
+{
+    YQPkgFilterPageVector candidates = _filters->lazyPages();
+
+    if ( candidates.empty() )
+        return 0;
+
+    std::stable_sort( candidates.begin(), candidates.end(),
+                      [this]( YQPkgFilterPage * a, YQPkgFilterPage * b )
+                      {
+                          bool aOpen = a->tabIndex >= 0;
+                          bool bOpen = b->tabIndex >= 0;
+
+                          if ( aOpen != bOpen )
+                              return aOpen;
+
+                          return _usageCount.value( a->id ) > _usageCount.value( b->id );
+                      } );
+
+    return candidates.front();
+}
+
+
+void
+FilterPrefetcher::readSettings()
+{
+    QSettings settings;
+    settings.beginGroup( "PageUsage" );
+
+    for ( const QString & id: settings.childKeys() )
+        _usageCount[ id ] = settings.value( id, 0 ).toInt();
+
+    settings.endGroup();
+}
+
+
+void
+FilterPrefetcher::writeSettings()
+{
+    QSettings settings;
+    settings.beginGroup( "PageUsage" );
+
+    for ( const QString & id: _usageCount.keys() )
+        settings.setValue( id, _usageCount.value( id ) );
+
+    settings.endGroup();
+}
@@ -0,0 +1,225 @@
+/*  ---------------------------------------------------------
+               __  __            _
+              |  \/  |_   _ _ __| |_   _ _ __
+              | |\/| | | | | '__| | | | | '_ \
+              | |  | | |_| | |  | | |_| | | | |
+              |_|  |_|\__, |_|  |_|\__, |_| |_|
+                      |___/        |___/
+    ---------------------------------------------------------
+
+    Project:  Myrlyn Package Manager GUI
+    Copyright (c) Stefan Hundhammer <Stefan.Hundhammer@gmx.de>
+    License:  GPL V2 - See file LICENSE for details.
+
+    Textdomain "qt-pkg"
+ */
+
+
+#ifndef FilterPrefetcher_h
+#define FilterPrefetcher_h
+
+#include <utility>
+#include <vector>
+
+#include <QObject>
+#include <QMap>
+#include <QString>
+#include <QTimer>
+
+#include "YQZypp.h"
+
+
+class QEvent;
+class YQPkgFilterTab;
+class YQPkgFilterPage;
+
+
+/**
+ * Precomputed result of a filter view: The (selectable, package) pairs that
+ * its filter() method would report with filterMatch(), in the same order.
+ *
+ * Such a result is only valid for the pool generation that it was computed
+ * for; see PoolGeneration.
+ **/
+class PkgMatchList
+{
+public:
+
+    typedef std::pair<ZyppSel, ZyppPkg> PkgMatch;
+
+    PkgMatchList(): _generation( -1 ) {}
+
+    /**
+     * Add a match.
+     **/
+    void add( ZyppSel selectable, ZyppPkg pkg )
+        { _matches.push_back( PkgMatch( selectable, pkg ) ); }
+
+    /**
+     * Clear all matches and mark this result as invalid.
+     **/
+    void clear();
+
+    /**
+     * Mark this result as complete and valid for the pool generation
+     * 'generation'.
+     **/
+    void setGeneration( int generation ) { _generation = generation; }
+
+    /**
+     * Return 'true' if this result is complete and valid for the current pool
+     * generation.
+     **/
+    bool isValid() const;
+
+    /**
+     * Return the matches.
+     **/
+    const std::vector<PkgMatch> & matches() const { return _matches; }
+
+    /**
+     * Return the number of matches.
+     **/
+    int size() const { return (int) _matches.size(); }
+
+private:
+
+    std::vector<PkgMatch> _matches;
+    int                   _generation;
+};
+
+
+/**
+ * Interface for filter views that can compute (part of) their result in
+ * advance while the GUI is idle.
+ **/
+class PrefetchableFilter
+{
+public:
+
+    virtual ~PrefetchableFilter() {}
+
+    /**
+     * Return 'true' if the prefetched result is valid for the current pool
+     * generation, i.e. if there is nothing to do.
+     **/
+    virtual bool prefetchValid() const = 0;
+
+    /**
+     * Do one slice of prefetching: Process at most 'maxItems' items, then
+     * return to the event loop. Return 'true' if the result is complete,
+     * 'false' if more slices are needed.
+     *
+     * Implementations need to start over if the pool generation changed
+     * since the previous slice.
+     **/
+    virtual bool prefetchSlice( int maxItems ) = 0;
+};
+
+
+/**
+ * Idle-time scheduler that precomputes the results of the filter views of
+ * the most-used inactive tabs of a YQPkgFilterTab.
+ *
+ * What that covers depends on the filter view: For the updates view, it is
+ * the complete list of matching packages. For the patches and patterns
+ * views, it is only the packages of the item that will be shown next; the
+ * list of patches or patterns itself is not prefilled. In all cases,
+ * switching to the tab still needs to fill the package list widget.
+ *
+ * Before that, it creates the content of the lazy pages of the filter tab
+ * (see YQPkgFilterTab::addLazyPage()), one page per slice, starting with the
+ * pages that the user is most likely to open.
+ *
+ * Work starts only when there was no user input for some time, and it is
+ * done in small slices so control returns to the event loop quickly. Any
+ * keyboard or mouse input stops it immediately until the user is idle again.
+ **/
+class FilterPrefetcher: public QObject
+{
+    Q_OBJECT
+
+public:
+
+    /**
+     * Constructor.
+     **/
+    FilterPrefetcher( YQPkgFilterTab * filters );
+
+    /**
+     * Destructor. This saves the tab usage statistics.
+     **/
+    virtual ~FilterPrefetcher();
+
+    /**
+     * Register 'filter' as the prefetchable filter for the filter tab page
+     * with the content widget 'page'.
+     **/
+    void addFilter( QWidget * page, PrefetchableFilter * filter );
+
+    /**
+     * Event filter for the application object to notice user input.
+     *
+     * Reimplemented from QObject.
+     **/
+    virtual bool eventFilter( QObject * watchedObj, QEvent * event ) override;
+
+
+public slots:
+
+    /**
+     * (Re-)start waiting for the user to become idle.
+     **/
+    void restartIdleTimer();
+
+
+protected slots:
+
+    /**
+     * Notification that a filter page was activated: Count that for the tab
+     * usage statistics.
+     **/
+    void pageActivated( QWidget * page );
+
+    /**
+     * Do one slice of prefetching work.
+     **/
+    void prefetchSlice();
+
+
+protected:
+
+    /**
+     * Return the filter that should be prefetched next or 0 if there is
+     * nothing to do.
+     **/
+    PrefetchableFilter * nextFilter() const;
+
+    /**
+     * Return the lazy page whose content should be created next or 0 if
+     * there is none: Pages with an open tab first, then the most-used ones.
+     **/
+    YQPkgFilterPage * nextLazyPage() const;
+
+    /**
+     * Read the tab usage statistics from the settings.
+     **/
+    void readSettings();
+
+    /**
+     * Write the tab usage statistics to the settings.
+     **/
+    void writeSettings();
+
+
+    // Data members
+
+    YQPkgFilterTab *                        _filters;
+    QMap<QWidget *, PrefetchableFilter *>   _prefetchFilters;
+    QMap<QString, int>                      _usageCount;
+    QTimer                                  _idleTimer;
+    QTimer                                  _sliceTimer;
+};
+
+
+#endif // FilterPrefetcher_h
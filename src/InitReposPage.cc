@@ -23,6 +23,7 @@
 #include "MyrlynRepoManager.h"
 #include "utf8.h"
 #include "YQZypp.h"
+#include "YQi18n.h"
 #include "InitReposPage.h"
 
 
@@ -37,6 +38,7 @@ InitReposPage::InitReposPage( MyrlynRepoManager * repoManager,
     CHECK_NEW( _ui );
     _ui->setupUi( this ); // Actually create the widgets from the .ui form
     _ui->reposList->setSortingEnabled( false );
+    _headingText = _ui->headingLabel->text();
 
     reset();
     connectSignals();
@@ -66,6 +68,12 @@ void InitReposPage::connectSignals()
 
     connect( _repoManager, SIGNAL( refreshRepoDone ( ZyppRepoInfo ) ),
              this,         SLOT  ( refreshRepoDone ( ZyppRepoInfo ) ) );
+
+    connect( _repoManager, SIGNAL( repoClassified ( ZyppRepoInfo, int ) ),
+             this,         SLOT  ( repoClassified ( ZyppRepoInfo, int ) ) );
+
+    connect( _repoManager, SIGNAL( reposClassified( int, int ) ),
+             this,         SLOT  ( reposClassified( int, int ) ) );
 }
 
 
@@ -90,10 +98,13 @@ void InitReposPage::reset()
 {
     _reposCount       = 0;
     _refreshDoneCount = 0;
+    _refreshOngoing.clear();
 
     _ui->reposList->clear();
+    _ui->headingLabel->setText( _headingText );
     _ui->progressBar->setValue( 0 );
     _ui->progressBar->setMaximum( 100 );
+    updateProgressText();
 
     MainWindow::processEvents();
 }
@@ -115,14 +126,19 @@ void InitReposPage::refreshRepoStart( const ZyppRepoInfo & repo )
 {
     // logDebug() << "Repo refresh start for " << repo.name() << endl;
 
+    _refreshOngoing.insert( fromUTF8( repo.alias() ) );
     QListWidgetItem * item = setItemIcon( repo, _downloadOngoingIcon );
 
-    if ( item )
+    // With several repos being refreshed at the same time, the download icons
+    // show which ones; moving the current item around would only be confusing.
+
+    if ( item && _refreshOngoing.size() == 1 )
     {
         _ui->reposList->setFocus();
         _ui->reposList->setCurrentItem( item );
     }
 
+    updateProgressText();
     MainWindow::processEvents();
 }
 
@@ -131,8 +147,48 @@ void InitReposPage::refreshRepoDone ( const ZyppRepoInfo & repo )
 {
     // logDebug() << "Repo refresh done for " << repo.name() << endl;
 
+    _refreshOngoing.remove( fromUTF8( repo.alias() ) );
     _ui->progressBar->setValue( ++_refreshDoneCount );
     setItemIcon( repo, _downloadDoneIcon );
+    updateProgressText();
+
+    MainWindow::processEvents();
+}
+
+
+void InitReposPage::repoClassified( const ZyppRepoInfo & repo, int state )
+{
+    QListWidgetItem * item = findRepoItem( repo );
+
+    if ( ! item )
+        return;
+
+    QString toolTip;
+
+    switch ( (MyrlynRepoManager::RepoRefreshState) state )
+    {
+        case MyrlynRepoManager::RepoFresh:           toolTip = _( "Up to date" );                break;
+        case MyrlynRepoManager::RepoNeedsRefresh:    toolTip = _( "Needs a refresh" );           break;
+        case MyrlynRepoManager::RepoNeedsCacheBuild: toolTip = _( "Needs a cache rebuild" );     break;
+        case MyrlynRepoManager::RepoBroken:          toolTip = _( "Broken repository" );         break;
+    }
+
+    item->setToolTip( toolTip );
+}
+
+
+void InitReposPage::reposClassified( int total, int needWork )
+{
+    QString summary;
+
+    if ( needWork == 0 )
+        summary = _( "All %1 repositories are up to date." ).arg( total );
+    else
+        summary = _( "%1 of %2 repositories need to be refreshed." ).arg( needWork ).arg( total );
+
+    _ui->headingLabel->setText( QString( "<p><b>%1</b></p><p>%2</p>" )
+                                .arg( _( "Initializing Repositories" ) )
+                                .arg( summary ) );
 
     MainWindow::processEvents();
 }
@@ -172,3 +228,19 @@ InitReposPage::findRepoItem( const ZyppRepoInfo & repo )
     return 0;
 }
 
+
+void InitReposPage::updateProgressText()
+{
+    if ( _refreshOngoing.size() > 1 )
+    {
+        // Translators: %v and %m are replaced by Qt with the number of repos
+        // already refreshed and the total number of repos; %1 is the number
+        // of repos that are currently being refreshed.
+        _ui->progressBar->setFormat( _( "%v of %m  (%1 in progress)" )
+                                     .arg( _refreshOngoing.size() ) );
+    }
+    else
+    {
+        _ui->progressBar->setFormat( "%p%" );
+    }
+}
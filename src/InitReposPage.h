@@ -20,6 +20,7 @@
 
 
 #include <QPixmap>
+#include <QSet>
 #include <QWidget>
 
 #include "YQZypp.h"
@@ -71,6 +72,7 @@ public slots:
 
     /**
      * Notification that refreshing a repo starts.
+     * Several repos may be refreshed at the same time.
      **/
     void refreshRepoStart( const ZyppRepoInfo & repo );
 
@@ -79,6 +81,18 @@ public slots:
      **/
     void refreshRepoDone ( const ZyppRepoInfo & repo );
 
+    /**
+     * Notification that it is known whether a repo needs to be refreshed.
+     * 'state' is a MyrlynRepoManager::RepoRefreshState.
+     **/
+    void repoClassified( const ZyppRepoInfo & repo, int state );
+
+    /**
+     * Notification that all repos are classified: Show how many of them
+     * actually need to be refreshed.
+     **/
+    void reposClassified( int total, int needWork );
+
 
 protected:
 
@@ -105,6 +119,12 @@ protected:
      **/
     QListWidgetItem * findRepoItem( const ZyppRepoInfo & repo );
 
+    /**
+     * Update the progress bar text with the number of repos that are
+     * currently being refreshed.
+     **/
+    void updateProgressText();
+
 
     //
     // Data members
@@ -112,9 +132,11 @@ protected:
 
     MyrlynRepoManager * _repoManager;
     Ui::InitReposPage * _ui;       // See ui_init-repos-page.h
+    QString             _headingText;
 
     int                 _reposCount;
     int                 _refreshDoneCount;
+    QSet<QString>       _refreshOngoing;   // repo aliases
 
     QPixmap             _emptyIcon;
     QPixmap             _downloadOngoingIcon;
@@ -16,23 +16,79 @@
 
 
 #include <unistd.h>             // geteuid(), sleep()
-#include <iostream>             // cerr
+#include <iostream>             // cerr, cout
+#include <algorithm>            // std::stable_sort()
+#include <climits>              // INT_MAX
+
+#include <QCoreApplication>
 #include <QElapsedTimer>
+#include <QEventLoop>
 #include <QMessageBox>
+#include <QSettings>
 
+#include <zypp/ZConfig.h>
 #include <zypp/ZYppFactory.h>
+#include <zypp/Repository.h>
+#include <zypp/ResPool.h>
+#include <zypp/Target.h>
+#include <zypp/sat/Pool.h>
 
 #include "Exception.h"
 #include "KeyRingCallbacks.h"
 #include "Logger.h"
 #include "MainWindow.h"
 #include "MyrlynApp.h"
+#include "PoolGeneration.h"
+#include "StartupTimer.h"
 #include "YQi18n.h"
 #include "utf8.h"
 #include "MyrlynRepoManager.h"
 
 
+// Maximum number of repos to refresh at the same time
+
+#define MAX_PARALLEL_REFRESH    4
+
+// Exit codes of refresh worker processes
+
+#define REFRESH_WORKER_OK       0
+#define REFRESH_WORKER_FAILED   1
+#define REFRESH_WORKER_ERROR    2
+#define REFRESH_WORKER_KEY      3       // Failed because of an untrusted GPG key
+
+
+/**
+ * Key ring callback for refresh worker processes: They can't ask the user
+ * to trust a new GPG key, so just remember that this was needed.
+ **/
+struct RefreshWorkerKeyRingCallback:
+    public zypp::callback::ReceiveReport<zypp::KeyRingReport>
+{
+    RefreshWorkerKeyRingCallback()
+        : askedForKey( false )
+        {}
+
+    virtual zypp::KeyRingReport::KeyTrust
+    askUserToAcceptKey( const zypp::PublicKey  & key,
+                        const zypp::KeyContext & context ) override
+        {
+            Q_UNUSED( key );
+            Q_UNUSED( context );
+
+            askedForKey = true;
+
+            return zypp::KeyRingReport::KEY_DONT_TRUST;
+        }
+
+    bool askedForKey;
+};
+
+
 MyrlynRepoManager::MyrlynRepoManager()
+    : _maxRefreshWorkers( MAX_PARALLEL_REFRESH )
+    , _refreshLoop( 0 )
+    , _backgroundRefreshPending( false )
+    , _targetChanged( false )
 {
     logDebug() << "Creating MyrlynRepoManager" << endl;
 }
@@ -54,6 +110,7 @@ void MyrlynRepoManager::initTarget()
     MyrlynApp::instance()->createZyppLogger();
 
     logDebug() << "Initializing zypp..." << endl;
+    StartupPhase phase( "initTarget" );
 
     zyppPtr()->initializeTarget( "/", false );  // don't rebuild rpmdb
     zyppPtr()->target()->load(); // Load pkgs from the target (rpmdb)
@@ -62,6 +119,38 @@ void MyrlynRepoManager::initTarget()
 }
 
 
+bool MyrlynRepoManager::reloadTargetIfChanged()
+{
+    if ( ! _targetChanged )
+        return false;
+
+    _targetChanged = false;
+
+    QElapsedTimer timer;
+    timer.start();
+    logInfo() << "Reloading the target..." << endl;
+
+    // This rebuilds the solv cache of the target only if the RPMDB changed
+    // since zypp last synced the pool with it after the commit. Otherwise
+    // it does nothing.
+
+    zyppPtr()->target()->load();
+
+    // Start over with no pending transactions. Don't touch locks: They are
+    // the user's permanent decisions, not part of the last transaction.
+
+    for ( const zypp::PoolItem & item: zypp::ResPool::instance() )
+        item.status().resetTransact( zypp::ResStatus::USER );
+
+    PoolGeneration::invalidate();
+
+    logInfo() << "Reloading the target done after "
+              << timer.elapsed() / 1000.0 << " sec" << endl;
+
+    return true;
+}
+
+
 void MyrlynRepoManager::shutdownZypp()
 {
     logDebug() << "Shutting down zypp..." << endl;
@@ -109,6 +198,8 @@ void MyrlynRepoManager::zyppConnect( int attempts, int waitSeconds )
 zypp::ZYpp::Ptr
 MyrlynRepoManager::zyppConnectInternal( int attempts, int waitSeconds )
 {
+    StartupPhase phase( "zyppConnect" );
+
     while ( _zypp_ptr == NULL && attempts > 0 )
     {
 	try
@@ -150,7 +241,20 @@ void MyrlynRepoManager::attachRepos()
     try
     {
         findEnabledRepos();
-        refreshRepos();
+
+        if ( useFastStart() )
+        {
+            // Load what is in the caches right now and refresh the repos
+            // in the background once the package selector is shown
+
+            refreshUncachedRepos();
+            _backgroundRefreshPending = true;
+        }
+        else
+        {
+            refreshRepos();
+        }
+
         loadRepos();
     }
     catch ( const zypp::Exception & ex )
@@ -209,37 +313,493 @@ void MyrlynRepoManager::refreshRepos()
         return;
 
     KeyRingCallbacks keyRingCallbacks;
-    QElapsedTimer    timer;
+    readRefreshTimes();
+
+    // Classify all repos first: Only the ones that are not fresh need any
+    // of the (much more expensive) checks of libzypp. Broken ones are tried
+    // anyway; refreshRepo() disables them if that fails.
+
+    QList<ZyppRepoInfo *> needWork;
+    QList<ZyppRepoInfo *> fresh;
 
     for ( ZyppRepoInfo & repo: _repos )
     {
-        try
+        RepoRefreshState state = refreshState( repo );
+        emit repoClassified( repo, (int) state );
+
+        if ( state == RepoFresh )
+            fresh << &repo;
+        else
+            needWork << &repo;
+    }
+
+    logInfo() << needWork.size() << " of " << _repos.size()
+              << " repos need to be refreshed" << endl;
+
+    emit reposClassified( (int) _repos.size(), needWork.size() );
+
+    for ( ZyppRepoInfo * repo: fresh )
+        emit refreshRepoDone( *repo );
+
+    if ( needWork.size() > 1 && ! MyrlynApp::isOptionSet( OptSerialRepoRefresh ) )
+    {
+        QList<ZyppRepoInfo *> failedRepos = refreshReposParallel( needWork, MAX_PARALLEL_REFRESH );
+
+        // Try again in this process the repos that need the user to accept
+        // a new GPG key (which is not possible in a worker process) or whose
+        // worker could not run at all. If it still fails, this disables the
+        // repo.
+
+        for ( ZyppRepoInfo * repo: failedRepos )
         {
-            timer.start();
-            logInfo() << "Refreshing repo " << repo.name() << "..." << endl;
-            emit refreshRepoStart( repo );
+            logInfo() << "Refreshing repo " << repo->name()
+                      << " failed in a worker process; trying again" << endl;
+            refreshRepo( *repo );
+        }
+    }
+    else
+    {
+        for ( ZyppRepoInfo * repo: needWork )
+            refreshRepo( *repo );
+    }
 
-            repoManager()->refreshMetadata( repo, zypp::RepoManager::RefreshIfNeeded );
-            repoManager()->buildCache     ( repo, zypp::RepoManager::BuildIfNeeded   );
+    writeRefreshTimes();
+}
 
-            if ( MyrlynApp::isOptionSet( OptSlowRepoRefresh ) )
-                sleep( 2 );
 
-            logInfo() << "Refreshing repo " << repo.name()
-                      << " done after " << timer.elapsed() / 1000.0 << " sec"
-                      << endl;
+MyrlynRepoManager::RepoRefreshState
+MyrlynRepoManager::refreshState( const ZyppRepoInfo & repo )
+{
+    if ( repo.baseUrlsEmpty() && repo.mirrorListUrl().asString().empty() )
+    {
+        logWarning() << "No URL for repo " << repo.name() << endl;
+        return RepoBroken;
+    }
+
+    try
+    {
+        zypp::RepoStatus metadataStatus = repoManager()->metadataStatus( repo );
+
+        if ( metadataStatus.empty() )
+            return RepoNeedsRefresh;
+
+        // Like RefreshIfNeeded: Don't even check the server if that was
+        // done less than repo.refresh.delay minutes ago.
+
+        time_t delay   = zypp::ZConfig::instance().repo_refresh_delay() * 60;
+        time_t checked = metadataStatus.timestamp();
+
+        if ( delay == 0 || checked + delay <= (time_t) zypp::Date::now() )
+            return RepoNeedsRefresh;
 
+        // Like BuildIfNeeded: The solv cache cookie is the metadata status
+        // that the cache was built from.
+
+        if ( ! repoManager()->isCached( repo ) ||
+             repoManager()->cacheStatus( repo ) != metadataStatus )
+        {
+            return RepoNeedsCacheBuild;
+        }
+
+        return RepoFresh;
+    }
+    catch ( const zypp::Exception & exception )
+    {
+        logWarning() << "Can't check the local status of repo " << repo.name()
+                     << ": " << exception.asString() << endl;
+
+        return RepoBroken;
+    }
+}
+
+
+bool MyrlynRepoManager::useFastStart() const
+{
+    return MyrlynApp::isOptionSet( OptFastStart )       &&
+           ! MyrlynApp::isOptionSet( OptNoRepoRefresh ) &&
+           geteuid() == 0;
+}
+
+
+void MyrlynRepoManager::refreshUncachedRepos()
+{
+    KeyRingCallbacks keyRingCallbacks;
+    readRefreshTimes();
+
+    for ( ZyppRepoInfo & repo: _repos )
+    {
+        if ( ! repoManager()->isCached( repo ) )
+        {
+            logInfo() << "No cache for repo " << repo.name() << endl;
+            refreshRepo( repo );
+        }
+        else
+        {
+            // Still show it as done on the InitReposPage
             emit refreshRepoDone( repo );
         }
-        catch ( const zypp::repo::RepoException & exception )
+    }
+}
+
+
+void MyrlynRepoManager::refreshRepo( ZyppRepoInfo & repo )
+{
+    QElapsedTimer timer;
+    StartupPhase  phase( "refresh:" + fromUTF8( repo.alias() ) );
+
+    try
+    {
+        timer.start();
+        logInfo() << "Refreshing repo " << repo.name() << "..." << endl;
+        emit refreshRepoStart( repo );
+
         {
-            Q_UNUSED( exception );
-            logWarning() << "CAUGHT zypp exception for repo " << repo.name() << endl;
+            StartupPhase phase( "refreshMetadata:" + fromUTF8( repo.alias() ) );
+            repoManager()->refreshMetadata( repo, zypp::RepoManager::RefreshIfNeeded );
+        }
 
-            logInfo() << "Disabling repo " << repo.name() << endl;
-            repo.setEnabled( false );
+        {
+            StartupPhase phase( "buildCache:" + fromUTF8( repo.alias() ) );
+            repoManager()->buildCache( repo, zypp::RepoManager::BuildIfNeeded );
         }
+
+        if ( MyrlynApp::isOptionSet( OptSlowRepoRefresh ) )
+            sleep( 2 );
+
+        logInfo() << "Refreshing repo " << repo.name()
+                  << " done after " << timer.elapsed() / 1000.0 << " sec"
+                  << endl;
+
+        _refreshTimes[ fromUTF8( repo.alias() ) ] = timer.elapsed();
+        emit refreshRepoDone( repo );
     }
+    catch ( const zypp::repo::RepoException & exception )
+    {
+        Q_UNUSED( exception );
+        logWarning() << "CAUGHT zypp exception for repo " << repo.name() << endl;
+
+        logInfo() << "Disabling repo " << repo.name() << endl;
+        repo.setEnabled( false );
+    }
+}
+
+
+QList<ZyppRepoInfo *>
+MyrlynRepoManager::refreshReposParallel( const QList<ZyppRepoInfo *> & repos,
+                                         int maxWorkers )
+{
+    _maxRefreshWorkers = maxWorkers;
+    _pendingRefresh    = repos;
+    _failedRefresh.clear();
+
+    sortPendingRefresh();
+
+    logInfo() << "Refreshing " << _pendingRefresh.size() << " repos"
+              << " with up to " << maxWorkers << " worker processes" << endl;
+
+    QEventLoop eventLoop;
+    _refreshLoop = &eventLoop;
+
+    startRefreshWorkers();
+
+    if ( ! _refreshWorkers.isEmpty() )
+        eventLoop.exec(); // until the last worker is finished
+
+    _refreshLoop = 0;
+
+    return _failedRefresh;
+}
+
+
+void MyrlynRepoManager::startBackgroundRefresh()
+{
+    _backgroundRefreshPending = false;
+    _maxRefreshWorkers        = MAX_PARALLEL_REFRESH;
+    _pendingRefresh.clear();
+    _failedRefresh.clear();
+    _cacheChecksums.clear();
+
+    for ( ZyppRepoInfo & repo: _repos )
+    {
+        if ( repo.enabled() )
+        {
+            _cacheChecksums[ fromUTF8( repo.alias() ) ] =
+                fromUTF8( repoManager()->cacheStatus( repo ).checksum() );
+
+            _pendingRefresh << &repo;
+        }
+    }
+
+    sortPendingRefresh();
+
+    logInfo() << "Refreshing " << _pendingRefresh.size() << " repos in the background" << endl;
+    startRefreshWorkers();
+
+    if ( _refreshWorkers.isEmpty() )
+        finishBackgroundRefresh();
+}
+
+
+bool MyrlynRepoManager::backgroundRefreshRunning() const
+{
+    if ( _refreshLoop ) // Foreground refresh in refreshReposParallel()
+        return false;
+
+    return ! _refreshWorkers.isEmpty() || ! _pendingRefresh.isEmpty();
+}
+
+
+void MyrlynRepoManager::finishBackgroundRefresh()
+{
+    writeRefreshTimes();
+
+    for ( ZyppRepoInfo * repo: _failedRefresh )
+    {
+        // Don't retry in this process: That would block the user interface,
+        // and it might need to ask the user about GPG keys right in the
+        // middle of the package selection.
+
+        logWarning() << "Background refresh failed for repo " << repo->name()
+                     << "; using the old cache" << endl;
+    }
+
+    _failedRefresh.clear();
+    QStringList changedAliases;
+
+    for ( ZyppRepoInfo & repo: _repos )
+    {
+        QString alias = fromUTF8( repo.alias() );
+
+        if ( _cacheChecksums.contains( alias ) &&
+             _cacheChecksums.value( alias ) != fromUTF8( repoManager()->cacheStatus( repo ).checksum() ) )
+        {
+            logInfo() << "Cache changed for repo " << repo.name() << endl;
+            changedAliases << alias;
+        }
+    }
+
+    _cacheChecksums.clear();
+    emit backgroundRefreshFinished( changedAliases );
+}
+
+
+void MyrlynRepoManager::sortPendingRefresh()
+{
+    // Start the slowest repos first so they don't hold up the end of the
+    // refresh. Repos without a recorded refresh time might be new, so they
+    // might need a full download: Start them first, too.
+
+    std::stable_sort( _pendingRefresh.begin(), _pendingRefresh.end(),
+                      [this]( ZyppRepoInfo * a, ZyppRepoInfo * b )
+                      {
+                          int timeA = _refreshTimes.value( fromUTF8( a->alias() ), INT_MAX );
+                          int timeB = _refreshTimes.value( fromUTF8( b->alias() ), INT_MAX );
+
+                          return timeA > timeB;
+                      } );
+}
+
+
+void MyrlynRepoManager::startRefreshWorkers()
+{
+    while ( _refreshWorkers.size() < _maxRefreshWorkers && ! _pendingRefresh.isEmpty() )
+    {
+        ZyppRepoInfo * repo = _pendingRefresh.takeFirst();
+
+        QStringList args;
+        args << "--refresh-repo-worker" << fromUTF8( repo->alias() );
+
+        if ( MyrlynApp::isOptionSet( OptSlowRepoRefresh ) )
+            args << "--slow-repo-refresh";
+
+        QProcess * worker = new QProcess( this );
+        CHECK_NEW( worker );
+
+        // The phase times come on stdout; stderr is only for diagnostics
+        worker->setProcessChannelMode( QProcess::ForwardedErrorChannel );
+
+        connect( worker, SIGNAL( finished             ( int, QProcess::ExitStatus ) ),
+                 this,   SLOT  ( refreshWorkerFinished( int, QProcess::ExitStatus ) ) );
+
+        logInfo() << "Refreshing repo " << repo->name() << " in a worker process..." << endl;
+        emit refreshRepoStart( *repo );
+
+        worker->start( QCoreApplication::applicationFilePath(), args );
+
+        if ( ! worker->waitForStarted() )
+        {
+            logError() << "Could not start a refresh worker process: "
+                       << worker->errorString() << endl;
+
+            _failedRefresh << repo;
+            delete worker;
+            continue;
+        }
+
+        _refreshWorkers[ worker ] = repo;
+        _refreshWorkerTimers[ worker ].start();
+        StartupTimer::instance()->begin( "refresh:" + fromUTF8( repo->alias() ) );
+    }
+}
+
+
+void MyrlynRepoManager::refreshWorkerFinished( int exitCode, QProcess::ExitStatus exitStatus )
+{
+    QProcess * worker = qobject_cast<QProcess *>( sender() );
+
+    if ( ! worker || ! _refreshWorkers.contains( worker ) )
+        return;
+
+    ZyppRepoInfo * repo    = _refreshWorkers.take( worker );
+    qint64         elapsed = _refreshWorkerTimers.take( worker ).elapsed();
+    worker->deleteLater();
+    StartupTimer::instance()->end( "refresh:" + fromUTF8( repo->alias() ) );
+    addWorkerPhases( worker, *repo, elapsed );
+
+    if ( exitStatus == QProcess::NormalExit && exitCode == REFRESH_WORKER_OK )
+    {
+        logInfo() << "Refreshing repo " << repo->name()
+                  << " done after " << elapsed / 1000.0 << " sec"
+                  << endl;
+
+        _refreshTimes[ fromUTF8( repo->alias() ) ] = (int) elapsed;
+        emit refreshRepoDone( *repo );
+    }
+    else if ( exitStatus == QProcess::NormalExit &&
+              exitCode   != REFRESH_WORKER_KEY   &&
+              _refreshLoop )
+    {
+        // Most likely a network problem: Trying again in this process would
+        // only wait for the same timeouts once more, so do what
+        // refreshRepo() does when it fails.
+
+        logWarning() << "Refresh worker for repo " << repo->name()
+                     << " failed with exit code " << exitCode << endl;
+
+        logInfo() << "Disabling repo " << repo->name() << endl;
+        repo->setEnabled( false );
+    }
+    else
+    {
+        logWarning() << "Refresh worker for repo " << repo->name()
+                     << " failed with exit code " << exitCode << endl;
+
+        _failedRefresh << repo;
+    }
+
+    startRefreshWorkers();
+
+    if ( _refreshWorkers.isEmpty() )
+    {
+        if ( _refreshLoop )
+            _refreshLoop->quit();
+        else
+            finishBackgroundRefresh();
+    }
+}
+
+
+void MyrlynRepoManager::addWorkerPhases( QProcess *           worker,
+                                         const ZyppRepoInfo & repo,
+                                         qint64               elapsed )
+{
+    StartupTimer * timer = StartupTimer::instance();
+
+    if ( timer->isFinished() )
+        return;
+
+    QStringList output = QString::fromUtf8( worker->readAllStandardOutput() ).split( '\n' );
+    qint64      start  = timer->elapsed() - elapsed;
+
+    for ( const QString & line: output )
+    {
+        QStringList fields = line.split( ' ' );
+
+        if ( fields.size() != 2 )
+            continue;
+
+        qint64 wall = fields[1].toLongLong();
+        timer->add( fields[0] + ":" + fromUTF8( repo.alias() ), start, wall );
+        start += wall;
+    }
+}
+
+
+int MyrlynRepoManager::refreshRepoWorker( const QString & alias,
+                                          bool            slowRefresh )
+{
+    QElapsedTimer timer;
+    timer.start();
+
+    RefreshWorkerKeyRingCallback keyRingCallback;
+    keyRingCallback.connect();
+
+    try
+    {
+        // Don't use the ZYpp instance here: The parent process holds the
+        // zypp lock. The repo manager alone does not need it.
+
+        zypp::RepoManager repoManager;
+        ZyppRepoInfo repo = repoManager.getRepositoryInfo( toUTF8( alias ) );
+
+        logInfo() << "Refreshing repo " << repo.name() << "..." << endl;
+
+        QElapsedTimer phaseTimer;
+        phaseTimer.start();
+
+        repoManager.refreshMetadata( repo, zypp::RepoManager::RefreshIfNeeded );
+        std::cout << "refreshMetadata " << phaseTimer.restart() << std::endl;
+
+        repoManager.buildCache( repo, zypp::RepoManager::BuildIfNeeded );
+        std::cout << "buildCache " << phaseTimer.elapsed() << std::endl;
+
+        if ( slowRefresh )
+            sleep( 2 );
+
+        logInfo() << "Refreshing repo " << repo.name()
+                  << " done after " << timer.elapsed() / 1000.0 << " sec"
+                  << endl;
+    }
+    catch ( const zypp::repo::RepoException & exception )
+    {
+        logWarning() << "CAUGHT zypp exception for repo " << alias
+                     << ": " << exception.asString() << endl;
+
+        return keyRingCallback.askedForKey ? REFRESH_WORKER_KEY : REFRESH_WORKER_FAILED;
+    }
+    catch ( const zypp::Exception & exception )
+    {
+        logError() << "CAUGHT zypp exception for repo " << alias
+                   << ": " << exception.asString() << endl;
+
+        return keyRingCallback.askedForKey ? REFRESH_WORKER_KEY : REFRESH_WORKER_ERROR;
+    }
+
+    return REFRESH_WORKER_OK;
+}
+
+
+void MyrlynRepoManager::readRefreshTimes()
+{
+    QSettings settings;
+    settings.beginGroup( "RepoRefreshTime" );
+
+    for ( const QString & alias: settings.childKeys() )
+        _refreshTimes[ alias ] = settings.value( alias, 0 ).toInt();
+
+    settings.endGroup();
+}
+
+
+void MyrlynRepoManager::writeRefreshTimes()
+{
+    QSettings settings;
+    settings.beginGroup( "RepoRefreshTime" );
+
+    for ( const QString & alias: _refreshTimes.keys() )
+        settings.setValue( alias, _refreshTimes.value( alias ) );
+
+    settings.endGroup();
 }
 
 
@@ -250,6 +810,7 @@ void MyrlynRepoManager::loadRepos()
         if ( repo.enabled() )
         {
             logDebug() << "Loading resolvables from " << repo.name() << endl;
+            StartupPhase phase( "loadFromCache:" + fromUTF8( repo.alias() ) );
             repoManager()->loadFromCache( repo );
         }
         else
@@ -260,6 +821,274 @@ void MyrlynRepoManager::loadRepos()
 }
 
 
+void MyrlynRepoManager::reloadRepos( const QStringList & aliases )
+{
+    if ( aliases.isEmpty() )
+        return;
+
+    QList<SavedStatus> savedStatus = saveUserStatus();
+
+    for ( const QString & alias: aliases )
+    {
+        logInfo() << "Reloading repo " << alias << endl;
+        zypp::sat::Pool::instance().reposErase( toUTF8( alias ) );
+
+        for ( ZyppRepoInfo & repo: _repos )
+        {
+            if ( repo.alias() != toUTF8( alias ) || ! repo.enabled() )
+                continue;
+
+            try
+            {
+                repoManager()->loadFromCache( repo );
+            }
+            catch ( const zypp::Exception & exception )
+            {
+                logError() << "Reloading repo " << alias << " failed: "
+                           << exception.asString() << endl;
+            }
+        }
+    }
+
+    restoreUserStatus( savedStatus );
+    PoolGeneration::invalidate();
+}
+
+
+void MyrlynRepoManager::applyRepoChanges( const QStringList & aliases )
+{
+    if ( aliases.isEmpty() )
+        return;
+
+    if ( backgroundRefreshRunning() )
+    {
+        logError() << "Can't apply repo changes during the background refresh" << endl;
+        return;
+    }
+
+    KeyRingCallbacks keyRingCallbacks;
+
+    for ( const QString & alias: aliases )
+    {
+        std::string zyppAlias = toUTF8( alias );
+        bool        exists    = repoManager()->hasRepo( zyppAlias );
+        ZyppRepoInfo newRepo  = exists ? repoManager()->getRepo( zyppAlias ) : ZyppRepoInfo();
+
+        RepoInfoList::iterator oldRepo = _repos.begin();
+
+        while ( oldRepo != _repos.end() && oldRepo->alias() != zyppAlias )
+            ++oldRepo;
+
+        bool wasLoaded = oldRepo != _repos.end() && oldRepo->enabled();
+
+        if ( ! exists || ! newRepo.enabled() )
+        {
+            // Deleted or disabled: reloadRepos() will only remove it
+
+            logInfo() << "Unloading repo " << alias << endl;
+
+            if ( oldRepo != _repos.end() )
+                _repos.erase( oldRepo );
+
+            continue;
+        }
+
+        bool needRefresh = ! wasLoaded || oldRepo->url() != newRepo.url();
+
+        if ( oldRepo == _repos.end() ) // New or newly enabled
+        {
+            _repos.push_back( newRepo );
+            oldRepo = --_repos.end();
+        }
+        else
+        {
+            *oldRepo = newRepo;
+        }
+
+        if ( needRefresh || ! repoManager()->isCached( *oldRepo ) )
+        {
+            if ( geteuid() == 0 )
+                refreshRepo( *oldRepo ); // This disables it upon failure
+            else
+                logWarning() << "Not refreshing repo " << alias << " as non-root" << endl;
+        }
+    }
+
+    // Even for just a new priority: That changes the order of the
+    // available versions of many selectables, so the pool needs to set
+    // them up again. Loading one repo from its cache is cheap.
+
+    reloadRepos( aliases );
+}
+
+
+/**
+ * Store the version of 'obj' in 'saved'.
+ **/
+static void
+saveVersion( MyrlynRepoManager::SavedStatus & saved, ZyppObj obj )
+{
+    if ( ! obj )
+        return;
+
+    saved.edition   = obj->edition().asString();
+    saved.arch      = obj->arch().asString();
+    saved.repoAlias = obj->repository().alias();
+}
+
+
+/**
+ * Return the pool item of 'selectable' with the version in 'saved' or a
+ * null pool item if there is none.
+ **/
+static zypp::PoolItem
+findVersion( ZyppSel selectable, const MyrlynRepoManager::SavedStatus & saved )
+{
+    for ( zypp::ui::Selectable::picklist_iterator it = selectable->picklistBegin();
+          it != selectable->picklistEnd();
+          ++it )
+    {
+        if ( it->edition().asString() == saved.edition &&
+             it->arch().asString()    == saved.arch    &&
+             it->repository().alias() == saved.repoAlias )
+        {
+            return *it;
+        }
+    }
+
+    return zypp::PoolItem();
+}
+
+
+QList<MyrlynRepoManager::SavedStatus>
+MyrlynRepoManager::saveUserStatus()
+{
+    QList<SavedStatus> savedStatus;
+
+    const zypp::ResKind kinds[] =
+    {
+        zypp::ResKind::package,
+        zypp::ResKind::pattern,
+        zypp::ResKind::patch,
+        zypp::ResKind::product
+    };
+
+    for ( const zypp::ResKind & kind: kinds )
+    {
+        for ( ZyppPoolIterator it = zyppPool().byKindBegin( kind );
+              it != zyppPool().byKindEnd( kind );
+              ++it )
+        {
+            if ( (*it)->multiversionInstall() )
+            {
+                // Save each version that the user picked
+
+                for ( zypp::ui::Selectable::picklist_iterator pick = (*it)->picklistBegin();
+                      pick != (*it)->picklistEnd();
+                      ++pick )
+                {
+                    ZyppStatus status = (*it)->pickStatus( *pick );
+
+                    if ( status == S_Install || status == S_Del )
+                    {
+                        SavedStatus saved( kind, (*it)->name(), status );
+                        saved.pick = true;
+                        saveVersion( saved, pick->resolvable() );
+                        savedStatus << saved;
+                    }
+                }
+
+                continue;
+            }
+
+            ZyppStatus status = (*it)->status();
+
+            switch ( status )
+            {
+                // Only what the user set explicitly;
+                // the solver will take care of the rest.
+
+                case S_Install:
+                case S_Update:
+                    {
+                        SavedStatus saved( kind, (*it)->name(), status );
+                        saveVersion( saved, (*it)->candidateObj() );
+                        savedStatus << saved;
+                    }
+                    break;
+
+                case S_Del:
+                case S_Taboo:
+                case S_Protected:
+                    savedStatus << SavedStatus( kind, (*it)->name(), status );
+                    break;
+
+                default:
+                    break;
+            }
+        }
+    }
+
+    logDebug() << "Saved the status of " << savedStatus.size() << " selectables" << endl;
+
+    return savedStatus;
+}
+
+
+void
+MyrlynRepoManager::restoreUserStatus( const QList<SavedStatus> & savedStatus )
+{
+    for ( const SavedStatus & saved: savedStatus )
+    {
+        ZyppSel selectable = zyppPool().lookup( saved.kind, saved.name );
+
+        if ( ! selectable )
+        {
+            logWarning() << "No more " << saved.kind.asString() << " " << saved.name
+                         << " after the reload" << endl;
+            continue;
+        }
+
+        zypp::PoolItem version;
+
+        if ( ! saved.edition.empty() )
+        {
+            version = findVersion( selectable, saved );
+
+            if ( ! version )
+            {
+                logWarning() << "No more version " << saved.edition << "." << saved.arch
+                             << " from " << saved.repoAlias << " of "
+                             << saved.kind.asString() << " " << saved.name << endl;
+            }
+        }
+
+        if ( saved.pick )
+        {
+            if ( version && ! selectable->setPickStatus( version, saved.status ) )
+            {
+                logWarning() << "Could not restore pick status " << saved.status
+                             << " for " << saved.name << "-" << saved.edition << endl;
+            }
+
+            continue;
+        }
+
+        // The candidate first: Setting the status uses it
+
+        if ( version && ! version.status().isInstalled() )
+            selectable->setCandidate( version );
+
+        if ( selectable->status() != saved.status &&
+             ! selectable->setStatus( saved.status ) )
+        {
+            logWarning() << "Could not restore status " << saved.status
+                         << " for " << saved.kind.asString() << " " << saved.name << endl;
+        }
+    }
+}
+
+
 void MyrlynRepoManager::notifyUserToRunZypperDup() const
 {
     logInfo() << "Run 'sudo zypper refresh' and restart the program." << endl;
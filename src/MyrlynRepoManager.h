@@ -21,6 +21,11 @@
 #include <list>
 #include <memory>
 
+#include <QElapsedTimer>
+#include <QHash>
+#include <QProcess>
+#include <QStringList>
+
 #include <zypp/ZYpp.h>
 #include <zypp/RepoManager.h>
 #include <zypp/RepoInfo.h>
@@ -31,6 +36,8 @@
 using RepoManager_Ptr = std::shared_ptr<zypp::RepoManager>;
 typedef std::list<ZyppRepoInfo> RepoInfoList;
 
+class QEventLoop;
+
 
 /**
  * Handler for zypp Repos on the Myrlyn side
@@ -40,6 +47,18 @@ class MyrlynRepoManager: public QObject
     Q_OBJECT
 
 public:
+
+    /**
+     * Result of the local check whether a repo needs to be refreshed.
+     **/
+    enum RepoRefreshState
+    {
+        RepoFresh,              // Metadata checked recently, cache up to date
+        RepoNeedsRefresh,       // Metadata need to be checked on the server
+        RepoNeedsCacheBuild,    // Only the solv cache needs to be rebuilt
+        RepoBroken              // No URL or no readable local metadata status
+    };
+
     /**
      * Constructor
      **/
@@ -67,6 +86,23 @@ public:
      **/
     void initTarget();
 
+    /**
+     * Notification that a commit changed the target, so the installed
+     * packages in the pool are no longer up to date.
+     **/
+    void setTargetChanged() { _targetChanged = true; }
+
+    /**
+     * If the target changed since it was loaded, load it again to continue
+     * with more changes without restarting the program: Only the target
+     * ("@System") is reloaded into the pool, all other repos are left alone.
+     * Any pending transactions are reset; locks are kept.
+     *
+     * Return 'true' if the target was reloaded. The caller is responsible
+     * for updating any widgets.
+     **/
+    bool reloadTargetIfChanged();
+
     /**
      * Attach the active repos and load their resolvables.
      **/
@@ -89,6 +125,110 @@ public:
      **/
     RepoManager_Ptr repoManager();
 
+    /**
+     * Refresh the metadata and build the cache of the repo with alias
+     * 'alias' in a worker process that was started for a parallel repos
+     * refresh (command line option --refresh-repo-worker). This uses its own
+     * zypp repo manager and does not connect to zypp.
+     *
+     * Return the exit code for the worker process: 0 for success,
+     * nonzero for failure.
+     **/
+    static int refreshRepoWorker( const QString & alias,
+                                  bool            slowRefresh = false );
+
+    /**
+     * Return 'true' if attachRepos() loaded the repos from their existing
+     * caches without refreshing them first (command line option
+     * --fast-start) and startBackgroundRefresh() was not called yet.
+     **/
+    bool backgroundRefreshPending() const { return _backgroundRefreshPending; }
+
+    /**
+     * Return 'true' while startBackgroundRefresh() is still refreshing repos
+     * in worker processes. Don't change _repos during that time.
+     **/
+    bool backgroundRefreshRunning() const;
+
+    /**
+     * Reload the resolvables of the repos with the specified aliases into
+     * the pool without restarting the program: Remove them from the pool
+     * and load them again from the cache if the repo is enabled.
+     *
+     * The status that the user explicitly set for a package, pattern,
+     * patch or product is restored afterwards if it still exists.
+     * The caller is responsible for updating any widgets.
+     **/
+    void reloadRepos( const QStringList & aliases );
+
+    /**
+     * Apply the configuration changes of the repos with the specified
+     * aliases (e.g. from the RepoConfigDialog) to the pool without
+     * restarting the program:
+     *
+     * Repos that were deleted or disabled are removed from the pool. Repos
+     * that were added or enabled or whose URL changed are refreshed (if
+     * running as root) and loaded. Repos with other changes like a new
+     * priority are only reloaded from their cache.
+     *
+     * All other repos and the target are left alone. Like with
+     * reloadRepos(), the caller is responsible for updating any widgets.
+     *
+     * This does nothing while backgroundRefreshRunning(): The refresh
+     * workers still refer to the repos that this would change or remove.
+     **/
+    void applyRepoChanges( const QStringList & aliases );
+
+    /**
+     * A status that the user explicitly set for a selectable, identified by
+     * kind and name so it can be restored after the pool is reloaded or
+     * in another process.
+     *
+     * For a status that installs something, 'edition', 'arch' and
+     * 'repoAlias' identify the candidate version, which the user may have
+     * chosen in the versions view. For multiversion packages, there is one
+     * SavedStatus with 'pick' set for each version the user chose to install
+     * or remove.
+     **/
+    struct SavedStatus
+    {
+        SavedStatus( const zypp::ResKind & kind,
+                     const std::string &   name,
+                     ZyppStatus            status )
+            : kind( kind ), name( name ), status( status ), pick( false )
+            {}
+
+        zypp::ResKind kind;
+        std::string   name;
+        ZyppStatus    status;
+
+        std::string   edition;
+        std::string   arch;
+        std::string   repoAlias;
+        bool          pick;
+    };
+
+    /**
+     * Return the status of all selectables that the user explicitly set
+     * to something other than the default.
+     **/
+    static QList<SavedStatus> saveUserStatus();
+
+    /**
+     * Restore the status from saveUserStatus() as far as the selectables
+     * still exist.
+     **/
+    static void restoreUserStatus( const QList<SavedStatus> & savedStatus );
+
+
+public slots:
+
+    /**
+     * Refresh the enabled repos in worker processes without blocking the
+     * event loop. Emit backgroundRefreshFinished() when done.
+     **/
+    void startBackgroundRefresh();
+
 
 signals:
 
@@ -107,6 +247,33 @@ signals:
      **/
     void refreshRepoDone ( const ZyppRepoInfo & repo );
 
+    /**
+     * Emitted for each repo when it is known whether it needs to be
+     * refreshed. 'state' is one of the RepoRefreshState values.
+     **/
+    void repoClassified( const ZyppRepoInfo & repo, int state );
+
+    /**
+     * Emitted when all repos are classified: 'needWork' of 'total' repos
+     * will actually be refreshed.
+     **/
+    void reposClassified( int total, int needWork );
+
+    /**
+     * Emitted when the refresh started with startBackgroundRefresh() is
+     * finished. 'changedAliases' are the aliases of the repos whose cache
+     * changed; those need reloadRepos() to become visible in the pool.
+     **/
+    void backgroundRefreshFinished( const QStringList & changedAliases );
+
+
+protected slots:
+
+    /**
+     * Notification that a refresh worker process finished.
+     **/
+    void refreshWorkerFinished( int exitCode, QProcess::ExitStatus exitStatus );
+
 
 protected:
 
@@ -132,9 +299,87 @@ protected:
     /**
      * Refresh the enabled repos if needed.
      * This is skipped for non-privileged users.
+     *
+     * All repos are classified with refreshState() first; the ones that are
+     * fresh are skipped right away.
+     *
+     * Unless only one repo needs to be refreshed or the --serial-repo-refresh command
+     * line option is set, this refreshes up to MAX_PARALLEL_REFRESH repos at
+     * the same time in worker processes, the repos that took longest the
+     * last time first. Repos that fail in a worker process are refreshed
+     * again in this process so the key ring callbacks can ask the user.
      **/
     void refreshRepos();
 
+    /**
+     * Return 'true' if the repos should only be refreshed in the background
+     * after the package selector is shown.
+     **/
+    bool useFastStart() const;
+
+    /**
+     * Check if 'repo' needs to be refreshed, using only the local
+     * timestamps and cookies of its raw metadata and solv cache; this
+     * doesn't download anything. This mirrors the checks of
+     * RefreshIfNeeded and BuildIfNeeded in libzypp.
+     **/
+    RepoRefreshState refreshState( const ZyppRepoInfo & repo );
+
+    /**
+     * Refresh only those enabled repos that don't have a cache yet:
+     * Without a cache, they could not be loaded at all.
+     **/
+    void refreshUncachedRepos();
+
+    /**
+     * Refresh one repo in this process and disable it if that fails.
+     **/
+    void refreshRepo( ZyppRepoInfo & repo );
+
+    /**
+     * Refresh 'repos' in up to 'maxWorkers' worker processes and return the
+     * repos that need to be refreshed again in this process: the ones that
+     * need the user to accept a GPG key and the ones whose worker crashed or
+     * could not be started. Repos that failed for other reasons (e.g. an
+     * unreachable server) are disabled right away.
+     **/
+    QList<ZyppRepoInfo *> refreshReposParallel( const QList<ZyppRepoInfo *> & repos,
+                                                int maxWorkers );
+
+    /**
+     * Start refresh worker processes for pending repos until there are
+     * _maxRefreshWorkers of them or no more pending repos.
+     **/
+    void startRefreshWorkers();
+
+    /**
+     * Add the refreshMetadata and buildCache phases that a refresh worker
+     * that ran for 'elapsed' millisec reported on its stdout to the startup
+     * timer.
+     **/
+    void addWorkerPhases( QProcess *           worker,
+                          const ZyppRepoInfo & repo,
+                          qint64               elapsed );
+
+    /**
+     * Sort _pendingRefresh so the repos that took longest the last time
+     * come first.
+     **/
+    void sortPendingRefresh();
+
+    /**
+     * Find out which repos changed during the background refresh and emit
+     * backgroundRefreshFinished().
+     **/
+    void finishBackgroundRefresh();
+
+    /**
+     * Read and write the refresh durations of the repos from earlier runs
+     * from / to the settings.
+     **/
+    void readRefreshTimes();
+    void writeRefreshTimes();
+
     /**
      * Load the resolvables from the enabled repos.
      **/
@@ -154,6 +399,19 @@ protected:
     zypp::ZYpp::Ptr _zypp_ptr;
     RepoManager_Ptr _repo_manager_ptr;
     RepoInfoList    _repos;
+
+    // Parallel repos refresh
+
+    QHash<QString, int>               _refreshTimes;    // millisec by alias
+    QList<ZyppRepoInfo *>             _pendingRefresh;
+    QList<ZyppRepoInfo *>             _failedRefresh;
+    QHash<QProcess *, ZyppRepoInfo *> _refreshWorkers;
+    QHash<QProcess *, QElapsedTimer>  _refreshWorkerTimers;
+    int                               _maxRefreshWorkers;
+    QEventLoop *                      _refreshLoop;
+    bool                              _backgroundRefreshPending;
+    bool                              _targetChanged;
+    QHash<QString, QString>           _cacheChecksums;  // by alias
 };
 
 #endif // MyrlynRepoManager_h
@@ -206,7 +206,15 @@ void PkgSelStep::activate( bool goingForward )
     MyrlynWorkflowStep::activate( goingForward ); // Show the page
 
     if ( ! goingForward )
-        _app->pkgSel()->reset(); // includes resetResolver()
+    {
+        // Coming back after a commit: Continue with the updated target
+        // instead of restarting the program.
+
+        if ( _app->repoManager()->reloadTargetIfChanged() )
+            _app->pkgSel()->targetReloaded(); // includes reset()
+        else
+            _app->pkgSel()->reset(); // includes resetResolver()
+    }
 }
 
 
@@ -0,0 +1,133 @@
+/*  ---------------------------------------------------------
+               __  __            _
+              |  \/  |_   _ _ __| |_   _ _ __
+              | |\/| | | | | '__| | | | | '_ \
+              | |  | | |_| | |  | | |_| | | | |
+              |_|  |_|\__, |_|  |_|\__, |_| |_|
+                      |___/        |___/
+    ---------------------------------------------------------
+
+    Project:  Myrlyn Package Manager GUI
+    Copyright (c) Stefan Hundhammer <Stefan.Hundhammer@gmx.de>
+    License:  GPL V2 - See file LICENSE for details.
+
+    Textdomain "qt-pkg"
+ */
+
+
+#include <algorithm>
+
+#include "Exception.h"
+#include "PkgBitset.h"
+
+
+PkgBitset::PkgBitset( int size, bool initialValue )
+    : _words( ( size + WORD_BITS - 1 ) / WORD_BITS, initialValue ? ~Word( 0 ) : Word( 0 ) )
+    , _size( size )
+{
+    clearTail();
+}
+
+
+void
+PkgBitset::fill( bool value )
+{
+    std::fill( _words.begin(), _words.end(), value ? ~Word( 0 ) : Word( 0 ) );
+    clearTail();
+}
+
+
+int
+PkgBitset::count() const
+{
+    int sum = 0;
+
+    for ( Word word: _words )
+        sum += __builtin_popcountll( word );
+
+    return sum;
+}
+
+
+bool
+PkgBitset::isEmpty() const
+{
+    for ( Word word: _words )
+    {
+        if ( word )
+            return false;
+    }
+
+    return true;
+}
+
+
+PkgBitset &
+PkgBitset::operator&=( const PkgBitset & other )
+{
+    if ( other._size != _size )
+        THROW( Exception( "PkgBitset size mismatch" ) );
+
+    for ( size_t i = 0; i < _words.size(); ++i )
+        _words[ i ] &= other._words[ i ];
+
+    return *this;
+}
+
+
+PkgBitset &
+PkgBitset::operator|=( const PkgBitset & other )
+{
+    if ( other._size != _size )
+        THROW( Exception( "PkgBitset size mismatch" ) );
+
+    for ( size_t i = 0; i < _words.size(); ++i )
+        _words[ i ] |= other._words[ i ];
+
+    return *this;
+}
+
+
+void
+PkgBitset::flip()
+{
+    for ( Word & word: _words )
+        word = ~word;
+
+    clearTail();
+}
+
+
+int
+PkgBitset::next( int id ) const
+{
+    if ( id < 0 )
+        id = 0;
+
+    if ( id >= _size )
+        return -1;
+
+    size_t wordIndex = id / WORD_BITS;
+    Word   word      = _words[ wordIndex ] & ( ~Word( 0 ) << ( id % WORD_BITS ) );
+
+    while ( true )
+    {
+        if ( word )
+            return wordIndex * WORD_BITS + __builtin_ctzll( word );
+
+        if ( ++wordIndex >= _words.size() )
+            return -1;
+
+        word = _words[ wordIndex ];
+    }
+}
+
+
+void
+PkgBitset::clearTail()
+{
+    int usedBits = _size % WORD_BITS;
+
+    if ( usedBits > 0 && ! _words.empty() )
+        _words.back() &= ( Word( 1 ) << usedBits ) - 1;
+}
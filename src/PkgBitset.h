@@ -0,0 +1,135 @@
+/*  ---------------------------------------------------------
+               __  __            _
+              |  \/  |_   _ _ __| |_   _ _ __
+              | |\/| | | | | '__| | | | | '_ \
+              | |  | | |_| | |  | | |_| | | | |
+              |_|  |_|\__, |_|  |_|\__, |_| |_|
+                      |___/        |___/
+    ---------------------------------------------------------
+
+    Project:  Myrlyn Package Manager GUI
+    Copyright (c) Stefan Hundhammer <Stefan.Hundhammer@gmx.de>
+    License:  GPL V2 - See file LICENSE for details.
+
+    Textdomain "qt-pkg"
+ */
+
+
+#ifndef PkgBitset_h
+#define PkgBitset_h
+
+#include <cstdint>
+#include <vector>
+
+
+/**
+ * Dense set of selectable IDs (see SelectableIds) with one bit per ID.
+ *
+ * Set operations (AND, OR, NOT) work on whole 64 bit words at a time, so
+ * combining the results of several filters over the complete pool is
+ * just a few thousand machine instructions.
+ **/
+class PkgBitset
+{
+public:
+
+    typedef uint64_t Word;
+
+    /**
+     * Constructor: Create a bitset for IDs 0..size-1 with all bits set to
+     * 'initialValue'.
+     **/
+    PkgBitset( int size = 0, bool initialValue = false );
+
+    /**
+     * Return the number of IDs this bitset can hold.
+     **/
+    int size() const { return _size; }
+
+    /**
+     * Return 'true' if the bit for 'id' is set.
+     **/
+    bool test( int id ) const
+        { return _words[ id / WORD_BITS ] & ( Word( 1 ) << ( id % WORD_BITS ) ); }
+
+    /**
+     * Set the bit for 'id'.
+     **/
+    void set( int id )
+        { _words[ id / WORD_BITS ] |= ( Word( 1 ) << ( id % WORD_BITS ) ); }
+
+    /**
+     * Clear the bit for 'id'.
+     **/
+    void reset( int id )
+        { _words[ id / WORD_BITS ] &= ~( Word( 1 ) << ( id % WORD_BITS ) ); }
+
+    /**
+     * Set all bits to 'value'.
+     **/
+    void fill( bool value );
+
+    /**
+     * Return the number of bits that are set.
+     **/
+    int count() const;
+
+    /**
+     * Return 'true' if no bit is set.
+     **/
+    bool isEmpty() const;
+
+    /**
+     * Set operations. Both bitsets need to have the same size.
+     **/
+    PkgBitset & operator&=( const PkgBitset & other );
+    PkgBitset & operator|=( const PkgBitset & other );
+
+    /**
+     * Invert all bits (set complement).
+     **/
+    void flip();
+
+    /**
+     * Return the first ID that is set starting from 'id' (inclusive)
+     * or -1 if there is none. Use this to iterate over all IDs in the set:
+     *
+     *   for ( int id = bits.next( 0 ); id >= 0; id = bits.next( id + 1 ) )
+     **/
+    int next( int id ) const;
+
+    /**
+     * Return the raw words.
+     **/
+    const std::vector<Word> & words() const { return _words; }
+
+    /**
+     * Return the number of words.
+     **/
+    int wordCount() const { return (int) _words.size(); }
+
+    /**
+     * Set a complete word, i.e. the bits for IDs wordIndex * WORD_BITS and
+     * the following WORD_BITS - 1 ones. This is much faster than setting
+     * each bit individually. Bits beyond size() must not be set.
+     **/
+    void setWord( int wordIndex, Word word ) { _words[ wordIndex ] = word; }
+
+
+    static const int WORD_BITS = 64;
+
+
+protected:
+
+    /**
+     * Clear the unused bits in the last word after operations that might
+     * have set them.
+     **/
+    void clearTail();
+
+    std::vector<Word> _words;
+    int               _size;
+};
+
+
+#endif // PkgBitset_h
@@ -30,6 +30,7 @@
 #include "PkgTaskListWidget.h"
 #include "ProgressDialog.h"
 #include "MyrlynApp.h"
+#include "MyrlynRepoManager.h"
 #include "YQZypp.h"
 #include "YQi18n.h"
 #include "utf8.h"
@@ -218,6 +219,15 @@ void PkgCommitPage::realCommit()
         logInfo() << "libzypp aborted as requested" << endl;
     }
 
+    // Even after an abort, some packages might have been changed already.
+    // Make sure to reload the target if the user goes back to the package
+    // selection for more changes.
+
+    if ( ! MyrlynApp::isOptionSet( OptDryRun ) &&
+         ! MyrlynApp::isOptionSet( OptDownloadOnly ) )
+    {
+        MyrlynApp::instance()->repoManager()->setTargetChanged();
+    }
 }
 
 
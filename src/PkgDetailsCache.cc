@@ -0,0 +1,282 @@
+/*  ---------------------------------------------------------
+               __  __            _
+              |  \/  |_   _ _ __| |_   _ _ __
+              | |\/| | | | | '__| | | | | '_ \
+              | |  | | |_| | |  | | |_| | | | |
+              |_|  |_|\__, |_|  |_|\__, |_| |_|
+                      |___/        |___/
+    ---------------------------------------------------------
+
+    Project:  Myrlyn Package Manager GUI
+    Copyright (c) Stefan Hundhammer <Stefan.Hundhammer@gmx.de>
+    License:  GPL V2 - See file LICENSE for details.
+
+    Textdomain "qt-pkg"
+ */
+
+
+#include <zypp/Capability.h>
+#include <zypp/Package.h>
+#include <zypp/ResObject.h>
+#include <zypp/ui/Selectable.h>
+
+#include "Exception.h"
+#include "Logger.h"
+#include "PoolGeneration.h"
+#include "PkgDetailsCache.h"
+
+
+#define VERBOSE_DETAILS_CACHE   0
+
+// Maximum total number of file list entries, change log entries and
+// dependency strings in the respective caches
+#define MAX_CACHED_FILES        200000
+#define MAX_CACHED_CHANGES      20000
+#define MAX_CACHED_DEPS         50000
+#define MAX_CACHED_CAP_STRINGS  200000
+
+
+// The dependency kinds shown in the dependencies view
+static const zypp::Dep allDeps[] =
+{
+    zypp::Dep::PROVIDES,
+    zypp::Dep::PREREQUIRES,
+    zypp::Dep::REQUIRES,
+    zypp::Dep::CONFLICTS,
+    zypp::Dep::OBSOLETES,
+    zypp::Dep::RECOMMENDS,
+    zypp::Dep::SUGGESTS,
+    zypp::Dep::ENHANCES,
+    zypp::Dep::SUPPLEMENTS
+};
+
+
+PkgDetailsCache *
+PkgDetailsCache::instance()
+{
+    static PkgDetailsCache * cache = 0;
+
+    if ( ! cache )
+    {
+        cache = new PkgDetailsCache();
+        CHECK_NEW( cache );
+    }
+
+    return cache;
+}
+
+
+PkgDetailsCache::PkgDetailsCache()
+    : QObject()
+    , _fileLists( MAX_CACHED_FILES )
+    , _changeLogs( MAX_CACHED_CHANGES )
+    , _dependencies( MAX_CACHED_DEPS )
+    , _generation( -1 )
+    , _usedKinds( 0 )
+    , _wantedKinds( 0 )
+{
+    _prefetchTimer.setInterval( 0 );
+
+    connect( &_prefetchTimer, SIGNAL( timeout()      ),
+             this,            SLOT  ( prefetchNext() ) );
+}
+
+
+PkgDetailsCache::~PkgDetailsCache()
+{
+    // NOP
+}
+
+
+void
+PkgDetailsCache::checkGeneration()
+{
+    int generation = PoolGeneration::contentGeneration();
+
+    if ( generation != _generation )
+    {
+        _fileLists.clear();
+        _changeLogs.clear();
+        _dependencies.clear();
+        _capStrings.clear();
+        _queue.clear();
+        _generation = generation;
+    }
+}
+
+
+std::list<std::string>
+PkgDetailsCache::fileList( ZyppPkg pkg )
+{
+    _usedKinds |= FileList;
+
+    if ( ! pkg )
+        return std::list<std::string>();
+
+    checkGeneration();
+
+    std::list<std::string> * cached = _fileLists.object( pkg.get() );
+
+    if ( cached )
+        return *cached;
+
+    zypp::Package::FileList zyppFileList( pkg->filelist() );
+    std::list<std::string> * files =
+        new std::list<std::string>( zyppFileList.begin(), zyppFileList.end() );
+    CHECK_NEW( files );
+
+    std::list<std::string> result = *files;
+    _fileLists.insert( pkg.get(), files, files->size() + 1 );
+
+    return result;
+}
+
+
+zypp::Changelog
+PkgDetailsCache::changeLog( ZyppPkg pkg )
+{
+    _usedKinds |= ChangeLog;
+
+    if ( ! pkg )
+        return zypp::Changelog();
+
+    checkGeneration();
+
+    zypp::Changelog * cached = _changeLogs.object( pkg.get() );
+
+    if ( cached )
+        return *cached;
+
+    zypp::Changelog * changes = new zypp::Changelog( pkg->changelog() );
+    CHECK_NEW( changes );
+
+    zypp::Changelog result = *changes;
+    _changeLogs.insert( pkg.get(), changes, changes->size() + 1 );
+
+    return result;
+}
+
+
+QStringList
+PkgDetailsCache::dependencies( ZyppObj obj, zypp::Dep dep )
+{
+    _usedKinds |= Dependencies;
+
+    return allDependencies( obj ).value( dep.inSwitch() );
+}
+
+
+PkgDetailsCache::PkgDependencies
+PkgDetailsCache::allDependencies( ZyppObj obj )
+{
+    if ( ! obj )
+        return PkgDependencies();
+
+    checkGeneration();
+
+    PkgDependencies * cached = _dependencies.object( obj.get() );
+
+    if ( cached )
+        return *cached;
+
+    PkgDependencies * deps = new PkgDependencies();
+    CHECK_NEW( deps );
+    int count = 0;
+
+    for ( const zypp::Dep & dep: allDeps )
+    {
+        QStringList strings;
+
+        for ( const zypp::Capability & cap: obj->dep( dep ) )
+            strings << capabilityString( cap );
+
+        count += strings.size();
+        deps->insert( dep.inSwitch(), strings );
+    }
+
+    PkgDependencies result = *deps;
+    _dependencies.insert( obj.get(), deps, count + 1 );
+
+    return result;
+}
+
+
+QString
+PkgDetailsCache::capabilityString( const zypp::Capability & cap )
+{
+    checkGeneration();
+
+    auto it = _capStrings.constFind( cap.id() );
+
+    if ( it != _capStrings.constEnd() )
+        return it.value();
+
+    if ( _capStrings.size() >= MAX_CACHED_CAP_STRINGS )
+        _capStrings.clear();
+
+    QString str = QString::fromUtf8( cap.asString().c_str() );
+    _capStrings.insert( cap.id(), str );
+
+    return str;
+}
+
+
+void
+PkgDetailsCache::prefetch( const QList<ZyppSel> & selectables )
+{
+    // The visible details views asked for their data since the last call;
+    // keep the previous kinds if they were all served from their HTML cache.
+
+    if ( _usedKinds )
+        _wantedKinds = _usedKinds;
+
+    _usedKinds = 0;
+    _queue     = selectables;
+
+    if ( _wantedKinds && ! _queue.isEmpty() )
+        _prefetchTimer.start();
+    else
+        _prefetchTimer.stop();
+}
+
+
+void
+PkgDetailsCache::prefetchNext()
+{
+    checkGeneration();
+
+    if ( _queue.isEmpty() )
+    {
+        _prefetchTimer.stop();
+        return;
+    }
+
+    // Only one selectable per timer tick
+
+    ZyppSel selectable = _queue.takeFirst();
+
+    if ( ! selectable )
+        return;
+
+    int usedKinds = _usedKinds; // Don't count prefetching as usage
+
+#if VERBOSE_DETAILS_CACHE
+    logVerbose() << "Prefetching details for " << selectable->name() << endl;
+#endif
+
+    ZyppPkg installed = tryCastToZyppPkg( selectable->installedObj() );
+
+    if ( installed && ( _wantedKinds & FileList ) )
+        fileList( installed );
+
+    if ( installed && ( _wantedKinds & ChangeLog ) )
+        changeLog( installed );
+
+    if ( _wantedKinds & Dependencies )
+    {
+        allDependencies( selectable->candidateObj() );
+        allDependencies( selectable->installedObj() );
+    }
+
+    _usedKinds = usedKinds;
+}
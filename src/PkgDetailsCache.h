@@ -0,0 +1,149 @@
+/*  ---------------------------------------------------------
+               __  __            _
+              |  \/  |_   _ _ __| |_   _ _ __
+              | |\/| | | | | '__| | | | | '_ \
+              | |  | | |_| | |  | | |_| | | | |
+              |_|  |_|\__, |_|  |_|\__, |_| |_|
+                      |___/        |___/
+    ---------------------------------------------------------
+
+    Project:  Myrlyn Package Manager GUI
+    Copyright (c) Stefan Hundhammer <Stefan.Hundhammer@gmx.de>
+    License:  GPL V2 - See file LICENSE for details.
+
+    Textdomain "qt-pkg"
+ */
+
+
+#ifndef PkgDetailsCache_h
+#define PkgDetailsCache_h
+
+#include <list>
+#include <string>
+
+#include <QCache>
+#include <QHash>
+#include <QList>
+#include <QObject>
+#include <QStringList>
+#include <QTimer>
+
+#include <zypp/Capability.h>
+#include <zypp/Changelog.h>
+#include <zypp/Dep.h>
+
+#include "YQZypp.h"
+
+
+/**
+ * Bounded cache for the expensive data of the details views: File lists
+ * and change logs (which are read from the rpmdb) and the dependencies of
+ * packages as strings.
+ *
+ * When the current item of a package list changes, the list asks this cache
+ * to prefetch the data of the neighbouring items while the GUI is idle, so
+ * walking through a list with the keyboard will normally find warm data.
+ * Only the kinds of data that the visible details views actually asked for
+ * recently are prefetched.
+ *
+ * The cache is cleared when the pool content changes.
+ *
+ * This is a singleton; use instance().
+ **/
+class PkgDetailsCache: public QObject
+{
+    Q_OBJECT
+
+public:
+
+    enum Kind
+    {
+        FileList     = 0x01,
+        ChangeLog    = 0x02,
+        Dependencies = 0x04
+    };
+
+    /**
+     * Return the singleton instance of this class. Create it if it doesn't
+     * exist yet.
+     **/
+    static PkgDetailsCache * instance();
+
+    /**
+     * Return the file list of 'pkg'.
+     **/
+    std::list<std::string> fileList( ZyppPkg pkg );
+
+    /**
+     * Return the change log of 'pkg'.
+     **/
+    zypp::Changelog changeLog( ZyppPkg pkg );
+
+    /**
+     * Return the dependencies of kind 'dep' of 'obj' as strings.
+     **/
+    QStringList dependencies( ZyppObj obj, zypp::Dep dep );
+
+    /**
+     * Return 'cap' as a string. Capabilities are shared between many
+     * packages, so this caches the string for each capability.
+     **/
+    QString capabilityString( const zypp::Capability & cap );
+
+    /**
+     * Prefetch the data of 'selectables' in that order while the GUI is
+     * idle. This replaces any previous prefetch request.
+     **/
+    void prefetch( const QList<ZyppSel> & selectables );
+
+
+protected slots:
+
+    /**
+     * Prefetch the data of the next selectable in the queue.
+     **/
+    void prefetchNext();
+
+
+protected:
+
+    /**
+     * Constructor. Use instance() instead.
+     **/
+    PkgDetailsCache();
+
+    /**
+     * Destructor.
+     **/
+    virtual ~PkgDetailsCache();
+
+    /**
+     * Clear all caches if the pool content changed.
+     **/
+    void checkGeneration();
+
+    typedef QHash<int, QStringList> PkgDependencies;
+
+    /**
+     * Return all dependencies of 'obj', using the cache if possible.
+     **/
+    PkgDependencies allDependencies( ZyppObj obj );
+
+
+    // Data members
+
+    QCache<const zypp::ResObject *, std::list<std::string> > _fileLists;
+    QCache<const zypp::ResObject *, zypp::Changelog>          _changeLogs;
+    QCache<const zypp::ResObject *, PkgDependencies>          _dependencies;
+    QHash<int, QString>                                       _capStrings;
+    int _generation;
+
+    int _usedKinds;     // Kinds requested since the last prefetch()
+    int _wantedKinds;   // Kinds to prefetch
+
+    QList<ZyppSel> _queue;
+    QTimer         _prefetchTimer;
+};
+
+
+#endif // PkgDetailsCache_h
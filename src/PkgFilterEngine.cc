@@ -0,0 +1,251 @@
+/*  ---------------------------------------------------------
+               __  __            _
+              |  \/  |_   _ _ __| |_   _ _ __
+              | |\/| | | | | '__| | | | | '_ \
+              | |  | | |_| | |  | | |_| | | | |
+              |_|  |_|\__, |_|  |_|\__, |_| |_|
+                      |___/        |___/
+    ---------------------------------------------------------
+
+    Project:  Myrlyn Package Manager GUI
+    Copyright (c) Stefan Hundhammer <Stefan.Hundhammer@gmx.de>
+    License:  GPL V2 - See file LICENSE for details.
+
+    Textdomain "qt-pkg"
+ */
+
+
+#include <algorithm>
+
+#include "Exception.h"
+#include "Logger.h"
+#include "PoolGeneration.h"
+#include "SelectableIds.h"
+#include "PkgFilterEngine.h"
+
+
+// Compute a filter source only for the remaining candidates (and don't cache
+// the result) if less than 1/SPARSE_CANDIDATES_RATIO of the pool is left
+#define SPARSE_CANDIDATES_RATIO 4
+
+// Maximum number of cached filter results
+#define MAX_CACHE_SIZE          64
+
+#define VERBOSE_FILTER_ENGINE   0
+
+
+PkgFilterExpr
+PkgFilterExpr::makeAnd( const PkgFilterExpr & a, const PkgFilterExpr & b )
+{
+    PkgFilterExpr expr( And );
+    expr._operands.push_back( a );
+    expr._operands.push_back( b );
+
+    return expr;
+}
+
+
+PkgFilterExpr
+PkgFilterExpr::makeOr( const PkgFilterExpr & a, const PkgFilterExpr & b )
+{
+    PkgFilterExpr expr( Or );
+    expr._operands.push_back( a );
+    expr._operands.push_back( b );
+
+    return expr;
+}
+
+
+PkgFilterExpr
+PkgFilterExpr::makeNot( const PkgFilterExpr & a )
+{
+    PkgFilterExpr expr( Not );
+    expr._operands.push_back( a );
+
+    return expr;
+}
+
+
+int
+PkgFilterExpr::cost() const
+{
+    switch ( _op )
+    {
+        case All:
+            return 0;
+
+        case Source:
+            return _source->filterCost();
+
+        case And:
+        case Or:
+        case Not:
+            {
+                int sum = 0;
+
+                for ( const PkgFilterExpr & operand: _operands )
+                    sum += operand.cost();
+
+                return sum;
+            }
+    }
+
+    return 0;
+}
+
+
+
+
+PkgFilterEngine::PkgFilterEngine()
+    : _cacheGeneration( -1 )
+{
+}
+
+
+PkgFilterEngine *
+PkgFilterEngine::instance()
+{
+    static PkgFilterEngine * engine = 0;
+
+    if ( ! engine )
+    {
+        engine = new PkgFilterEngine();
+        CHECK_NEW( engine );
+    }
+
+    return engine;
+}
+
+
+void
+PkgFilterEngine::clearCache()
+{
+    _cache.clear();
+}
+
+
+PkgBitset
+PkgFilterEngine::evaluate( const PkgFilterExpr & expr )
+{
+    int generation = PoolGeneration::current();
+
+    if ( generation != _cacheGeneration )
+    {
+        clearCache();
+        _cacheGeneration = generation;
+    }
+
+    return evaluate( expr, 0 );
+}
+
+
+PkgBitset
+PkgFilterEngine::evaluate( const PkgFilterExpr & expr,
+                           const PkgBitset *     candidates )
+{
+    int size = SelectableIds::count();
+
+    switch ( expr.op() )
+    {
+        case PkgFilterExpr::All:
+            return candidates ? *candidates : PkgBitset( size, true );
+
+        case PkgFilterExpr::Source:
+            return evaluateSource( expr.source(), candidates );
+
+        case PkgFilterExpr::And:
+            {
+                // Cheapest first: The more expensive operands then only need
+                // to check what is left.
+
+                std::vector<PkgFilterExpr> operands = expr.operands();
+
+                std::stable_sort( operands.begin(), operands.end(),
+                                  []( const PkgFilterExpr & a, const PkgFilterExpr & b )
+                                  {
+                                      return a.cost() < b.cost();
+                                  } );
+
+                PkgBitset result = candidates ? *candidates : PkgBitset( size, true );
+
+                for ( const PkgFilterExpr & operand: operands )
+                {
+                    if ( result.isEmpty() )
+                        break;
+
+                    result &= evaluate( operand, &result );
+                }
+
+                return result;
+            }
+
+        case PkgFilterExpr::Or:
+            {
+                PkgBitset result( size );
+
+                for ( const PkgFilterExpr & operand: expr.operands() )
+                    result |= evaluate( operand, candidates );
+
+                return result;
+            }
+
+        case PkgFilterExpr::Not:
+            {
+                // Bits outside of 'candidates' are undefined in the operand
+                // result, so mask them out again after inverting.
+
+                PkgBitset result = evaluate( expr.operands().front(), candidates );
+                result.flip();
+
+                if ( candidates )
+                    result &= *candidates;
+
+                return result;
+            }
+    }
+
+    return PkgBitset( size );
+}
+
+
+PkgBitset
+PkgFilterEngine::evaluateSource( PkgFilterSource * source,
+                                 const PkgBitset * candidates )
+{
+    int       size = SelectableIds::count();
+    QString   key  = source->filterKey();
+    PkgBitset result( size );
+
+    if ( _cache.contains( key ) )
+    {
+#if VERBOSE_FILTER_ENGINE
+        logVerbose() << "Cache hit for " << key << endl;
+#endif
+        result = _cache.value( key );
+    }
+    else if ( candidates && candidates->count() < size / SPARSE_CANDIDATES_RATIO )
+    {
+        // Only a few candidates left: Checking them is cheaper than a full
+        // scan, but the result is incomplete, so it can't be cached.
+
+        source->filterBits( result, candidates );
+    }
+    else
+    {
+        source->filterBits( result, 0 );
+
+        if ( _cache.size() >= MAX_CACHE_SIZE )
+            _cache.clear();
+
+        _cache.insert( key, result );
+
+#if VERBOSE_FILTER_ENGINE
+        logVerbose() << "Cached " << result.count() << " matches for " << key << endl;
+#endif
+    }
+
+    if ( candidates )
+        result &= *candidates;
+
+    return result;
+}
@@ -0,0 +1,181 @@
+/*  ---------------------------------------------------------
+               __  __            _
+              |  \/  |_   _ _ __| |_   _ _ __
+              | |\/| | | | | '__| | | | | '_ \
+              | |  | | |_| | |  | | |_| | | | |
+              |_|  |_|\__, |_|  |_|\__, |_| |_|
+                      |___/        |___/
+    ---------------------------------------------------------
+
+    Project:  Myrlyn Package Manager GUI
+    Copyright (c) Stefan Hundhammer <Stefan.Hundhammer@gmx.de>
+    License:  GPL V2 - See file LICENSE for details.
+
+    Textdomain "qt-pkg"
+ */
+
+
+#ifndef PkgFilterEngine_h
+#define PkgFilterEngine_h
+
+#include <vector>
+
+#include <QHash>
+#include <QString>
+
+#include "PkgBitset.h"
+#include "YQZypp.h"
+
+
+/**
+ * Interface for anything that can compute the set of package selectables
+ * that match its current filter criteria as a PkgBitset.
+ **/
+class PkgFilterSource
+{
+public:
+
+    virtual ~PkgFilterSource() {}
+
+    /**
+     * Return a key that identifies this filter with its current criteria,
+     * e.g. "repo:" plus the selected repo aliases. Two calls with the same
+     * key in the same pool generation need to return the same set: The
+     * engine caches results by this key.
+     **/
+    virtual QString filterKey() const = 0;
+
+    /**
+     * Return the relative cost of checking one package. A lookup in the
+     * solv data is about 1, matching a regexp against the description
+     * about 100.
+     **/
+    virtual int filterCost() const = 0;
+
+    /**
+     * Set the bits of all matching package selectables in 'result', which
+     * is initially empty and has the size SelectableIds::count().
+     *
+     * If 'candidates' is non-null, only those IDs need to be checked; the
+     * bits of all others may be left unset.
+     **/
+    virtual void filterBits( PkgBitset &       result,
+                             const PkgBitset * candidates ) = 0;
+};
+
+
+/**
+ * Expression combining filter sources with AND, OR and NOT.
+ **/
+class PkgFilterExpr
+{
+public:
+
+    enum Op
+    {
+        All,        // Matches every package
+        Source,     // Matches what the filter source matches
+        And,
+        Or,
+        Not
+    };
+
+    /**
+     * Constructor: Create an expression that matches everything.
+     **/
+    PkgFilterExpr()
+        : _op( All )
+        , _source( 0 )
+        {}
+
+    /**
+     * Constructor: Create an expression that matches what 'source' matches.
+     * If 'source' is 0, this matches everything.
+     **/
+    PkgFilterExpr( PkgFilterSource * source )
+        : _op( source ? Source : All )
+        , _source( source )
+        {}
+
+    static PkgFilterExpr makeAnd( const PkgFilterExpr & a, const PkgFilterExpr & b );
+    static PkgFilterExpr makeOr ( const PkgFilterExpr & a, const PkgFilterExpr & b );
+    static PkgFilterExpr makeNot( const PkgFilterExpr & a );
+
+    Op                                 op()       const { return _op;       }
+    PkgFilterSource *                  source()   const { return _source;   }
+    const std::vector<PkgFilterExpr> & operands() const { return _operands; }
+
+    /**
+     * Return the estimated cost of evaluating this expression.
+     **/
+    int cost() const;
+
+protected:
+
+    PkgFilterExpr( Op op )
+        : _op( op )
+        , _source( 0 )
+        {}
+
+    Op                         _op;
+    PkgFilterSource *          _source;
+    std::vector<PkgFilterExpr> _operands;
+};
+
+
+/**
+ * Engine to evaluate filter expressions to sets of package selectables.
+ *
+ * The operands of an AND are evaluated cheapest first, and the more
+ * expensive ones only need to check what is left from the cheaper ones.
+ * The complete results of each filter source are cached by their
+ * filterKey() until the pool generation changes.
+ **/
+class PkgFilterEngine
+{
+public:
+
+    /**
+     * Return the singleton of this class. Create it if it doesn't exist
+     * yet.
+     **/
+    static PkgFilterEngine * instance();
+
+    /**
+     * Evaluate 'expr' and return the set of matching package selectables.
+     **/
+    PkgBitset evaluate( const PkgFilterExpr & expr );
+
+    /**
+     * Drop all cached results.
+     **/
+    void clearCache();
+
+
+protected:
+
+    /**
+     * Constructor. Use instance() instead.
+     **/
+    PkgFilterEngine();
+
+    /**
+     * Evaluate 'expr' where only the IDs in 'candidates' (if non-null) are
+     * relevant.
+     **/
+    PkgBitset evaluate( const PkgFilterExpr & expr,
+                        const PkgBitset *     candidates );
+
+    /**
+     * Evaluate a filter source, using the cache if possible.
+     **/
+    PkgBitset evaluateSource( PkgFilterSource * source,
+                              const PkgBitset * candidates );
+
+
+    QHash<QString, PkgBitset> _cache;
+    int                       _cacheGeneration;
+};
+
+
+#endif // PkgFilterEngine_h
@@ -0,0 +1,345 @@
+/*  ---------------------------------------------------------
+               __  __            _
+              |  \/  |_   _ _ __| |_   _ _ __
+              | |\/| | | | | '__| | | | | '_ \
+              | |  | | |_| | |  | | |_| | | | |
+              |_|  |_|\__, |_|  |_|\__, |_| |_|
+                      |___/        |___/
+    ---------------------------------------------------------
+
+    Project:  Myrlyn Package Manager GUI
+    Copyright (c) Stefan Hundhammer <Stefan.Hundhammer@gmx.de>
+    License:  GPL V2 - See file LICENSE for details.
+
+    Textdomain "qt-pkg"
+ */
+
+
+#include <algorithm>
+
+#include <QElapsedTimer>
+
+#include "Exception.h"
+#include "Logger.h"
+#include "PkgIndexFile.h"
+#include "PoolGeneration.h"
+#include "SelectableIds.h"
+#include "PkgIndex.h"
+
+
+PkgIndex::PkgIndex()
+    : _contentGeneration( -1 )
+    , _generation( -1 )
+    , _fileChecked( false )
+{
+}
+
+
+PkgIndex *
+PkgIndex::instance()
+{
+    static PkgIndex * index = 0;
+
+    if ( ! index )
+    {
+        index = new PkgIndex();
+        CHECK_NEW( index );
+    }
+
+    return index;
+}
+
+
+void
+PkgIndex::update()
+{
+    int contentGeneration = PoolGeneration::contentGeneration();
+    int generation        = PoolGeneration::current();
+
+    if ( contentGeneration != _contentGeneration )
+    {
+        // Only the first index of this process can use the index file:
+        // Later, the user may have changed the status of packages.
+
+        bool firstBuild = ! _fileChecked;
+        _fileChecked = true;
+
+        if ( firstBuild && PkgIndexFile::load( this ) )
+        {
+            _contentGeneration = contentGeneration;
+            _generation        = generation;
+
+            return;
+        }
+
+        updateContent();
+        _contentGeneration = contentGeneration;
+
+        if ( firstBuild && ! _status.empty() )
+        {
+            updateStatus();
+            _generation = generation;
+
+            PkgIndexFile::save( this );
+        }
+    }
+
+    if ( generation != _generation )
+    {
+        updateStatus();
+        _generation = generation;
+    }
+}
+
+
+int
+PkgIndex::size()
+{
+    update();
+
+    return (int) _status.size();
+}
+
+
+void
+PkgIndex::updateContent()
+{
+    QElapsedTimer timer;
+    timer.start();
+
+    int count = SelectableIds::count();
+
+    _nameIds.assign( count, 0 );
+    _status.assign ( count, (uint8_t) S_NoInst );
+    _flags.assign  ( count, 0 );
+    _repoIds.assign( count, -1 );
+    _installSizes.assign ( count, 0 );
+    _downloadSizes.assign( count, 0 );
+    _repoAliases.clear();
+    _repoIndex.clear();
+
+    for ( int id = 0; id < count; ++id )
+    {
+        ZyppSel selectable = SelectableIds::selectable( id );
+        Flags   flags      = 0;
+
+        if ( selectable->hasRetracted() )           flags |= Retracted;
+        if ( selectable->hasRetractedInstalled() )  flags |= RetractedInstalled;
+        if ( selectable->multiversionInstall() )    flags |= Multiversion;
+
+        _nameIds[ id ] = selectable->ident().id();
+        _flags  [ id ] = flags;
+    }
+
+    // Force updating the rest
+
+    _generation = -1;
+
+    logDebug() << "Indexed " << count << " packages in "
+               << timer.elapsed() << " millisec" << endl;
+}
+
+
+void
+PkgIndex::updateStatus()
+{
+    QElapsedTimer timer;
+    timer.start();
+
+    int count = (int) _status.size();
+
+    for ( int id = 0; id < count; ++id )
+        updateStatus( id );
+
+    logDebug() << "Updated package index status in "
+               << timer.elapsed() << " millisec" << endl;
+}
+
+
+void
+PkgIndex::updateStatus( int id )
+{
+    const Flags contentFlags = Retracted | RetractedInstalled | Multiversion;
+
+    ZyppSel    selectable = SelectableIds::selectable( id );
+    ZyppObj    installed  = selectable->installedObj();
+    ZyppObj    candidate  = selectable->candidateObj();
+    ZyppStatus status     = selectable->status();
+    Flags      flags      = _flags[ id ] & contentFlags;
+
+    if ( installed ) flags |= Installed;
+    if ( candidate ) flags |= HasCandidate;
+
+    if ( installed && candidate && installed->edition() < candidate->edition() )
+        flags |= UpdateAvailable;
+
+    if ( status == S_Taboo || status == S_Protected )
+        flags |= Locked;
+
+    ZyppObj obj = candidate ? candidate : installed;
+
+    _status [ id ] = (uint8_t) status;
+    _flags  [ id ] = flags;
+    _repoIds[ id ] = obj ? repoIndex( obj->repository().alias() ) : -1;
+    _installSizes [ id ] = obj ? (long long) obj->installSize()  : 0;
+    _downloadSizes[ id ] = obj ? (long long) obj->downloadSize() : 0;
+}
+
+
+void
+PkgIndex::statusChanged( ZyppSel selectable )
+{
+    int generation = PoolGeneration::current();
+
+    // Only if the index was up to date right before the invalidate() for
+    // this change (or for an earlier selectable of the same batch);
+    // otherwise there are more changes, and the next update() needs to do
+    // the full pass anyway.
+
+    if ( _contentGeneration != PoolGeneration::contentGeneration() ||
+         ( _generation != generation - 1 && _generation != generation ) )
+    {
+        return;
+    }
+
+    int id = SelectableIds::id( selectable );
+
+    // Not a package (e.g. a pattern): Nothing in the index changed
+
+    if ( id >= 0 )
+        updateStatus( id );
+
+    _generation = generation;
+}
+
+
+bool
+PkgIndex::setStatus( ZyppSel selectable, ZyppStatus newStatus )
+{
+    ZyppStatus oldStatus = selectable->status();
+    selectable->setStatus( newStatus );
+
+    if ( selectable->status() == oldStatus )
+        return false;
+
+    PoolGeneration::invalidate();
+    instance()->statusChanged( selectable );
+
+    return true;
+}
+
+
+int
+PkgIndex::repoIndex( const std::string & alias )
+{
+    auto it = _repoIndex.find( alias );
+
+    if ( it != _repoIndex.end() )
+        return it->second;
+
+    int index = (int) _repoAliases.size();
+    _repoAliases.push_back( alias );
+    _repoIndex[ alias ] = index;
+
+    return index;
+}
+
+
+std::string
+PkgIndex::repoAlias( int repoId ) const
+{
+    if ( repoId < 0 || repoId >= (int) _repoAliases.size() )
+        return std::string();
+
+    return _repoAliases[ repoId ];
+}
+
+
+PkgIndex::StatusMask
+PkgIndex::toModifyMask()
+{
+    return
+        statusBit( S_Install     ) |
+        statusBit( S_Update      ) |
+        statusBit( S_Del         ) |
+        statusBit( S_AutoInstall ) |
+        statusBit( S_AutoUpdate  ) |
+        statusBit( S_AutoDel     );
+}
+
+
+PkgBitset
+PkgIndex::withFlags( Flags allOf, Flags noneOf )
+{
+    update();
+
+    int       count = (int) _flags.size();
+    PkgBitset result( count );
+    const Flags * flags = _flags.data();
+
+    // Build each word of the result in a register: no branches, and the
+    // inner loop over consecutive bytes is easy to vectorize.
+
+    for ( int wordIndex = 0; wordIndex < result.wordCount(); ++wordIndex )
+    {
+        int base = wordIndex * PkgBitset::WORD_BITS;
+        int end  = std::min( base + (int) PkgBitset::WORD_BITS, count );
+        PkgBitset::Word word = 0;
+
+        for ( int id = base; id < end; ++id )
+        {
+            bool match = ( flags[ id ] & allOf ) == allOf && ! ( flags[ id ] & noneOf );
+            word |= PkgBitset::Word( match ) << ( id - base );
+        }
+
+        result.setWord( wordIndex, word );
+    }
+
+    return result;
+}
+
+
+PkgBitset
+PkgIndex::withStatus( StatusMask mask )
+{
+    update();
+
+    int       count = (int) _status.size();
+    PkgBitset result( count );
+    const uint8_t * status = _status.data();
+
+    for ( int wordIndex = 0; wordIndex < result.wordCount(); ++wordIndex )
+    {
+        int base = wordIndex * PkgBitset::WORD_BITS;
+        int end  = std::min( base + (int) PkgBitset::WORD_BITS, count );
+        PkgBitset::Word word = 0;
+
+        for ( int id = base; id < end; ++id )
+            word |= PkgBitset::Word( ( mask >> status[ id ] ) & 1 ) << ( id - base );
+
+        result.setWord( wordIndex, word );
+    }
+
+    return result;
+}
+
+
+int
+PkgIndex::countFlags( Flags allOf )
+{
+    return withFlags( allOf ).count();
+}
+
+
+long long
+PkgIndex::totalDownloadSize( const PkgBitset & bits )
+{
+    update();
+
+    long long sum = 0;
+
+    for ( int id = bits.next( 0 ); id >= 0; id = bits.next( id + 1 ) )
+        sum += _downloadSizes[ id ];
+
+    return sum;
+}
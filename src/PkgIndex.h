@@ -0,0 +1,220 @@
+/*  ---------------------------------------------------------
+               __  __            _
+              |  \/  |_   _ _ __| |_   _ _ __
+              | |\/| | | | | '__| | | | | '_ \
+              | |  | | |_| | |  | | |_| | | | |
+              |_|  |_|\__, |_|  |_|\__, |_| |_|
+                      |___/        |___/
+    ---------------------------------------------------------
+
+    Project:  Myrlyn Package Manager GUI
+    Copyright (c) Stefan Hundhammer <Stefan.Hundhammer@gmx.de>
+    License:  GPL V2 - See file LICENSE for details.
+
+    Textdomain "qt-pkg"
+ */
+
+
+#ifndef PkgIndex_h
+#define PkgIndex_h
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "PkgBitset.h"
+#include "YQZypp.h"
+
+
+/**
+ * Compact index of all package selectables in the pool for fast full-pool
+ * scans, stored as parallel arrays indexed by the SelectableIds.
+ *
+ * Iterating over the pool with zyppPkgBegin() / zyppPkgEnd() goes through
+ * shared pointers and virtual methods for each selectable; that is slow
+ * with 100k packages. The predicates of this class are tight loops over a
+ * few bytes per package instead.
+ *
+ * The predicates run in the calling thread: A scan over 100k packages
+ * takes about 0.1 millisec, so worker threads would cost more than they
+ * save.
+ *
+ * The index is updated automatically: The parts that depend only on the
+ * pool content (names, retracted, multiversion) when the pool content
+ * changes, everything else when the pool generation changes, i.e. after
+ * any status change (see PoolGeneration). For a status change of a single
+ * package, statusChanged() updates only the entry of that package, so the
+ * full pass is only needed after solver runs and resets.
+ *
+ * The first time, the index is loaded from a file if there is one that
+ * matches the pool; otherwise it is built and saved for the next start
+ * (see PkgIndexFile).
+ **/
+class PkgIndex
+{
+    friend class PkgIndexFile;
+
+public:
+
+    enum Flag
+    {
+        Installed          = 0x01,
+        HasCandidate       = 0x02,
+        UpdateAvailable    = 0x04,      // Candidate newer than installed
+        Retracted          = 0x08,      // Any retracted version
+        RetractedInstalled = 0x10,      // Retracted version installed
+        Multiversion       = 0x20,
+        Locked             = 0x40       // S_Taboo or S_Protected
+    };
+
+    typedef uint8_t  Flags;
+    typedef uint16_t StatusMask;        // One bit for each ZyppStatus
+
+
+    /**
+     * Return the singleton of this class. Create it if it doesn't exist
+     * yet.
+     **/
+    static PkgIndex * instance();
+
+    /**
+     * Bring the index up to date with the pool if necessary. All other
+     * methods do that automatically; call this only to control when the
+     * work is done, e.g. right after loading the repos.
+     **/
+    void update();
+
+    /**
+     * Update only the entry of 'selectable'. Call this right after the
+     * PoolGeneration::invalidate() for a status change of that selectable
+     * (or of each selectable of a batch) to avoid a full pass over the pool
+     * with the next update(). If anything else changed since the index was
+     * last up to date, this does nothing, and the next update() does the
+     * full pass.
+     *
+     * Prefer setStatus() which does all that.
+     **/
+    void statusChanged( ZyppSel selectable );
+
+    /**
+     * Set the status of 'selectable' and keep the pool generation and the
+     * index up to date. Use this instead of selectable->setStatus() for a
+     * user status change; otherwise the filter views and the changes
+     * dialog don't see it.
+     *
+     * Return 'true' if the status actually changed.
+     **/
+    static bool setStatus( ZyppSel selectable, ZyppStatus newStatus );
+
+    /**
+     * Return the number of package selectables in the index.
+     **/
+    int size();
+
+    //
+    // Per-package data
+    //
+
+    int        nameId      ( int id ) { update(); return _nameIds     [ id ]; }
+    ZyppStatus status      ( int id ) { update(); return (ZyppStatus) _status[ id ]; }
+    Flags      flags       ( int id ) { update(); return _flags       [ id ]; }
+    int        repoId      ( int id ) { update(); return _repoIds     [ id ]; }
+    long long  installSize ( int id ) { update(); return _installSizes[ id ]; }
+    long long  downloadSize( int id ) { update(); return _downloadSizes[ id ]; }
+
+    /**
+     * Return the alias of the repo with index 'repoId' as returned by
+     * repoId(). This is the repo of the candidate or, if there is none, of
+     * the installed object.
+     **/
+    std::string repoAlias( int repoId ) const;
+
+    /**
+     * Return the status mask bit for 'status'.
+     **/
+    static StatusMask statusBit( ZyppStatus status )
+        { return StatusMask( 1 ) << (int) status; }
+
+    /**
+     * Return a status mask for all states that mean "some change is
+     * pending for this package".
+     **/
+    static StatusMask toModifyMask();
+
+    //
+    // Full-pool predicates
+    //
+
+    /**
+     * Return the set of packages with all flags in 'allOf' and none of the
+     * flags in 'noneOf'.
+     **/
+    PkgBitset withFlags( Flags allOf, Flags noneOf = 0 );
+
+    /**
+     * Return the set of packages with a status in 'mask'.
+     **/
+    PkgBitset withStatus( StatusMask mask );
+
+    /**
+     * Return the number of packages with all flags in 'allOf'.
+     **/
+    int countFlags( Flags allOf );
+
+    /**
+     * Return the total download size of the packages in 'bits'.
+     **/
+    long long totalDownloadSize( const PkgBitset & bits );
+
+
+protected:
+
+    /**
+     * Constructor. Use instance() instead.
+     **/
+    PkgIndex();
+
+    /**
+     * Rebuild the parts that depend only on the pool content.
+     **/
+    void updateContent();
+
+    /**
+     * Rebuild the parts that depend on the status of the packages.
+     **/
+    void updateStatus();
+
+    /**
+     * Update the status-dependent parts of the entry with ID 'id'.
+     **/
+    void updateStatus( int id );
+
+    /**
+     * Return the index of the repo with alias 'alias' in _repoAliases;
+     * add it if it's not there yet.
+     **/
+    int repoIndex( const std::string & alias );
+
+
+    //
+    // Data members
+    //
+
+    int                      _contentGeneration;
+    int                      _generation;
+    bool                     _fileChecked;
+
+    std::vector<int>         _nameIds;
+    std::vector<uint8_t>     _status;
+    std::vector<Flags>       _flags;
+    std::vector<int>         _repoIds;
+    std::vector<long long>   _installSizes;
+    std::vector<long long>   _downloadSizes;
+
+    std::vector<std::string> _repoAliases;
+    std::unordered_map<std::string, int> _repoIndex;
+};
+
+
+#endif // PkgIndex_h
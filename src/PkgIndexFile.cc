@@ -0,0 +1,391 @@
+/*  ---------------------------------------------------------
+               __  __            _
+              |  \/  |_   _ _ __| |_   _ _ __
+              | |\/| | | | | '__| | | | | '_ \
+              | |  | | |_| | |  | | |_| | | | |
+              |_|  |_|\__, |_|  |_|\__, |_| |_|
+                      |___/        |___/
+    ---------------------------------------------------------
+
+    Project:  Myrlyn Package Manager GUI
+    Copyright (c) Stefan Hundhammer <Stefan.Hundhammer@gmx.de>
+    License:  GPL V2 - See file LICENSE for details.
+
+    Textdomain "qt-pkg"
+ */
+
+
+
+
+#include <cstring>              // memcpy()
+#include <stdlib.h>             // getenv()
+#include <thread>
+
+#include <QCryptographicHash>
+#include <QDir>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QFileInfo>
+#include <QStandardPaths>
+
+#include <zypp/RepoManager.h>
+#include <zypp/Repository.h>
+#include <zypp/ZConfig.h>
+#include <zypp/sat/Pool.h>
+
+#include "Logger.h"
+#include "PkgIndex.h"
+#include "SelectableIds.h"
+#include "utf8.h"
+#include "PkgIndexFile.h"
+
+
+#define INDEX_FILE_NAME         "myrlyn-pkg-index"
+#define INDEX_FILE_MAGIC        0x4d595049      // "MYPI"
+#define INDEX_FILE_VERSION      2
+
+#define KEY_SIZE                20              // SHA1
+
+
+// File layout: The header, then the arrays in this order, each one with
+// 'count' elements:
+//
+//   int64  installSizes
+//   int64  downloadSizes
+//   int32  repoIds
+//   uint8  status
+//   uint8  flags
+//
+// then the repo aliases, each one terminated with a 0 byte.
+//
+// Everything is in native byte order: The file is never used on another
+// machine, and a mismatch would fail the magic check.
+
+struct PkgIndexFileHeader
+{
+    uint32_t magic;
+    uint32_t version;
+    uint8_t  key[ KEY_SIZE ];
+    uint32_t count;
+    uint32_t repoCount;
+    uint32_t aliasesSize;
+    uint64_t namesHash;
+};
+
+static_assert( sizeof( PkgIndexFileHeader ) == 48, "Bad PkgIndexFileHeader layout" );
+
+
+/**
+ * Return a hash over the names of all package selectables in SelectableIds
+ * order. If 'nameIds' is non-null, also fill it with the name IDs.
+ **/
+static uint64_t
+namesHash( std::vector<int> * nameIds = 0 )
+{
+    // FNV-1a: good enough to detect a different pool order
+
+    uint64_t hash  = 14695981039346656037ULL;
+    int      count = SelectableIds::count();
+
+    if ( nameIds )
+        nameIds->assign( count, 0 );
+
+    for ( int id = 0; id < count; ++id )
+    {
+        zypp::IdString ident = SelectableIds::selectable( id )->ident();
+
+        if ( nameIds )
+            (*nameIds)[ id ] = ident.id();
+
+        for ( const char * str = ident.c_str(); *str; ++str )
+        {
+            hash ^= (uint8_t) *str;
+            hash *= 1099511628211ULL;
+        }
+
+        hash ^= 0xff; // Separator
+        hash *= 1099511628211ULL;
+    }
+
+    return hash;
+}
+
+
+static qint64
+mtime( const QString & path )
+{
+    QFileInfo fileInfo( path );
+
+    return fileInfo.exists() ? fileInfo.lastModified().toMSecsSinceEpoch() : 0;
+}
+
+
+QByteArray
+PkgIndexFile::poolKey()
+{
+    QCryptographicHash hash( QCryptographicHash::Sha1 );
+    QString solvCacheDir = fromUTF8( zypp::RepoManagerOptions().repoSolvCachePath.asString() );
+
+    hash.addData( QByteArray::number( INDEX_FILE_VERSION ) );
+
+    for ( zypp::Repository repo: zypp::sat::Pool::instance().repos() )
+    {
+        // The cookie of a repo changes with its metadata; the one of the
+        // @System repo with the rpmdb.
+
+        std::string dir = repo.isSystemRepo() ? repo.alias() : repo.info().escaped_alias();
+        QFile cookie( solvCacheDir + "/" + fromUTF8( dir ) + "/cookie" );
+
+        hash.addData( repo.alias().c_str() );
+        hash.addData( "\n" );
+
+        // The priority changes the order of the available versions and
+        // thus the candidates
+
+        if ( ! repo.isSystemRepo() )
+            hash.addData( QByteArray::number( repo.info().priority() ) + "\n" );
+
+        if ( cookie.open( QIODevice::ReadOnly ) )
+            hash.addData( cookie.readAll() );
+        else
+            hash.addData( QByteArray::number( (qlonglong) repo.generatedTimestamp() ) );
+
+        hash.addData( "\n" );
+    }
+
+    // Locks are part of the status
+
+    QString locksFile = fromUTF8( zypp::ZConfig::instance().locksFile().asString() );
+    hash.addData( QByteArray::number( mtime( locksFile ) ) + "\n" );
+
+    // zypp.conf has the multiversion settings, the default arch and more.
+    // libzypp reads it from $ZYPP_CONF if that is set.
+
+    const char * zyppConf = getenv( "ZYPP_CONF" );
+    hash.addData( QByteArray::number( mtime( zyppConf ? zyppConf : "/etc/zypp/zypp.conf" ) ) );
+
+    return hash.result();
+}
+
+
+QStringList
+PkgIndexFile::fileNames()
+{
+    QString solvCacheDir = fromUTF8( zypp::RepoManagerOptions().repoSolvCachePath.asString() );
+    QString userCacheDir = QStandardPaths::writableLocation( QStandardPaths::CacheLocation );
+    QStringList names;
+
+    // A file written by root next to the solv cache is just as good for a
+    // user as their own one.
+
+    names << writableFileName()
+          << solvCacheDir + "/" + INDEX_FILE_NAME
+          << userCacheDir + "/" + INDEX_FILE_NAME;
+
+    names.removeDuplicates();
+
+    return names;
+}
+
+
+QString
+PkgIndexFile::writableFileName()
+{
+    QString solvCacheDir = fromUTF8( zypp::RepoManagerOptions().repoSolvCachePath.asString() );
+
+    if ( QFileInfo( solvCacheDir ).isWritable() )
+        return solvCacheDir + "/" + INDEX_FILE_NAME;
+
+    QString userCacheDir = QStandardPaths::writableLocation( QStandardPaths::CacheLocation );
+
+    return userCacheDir + "/" + INDEX_FILE_NAME;
+}
+
+
+bool
+PkgIndexFile::load( PkgIndex * index )
+{
+    QElapsedTimer timer;
+    timer.start();
+
+    QByteArray key = poolKey();
+
+    for ( const QString & fileName: fileNames() )
+    {
+        if ( loadFile( fileName, key, index ) )
+        {
+            logInfo() << "Loaded the package index from " << fileName
+                      << " in " << timer.elapsed() << " millisec" << endl;
+
+            return true;
+        }
+    }
+
+    return false;
+}
+
+
+bool
+PkgIndexFile::loadFile( const QString &    fileName,
+                        const QByteArray & key,
+                        PkgIndex *         index )
+{
+    QFile file( fileName );
+
+    if ( ! file.open( QIODevice::ReadOnly ) )
+        return false;
+
+    qint64 fileSize = file.size();
+
+    if ( fileSize < (qint64) sizeof( PkgIndexFileHeader ) )
+        return false;
+
+    const uchar * data = file.map( 0, fileSize );
+
+    if ( ! data )
+    {
+        logWarning() << "Can't map " << fileName << endl;
+        return false;
+    }
+
+    PkgIndexFileHeader header;
+    memcpy( &header, data, sizeof( header ) );
+
+    if ( header.magic != INDEX_FILE_MAGIC || header.version != INDEX_FILE_VERSION )
+    {
+        logInfo() << "Ignoring package index " << fileName << " with a different version" << endl;
+        return false;
+    }
+
+    if ( memcmp( header.key, key.constData(), KEY_SIZE ) != 0 )
+    {
+        logInfo() << "Package index " << fileName << " is stale" << endl;
+        return false;
+    }
+
+    qint64 count = header.count;
+    qint64 expectedSize = sizeof( PkgIndexFileHeader )
+        + count * ( 2 * sizeof( int64_t ) + sizeof( int32_t ) + 2 * sizeof( uint8_t ) )
+        + header.aliasesSize;
+
+    if ( fileSize != expectedSize || count != SelectableIds::count() )
+    {
+        logWarning() << "Package index " << fileName << " doesn't match the pool" << endl;
+        return false;
+    }
+
+    std::vector<int> nameIds;
+
+    if ( namesHash( &nameIds ) != header.namesHash )
+    {
+        logWarning() << "Package index " << fileName << " has different packages" << endl;
+        return false;
+    }
+
+    const uchar * pos = data + sizeof( PkgIndexFileHeader );
+
+    // Copy the arrays: The index keeps them in std::vectors, and the status
+    // part is updated in place after any status change.
+
+    index->_installSizes.resize ( count );
+    index->_downloadSizes.resize( count );
+    index->_repoIds.resize      ( count );
+    index->_status.resize       ( count );
+    index->_flags.resize        ( count );
+
+    memcpy( index->_installSizes.data(),  pos, count * sizeof( int64_t ) ); pos += count * sizeof( int64_t );
+    memcpy( index->_downloadSizes.data(), pos, count * sizeof( int64_t ) ); pos += count * sizeof( int64_t );
+    memcpy( index->_repoIds.data(),       pos, count * sizeof( int32_t ) ); pos += count * sizeof( int32_t );
+    memcpy( index->_status.data(),        pos, count );                     pos += count;
+    memcpy( index->_flags.data(),         pos, count );                     pos += count;
+
+    index->_nameIds.swap( nameIds );
+    index->_repoAliases.clear();
+    index->_repoIndex.clear();
+
+    const char * aliases    = (const char *) pos;
+    const char * aliasesEnd = aliases + header.aliasesSize;
+
+    while ( aliases < aliasesEnd )
+    {
+        std::string alias( aliases );
+        aliases += alias.size() + 1;
+
+        index->repoIndex( alias );
+    }
+
+    file.unmap( (uchar *) data );
+
+    return index->_repoAliases.size() == header.repoCount;
+}
+
+
+void
+PkgIndexFile::save( const PkgIndex * index )
+{
+    // Everything that needs zypp is done here in the GUI thread;
+    // the thread only gets the snapshot.
+
+    PkgIndexFileHeader header;
+    memset( &header, 0, sizeof( header ) );
+
+    QByteArray key = poolKey();
+
+    header.magic     = INDEX_FILE_MAGIC;
+    header.version   = INDEX_FILE_VERSION;
+    header.count     = (uint32_t) index->_status.size();
+    header.repoCount = (uint32_t) index->_repoAliases.size();
+    header.namesHash = namesHash();
+    memcpy( header.key, key.constData(), KEY_SIZE );
+
+    QByteArray aliases;
+
+    for ( const std::string & alias: index->_repoAliases )
+        aliases.append( alias.c_str(), (int) alias.size() + 1 );
+
+    header.aliasesSize = (uint32_t) aliases.size();
+
+    qint64 count = header.count;
+    QByteArray content;
+    content.reserve( sizeof( header ) + count * 22 + aliases.size() );
+
+    content.append( (const char *) &header, sizeof( header ) );
+    content.append( (const char *) index->_installSizes.data(),  count * sizeof( int64_t ) );
+    content.append( (const char *) index->_downloadSizes.data(), count * sizeof( int64_t ) );
+    content.append( (const char *) index->_repoIds.data(),       count * sizeof( int32_t ) );
+    content.append( (const char *) index->_status.data(),        count );
+    content.append( (const char *) index->_flags.data(),         count );
+    content.append( aliases );
+
+    QString fileName = writableFileName();
+    logInfo() << "Saving the package index to " << fileName << endl;
+
+    std::thread saveThread( [content, fileName]()
+        {
+            // Write a temp file and rename it, so a reader never sees a
+            // half-written file. No logging here: The logger is not
+            // thread-safe.
+
+            QDir().mkpath( QFileInfo( fileName ).absolutePath() );
+
+            QString tmpName = fileName + ".new";
+            QFile file( tmpName );
+
+            if ( ! file.open( QIODevice::WriteOnly | QIODevice::Truncate ) )
+                return;
+
+            bool ok = file.write( content ) == content.size();
+            file.close();
+
+            if ( ok )
+            {
+                QFile::remove( fileName );
+                ok = QFile::rename( tmpName, fileName );
+            }
+
+            if ( ! ok )
+                QFile::remove( tmpName );
+        } );
+
+    saveThread.detach();
+}
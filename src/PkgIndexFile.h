@@ -0,0 +1,103 @@
+/*  ---------------------------------------------------------
+               __  __            _
+              |  \/  |_   _ _ __| |_   _ _ __
+              | |\/| | | | | '__| | | | | '_ \
+              | |  | | |_| | |  | | |_| | | | |
+              |_|  |_|\__, |_|  |_|\__, |_| |_|
+                      |___/        |___/
+    ---------------------------------------------------------
+
+    Project:  Myrlyn Package Manager GUI
+    Copyright (c) Stefan Hundhammer <Stefan.Hundhammer@gmx.de>
+    License:  GPL V2 - See file LICENSE for details.
+
+    Textdomain "qt-pkg"
+ */
+
+
+
+
+#ifndef PkgIndexFile_h
+#define PkgIndexFile_h
+
+#include <QByteArray>
+#include <QString>
+#include <QStringList>
+
+
+class PkgIndex;
+
+
+/**
+ * Persistent copy of the PkgIndex for a fast start: Building the index
+ * needs a few zypp calls for each package selectable, and some of them
+ * (retracted, multiversion) are slow for a large pool. With unchanged repos
+ * and an unchanged rpmdb, the result is the same every time.
+ *
+ * The file is written next to the zypp solv cache if that directory is
+ * writable (i.e. when running as root), otherwise in the user's cache
+ * directory. It is memory-mapped for loading and only used if its key
+ * matches the current pool: The key is a hash over the aliases, priorities
+ * and solv cache cookies of all repos in the pool (including the rpmdb
+ * cookie of the @System repo) and the modification times of the zypp locks
+ * file and of zypp.conf. The package names are checked against the
+ * SelectableIds order, too.
+ *
+ * Writing a new file is done in a separate thread on a snapshot of the
+ * index. Building the index for a missing or stale file still needs the
+ * pool, so that is done right away in the GUI thread; it is no slower than
+ * without the file.
+ *
+ * This is a purely static class.
+ **/
+class PkgIndexFile
+{
+public:
+
+    /**
+     * Load 'index' from the first valid index file that matches the
+     * current pool. Return 'true' on success, 'false' if the index needs to
+     * be built from the pool.
+     **/
+    static bool load( PkgIndex * index );
+
+    /**
+     * Save a snapshot of 'index' to the index file in a separate thread.
+     * This should only be called when the status of the packages is the
+     * one right after loading the pool, without any user changes.
+     **/
+    static void save( const PkgIndex * index );
+
+
+protected:
+
+    /**
+     * Return the key for the current pool.
+     **/
+    static QByteArray poolKey();
+
+    /**
+     * Return the candidate file names for loading, the writable one first.
+     **/
+    static QStringList fileNames();
+
+    /**
+     * Return the file name for saving.
+     **/
+    static QString writableFileName();
+
+    /**
+     * Load 'index' from file 'fileName' if it is valid and matches 'key'.
+     **/
+    static bool loadFile( const QString &    fileName,
+                          const QByteArray & key,
+                          PkgIndex *         index );
+
+
+private:
+
+    PkgIndexFile() {}
+};
+
+
+#endif // PkgIndexFile_h
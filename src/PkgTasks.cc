@@ -19,6 +19,8 @@
 
 #include "Logger.h"
 #include "Exception.h"
+#include "PkgIndex.h"
+#include "SelectableIds.h"
 #include "utf8.h"
 #include "YQZypp.h"
 #include "PkgTasks.h"
@@ -301,11 +303,13 @@ void PkgTasks::initFromZypp()
 {
     clearAll();
 
-    for ( ZyppPoolIterator it = zyppPkgBegin();
-	  it != zyppPkgEnd();
-	  ++it )
+    // Only packages with a pending change can become tasks
+
+    PkgBitset toModify = PkgIndex::instance()->withStatus( PkgIndex::toModifyMask() );
+
+    for ( int id = toModify.next( 0 ); id >= 0; id = toModify.next( id + 1 ) )
     {
-	ZyppSel selectable = *it;
+	ZyppSel selectable = SelectableIds::selectable( id );
         CHECK_PTR( selectable );;
 
         PkgTaskAction    action = PkgNoAction;
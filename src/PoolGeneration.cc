@@ -0,0 +1,67 @@
+/*  ---------------------------------------------------------
+               __  __            _
+              |  \/  |_   _ _ __| |_   _ _ __
+              | |\/| | | | | '__| | | | | '_ \
+              | |  | | |_| | |  | | |_| | | | |
+              |_|  |_|\__, |_|  |_|\__, |_| |_|
+                      |___/        |___/
+    ---------------------------------------------------------
+
+    Project:  Myrlyn Package Manager GUI
+    Copyright (c) Stefan Hundhammer <Stefan.Hundhammer@gmx.de>
+    License:  GPL V2 - See file LICENSE for details.
+
+    Textdomain "qt-pkg"
+ */
+
+
+#include <zypp/ResPool.h>
+
+#include "PoolGeneration.h"
+
+
+int      PoolGeneration::_generation        = 0;
+int      PoolGeneration::_contentGeneration = 0;
+unsigned PoolGeneration::_lastPoolSerial    = 0;
+
+
+int
+PoolGeneration::current()
+{
+    checkPoolSerial();
+
+    return _generation;
+}
+
+
+int
+PoolGeneration::contentGeneration()
+{
+    checkPoolSerial();
+
+    return _contentGeneration;
+}
+
+
+void
+PoolGeneration::checkPoolSerial()
+{
+    unsigned poolSerial = zypp::ResPool::instance().serial().serial();
+
+    if ( poolSerial != _lastPoolSerial )
+    {
+        // The pool content changed behind our back
+        // (repos were loaded or unloaded)
+
+        _lastPoolSerial = poolSerial;
+        ++_generation;
+        ++_contentGeneration;
+    }
+}
+
+
+void
+PoolGeneration::invalidate()
+{
+    ++_generation;
+}
@@ -0,0 +1,84 @@
+/*  ---------------------------------------------------------
+               __  __            _
+              |  \/  |_   _ _ __| |_   _ _ __
+              | |\/| | | | | '__| | | | | '_ \
+              | |  | | |_| | |  | | |_| | | | |
+              |_|  |_|\__, |_|  |_|\__, |_| |_|
+                      |___/        |___/
+    ---------------------------------------------------------
+
+    Project:  Myrlyn Package Manager GUI
+    Copyright (c) Stefan Hundhammer <Stefan.Hundhammer@gmx.de>
+    License:  GPL V2 - See file LICENSE for details.
+
+    Textdomain "qt-pkg"
+ */
+
+
+#ifndef PoolGeneration_h
+#define PoolGeneration_h
+
+
+/**
+ * Generation counter for the zypp pool as seen by the Myrlyn side.
+ *
+ * Anything that caches results derived from the pool (filter results,
+ * package counts etc.) should remember the generation it was computed for
+ * and consider itself stale as soon as current() returns something else.
+ *
+ * The generation changes when the content of the pool changes (repos loaded
+ * or unloaded, target reloaded) and whenever invalidate() is called because
+ * the status of any resolvable was changed, either by the user or by the
+ * dependency solver.
+ *
+ * libzypp is not thread-safe, so such caches are filled in the GUI thread:
+ * Background work like prefetching or statistics is done in small slices
+ * from a timer to keep the GUI responsive, and anything that takes seconds
+ * (solver runs, repo probing) in worker processes.
+ *
+ * This is a purely static class.
+ **/
+class PoolGeneration
+{
+public:
+
+    /**
+     * Return the current pool generation.
+     *
+     * This also checks the serial number of the zypp pool, so changes of the
+     * pool content are noticed even if nobody called invalidate().
+     **/
+    static int current();
+
+    /**
+     * Start a new pool generation. Call this whenever the status of any
+     * resolvable in the pool changed.
+     **/
+    static void invalidate();
+
+    /**
+     * Return the current generation of the pool content. Unlike current(),
+     * this changes only when the set of resolvables in the pool changes, not
+     * when any status changes. Use this for data that depend only on which
+     * resolvables there are, e.g. IDs or names.
+     **/
+    static int contentGeneration();
+
+
+private:
+
+    PoolGeneration() {}
+
+    /**
+     * Check the serial number of the zypp pool and start a new generation
+     * and a new content generation if it changed.
+     **/
+    static void checkPoolSerial();
+
+    static int      _generation;
+    static int      _contentGeneration;
+    static unsigned _lastPoolSerial;
+};
+
+
+#endif // PoolGeneration_h
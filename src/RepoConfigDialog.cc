@@ -15,10 +15,13 @@
  */
 
 
+#include <QMessageBox>
+
 #include "Exception.h"
 #include "Logger.h"
 #include "MainWindow.h"
 #include "WindowSettings.h"
+#include "YQi18n.h"
 #include "utf8.h"
 #include "RepoEditDialog.h"
 #include "RepoConfigDialog.h"
@@ -173,6 +176,7 @@ void RepoConfigDialog::currentEdited()
 #endif
 
         currentItem->setRepoInfo( repoInfo );
+        addChangedRepo( repoInfo.alias() );
 
         emit currentStatusChanged();
     }
@@ -191,6 +195,9 @@ void RepoConfigDialog::addRepo()
         logDebug() << "User closed the repo edit dialog with 'OK'" << endl;
 
         ZyppRepoInfo repoInfo = dialog.repoInfo();
+
+        if ( repoInfo.alias().empty() )
+            repoInfo.setAlias( repoInfo.name() );
 #if 1
         logDebug() << "Result: "       << repoInfo.name()
                    << " URL: "         << repoInfo.url().asString()
@@ -199,6 +206,26 @@ void RepoConfigDialog::addRepo()
                    << " AutoRefresh: " << repoInfo.autorefresh()
                    << endl;
 #endif
+        try
+        {
+            _ui->repoTable->repoManager()->addRepository( repoInfo );
+
+            RepoTableItem * item = new RepoTableItem( _ui->repoTable, repoInfo );
+            CHECK_NEW( item );
+
+            _ui->repoTable->setCurrentItem( item );
+            addChangedRepo( repoInfo.alias() );
+        }
+        catch ( const zypp::Exception & exception )
+        {
+            logError() << "Adding repo " << repoInfo.name() << " failed: "
+                       << exception.asString() << endl;
+
+            QMessageBox::warning( this, _( "Error" ),
+                                  _( "Could not add repository %1:\n\n%2" )
+                                  .arg( fromUTF8( repoInfo.name() ) )
+                                  .arg( fromUTF8( exception.asUserString() ) ) );
+        }
     }
     else
     {
@@ -233,6 +260,22 @@ void RepoConfigDialog::editRepo()
                        << " AutoRefresh: " << repoInfo.autorefresh()
                        << endl;
 #endif
+            try
+            {
+                currentItem->setRepoInfo( repoInfo );
+                addChangedRepo( repoInfo.alias() );
+                updateCurrentData();
+            }
+            catch ( const zypp::Exception & exception )
+            {
+                logError() << "Changing repo " << repoInfo.name() << " failed: "
+                           << exception.asString() << endl;
+
+                QMessageBox::warning( this, _( "Error" ),
+                                      _( "Could not change repository %1:\n\n%2" )
+                                      .arg( fromUTF8( repoInfo.name() ) )
+                                      .arg( fromUTF8( exception.asUserString() ) ) );
+            }
         }
         else
         {
@@ -242,6 +285,15 @@ void RepoConfigDialog::editRepo()
 }
 
 
+void RepoConfigDialog::addChangedRepo( const std::string & alias )
+{
+    QString qAlias = fromUTF8( alias );
+
+    if ( ! _changedRepos.contains( qAlias ) )
+        _changedRepos << qAlias;
+}
+
+
 void RepoConfigDialog::deleteRepo()
 {
     logWarning() << "Not implemented yet" << endl;
@@ -19,6 +19,7 @@
 #define RepoConfigDialog_h
 
 #include <QDialog>
+#include <QStringList>
 
 
 // Generated with 'uic' from a Qt designer .ui form: repo-config.ui
@@ -52,6 +53,12 @@ public:
      **/
     virtual ~RepoConfigDialog();
 
+    /**
+     * Return the aliases of the repos that were added or changed while this
+     * dialog was open.
+     **/
+    const QStringList & changedRepos() const { return _changedRepos; }
+
 
 signals:
 
@@ -102,10 +109,16 @@ protected:
      **/
     void updateCurrentData();
 
+    /**
+     * Remember that the repo with alias 'alias' was added or changed.
+     **/
+    void addChangedRepo( const std::string & alias );
+
 
     // Data members
 
     Ui::RepoConfig * _ui;  // see ui_repo-config.h
+    QStringList      _changedRepos;
 };
 
 
@@ -20,6 +20,7 @@
 #include "Exception.h"
 #include "Logger.h"
 #include "MainWindow.h"
+#include "RepoProber.h"
 #include "WindowSettings.h"
 #include "utf8.h"
 #include "YQi18n.h"
@@ -31,8 +32,10 @@ RepoEditDialog::RepoEditDialog( Mode      mode,
     : QDialog( parent ? parent : MainWindow::instance() )
     , _mode( mode )
     , _ui( new Ui::RepoEdit )  // Use the Qt designer .ui form (XML)
+    , _prober( new RepoProber( this ) )
 {
     CHECK_NEW( _ui );
+    CHECK_NEW( _prober );
     _ui->setupUi( this ); // Actually create the widgets from the .ui form
 
     // See ui_repo-config.h for the widget names.
@@ -52,6 +55,7 @@ RepoEditDialog::RepoEditDialog( Mode      mode,
     setWindowTitle( title );
     _ui->heading->setTextFormat( Qt::RichText );
     _ui->heading->setText( QString( "<b>%1</b>" ).arg( title ) );
+    setProbing( false );
 
     resize( sizeHint() ); // Fallback initial size if there is none in the settings
     connectWidgets();
@@ -78,6 +82,12 @@ void RepoEditDialog::connectWidgets()
 
     connect( _ui->repoRawUrl, SIGNAL( textChanged      ( QString ) ),
              this,            SLOT  ( updateExpandedUrl()          ) );
+
+    connect( _prober, SIGNAL( probeDone    ( int, QString ) ),
+             this,    SLOT  ( probeDone    ( int, QString ) ) );
+
+    connect( _prober, SIGNAL( finished     ( int, QString ) ),
+             this,    SLOT  ( probeFinished( int, QString ) ) );
 }
 
 
@@ -91,6 +101,10 @@ int RepoEditDialog::addRepo()
     _ui->repoName->clear();
     _ui->repoRawUrl->clear();
     _ui->expandedUrl->clear();
+    _oldRawUrl.clear();
+    _failedRawUrl.clear();
+    _probedType.clear();
+    setProbing( false );
 
     int result = exec();
     saveRepoInfo();
@@ -106,6 +120,10 @@ int RepoEditDialog::editRepo( const ZyppRepoInfo & repoInfo )
     _ui->repoTypeContainer->hide();
     _ui->repoName->setText( fromUTF8( _repoInfo.name() ) );
     _ui->repoRawUrl->setText( fromUTF8( _repoInfo.rawUrl().asString() ) );
+    _oldRawUrl = _ui->repoRawUrl->text();
+    _failedRawUrl.clear();
+    _probedType.clear();
+    setProbing( false );
 
     int result = exec();
     saveRepoInfo();
@@ -132,8 +150,147 @@ void RepoEditDialog::updateExpandedUrl()
 
 void RepoEditDialog::saveRepoInfo()
 {
-    zypp::Url url( toUTF8( _ui->repoRawUrl->text() ) );
+    zypp::Url url( toUTF8( _ui->repoRawUrl->text().trimmed() ) );
 
     _repoInfo.setName( toUTF8( _ui->repoName->text() ) );
     _repoInfo.setBaseUrl( url );
+
+    // With a known type, adding the repo doesn't need to probe it again
+    // (synchronously in the GUI process)
+
+    if ( ! _probedType.isEmpty() )
+        _repoInfo.setType( zypp::repo::RepoType( toUTF8( _probedType ) ) );
+}
+
+
+QStringList RepoEditDialog::candidateUrls() const
+{
+    QString text = _ui->repoRawUrl->text().simplified();
+
+    if ( text.isEmpty() )
+        return QStringList();
+
+    return text.split( ' ' );
+}
+
+
+void RepoEditDialog::accept()
+{
+    if ( _prober->isRunning() )
+        return;
+
+    _candidateUrls = candidateUrls();
+    _probedType.clear();
+
+    QString rawUrl = _ui->repoRawUrl->text().trimmed();
+
+    if ( _candidateUrls.size() > 1 && rawUrl == _failedRawUrl )
+    {
+        // Several URLs that all failed: Don't probe them all again, and
+        // don't save them as one URL with spaces
+
+        _ui->probeStatus->setText( _( "Please keep exactly one URL." ) );
+        _ui->probeStatus->show();
+        return;
+    }
+
+    if ( _candidateUrls.isEmpty() || rawUrl == _oldRawUrl || rawUrl == _failedRawUrl )
+    {
+        // Nothing to probe, or the user insists on an URL that failed:
+        // Leave the repo type to libzypp.
+
+        QDialog::accept();
+        return;
+    }
+
+    QStringList expandedUrls;
+    zypp::repo::RepoVariablesStringReplacer replacer;
+
+    for ( const QString & url: _candidateUrls )
+        expandedUrls << fromUTF8( replacer( toUTF8( url ) ) );
+
+    setProbing( true );
+    probeDone( -1, "" ); // Initial status text
+    _prober->probe( expandedUrls );
+}
+
+
+void RepoEditDialog::reject()
+{
+    if ( _prober->isRunning() )
+    {
+        logInfo() << "Probing canceled by the user" << endl;
+
+        _prober->cancel();
+        setProbing( false );
+
+        return;
+    }
+
+    QDialog::reject();
+}
+
+
+void RepoEditDialog::probeDone( int index, const QString & repoType )
+{
+    Q_UNUSED( index );
+    Q_UNUSED( repoType );
+
+    if ( _candidateUrls.size() == 1 )
+    {
+        _ui->probeStatus->setText( _( "Checking the repository URL..." ) );
+    }
+    else
+    {
+        _ui->probeStatus->setText( _( "Checking %1 URLs (%2 done)..." )
+                                   .arg( _candidateUrls.size() )
+                                   .arg( _prober->doneCount() ) );
+    }
+}
+
+
+void RepoEditDialog::probeFinished( int index, const QString & repoType )
+{
+    setProbing( false );
+
+    if ( index >= 0 && index < _candidateUrls.size() )
+    {
+        _probedType = repoType;
+        _ui->repoRawUrl->setText( _candidateUrls[ index ] );
+
+        QDialog::accept();
+        return;
+    }
+
+    // No valid repo: Show why and let the user fix the URL
+
+    QString msg;
+
+    if ( _candidateUrls.size() == 1 )
+    {
+        msg = _( "No valid repository at this URL: %1" ).arg( _prober->errorMessage( 0 ) );
+        msg += "\n" + _( "Click \"OK\" again to use it anyway." );
+    }
+    else
+    {
+        msg = _( "None of the URLs is a valid repository." );
+        msg += "\n" + _( "Please keep exactly one URL." );
+    }
+
+    _failedRawUrl = _ui->repoRawUrl->text().trimmed();
+
+    _ui->probeStatus->setText( msg );
+    _ui->probeStatus->show();
+}
+
+
+void RepoEditDialog::setProbing( bool probing )
+{
+    _ui->probeProgressBar->setVisible( probing );
+    _ui->probeStatus->setVisible( probing );
+
+    _ui->okButton->setEnabled( ! probing );
+    _ui->repoName->setEnabled( ! probing );
+    _ui->repoRawUrl->setEnabled( ! probing );
+    _ui->repoTypeContainer->setEnabled( ! probing );
 }
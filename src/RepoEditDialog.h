@@ -31,6 +31,9 @@
 #include "ui_repo-edit-add.h"
 
 
+class RepoProber;
+
+
 /**
  * Dialog class to edit and add a repo.
  * This includes adding a community repo like Packman.
@@ -91,6 +94,26 @@ public:
     ZyppRepoInfo repoInfo() const { return _repoInfo; }
 
 
+public slots:
+
+    /**
+     * Reimplemented from QDialog: Probe the repo URL in the background
+     * before closing the dialog with "OK".
+     *
+     * The URL field may contain several candidate URLs separated by
+     * whitespace; they are probed at the same time, and the first one in
+     * the list that is a valid repo is used. If none of them is, the user
+     * has to keep exactly one URL before the dialog can be closed with "OK".
+     **/
+    virtual void accept() override;
+
+    /**
+     * Reimplemented from QDialog: While probing, "Cancel" only stops
+     * probing; otherwise it closes the dialog.
+     **/
+    virtual void reject() override;
+
+
 protected slots:
 
     /**
@@ -105,6 +128,17 @@ protected slots:
      **/
     void updateExpandedUrl();
 
+    /**
+     * Update the probe status when probing one candidate URL is done.
+     **/
+    void probeDone( int index, const QString & repoType );
+
+    /**
+     * Notification that probing is finished: Close the dialog if
+     * 'index' is a valid candidate, otherwise show the error.
+     **/
+    void probeFinished( int index, const QString & repoType );
+
 
 protected:
 
@@ -118,6 +152,17 @@ protected:
      **/
     void saveRepoInfo();
 
+    /**
+     * Return the candidate URLs from the repoRawUrl field.
+     **/
+    QStringList candidateUrls() const;
+
+    /**
+     * Enable or disable the input widgets and show or hide the probe status
+     * widgets according to 'probing'.
+     **/
+    void setProbing( bool probing );
+
 
     //
     // Data members
@@ -129,6 +174,11 @@ protected:
 
     QString        _oldRepoName;
     QString        _oldRawUrl;
+
+    RepoProber *   _prober;
+    QStringList    _candidateUrls;
+    QString        _probedType;
+    QString        _failedRawUrl;
 };
 
 #endif // RepoEditDialog_h
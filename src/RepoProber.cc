@@ -0,0 +1,327 @@
+/*  ---------------------------------------------------------
+               __  __            _
+              |  \/  |_   _ _ __| |_   _ _ __
+              | |\/| | | | | '__| | | | | '_ \
+              | |  | | |_| | |  | | |_| | | | |
+              |_|  |_|\__, |_|  |_|\__, |_| |_|
+                      |___/        |___/
+    ---------------------------------------------------------
+
+    Project:  Myrlyn Package Manager GUI
+    Copyright (c) Stefan Hundhammer <Stefan.Hundhammer@gmx.de>
+    License:  GPL V2 - See file LICENSE for details.
+
+    Textdomain "qt-pkg"
+ */
+
+
+
+
+#include <iostream>             // cout
+
+#include <QCoreApplication>
+#include <QTimer>
+
+#include <zypp/RepoManager.h>
+#include <zypp/Url.h>
+
+#include "Exception.h"
+#include "Logger.h"
+#include "YQi18n.h"
+#include "utf8.h"
+#include "RepoProber.h"
+
+
+// Exit codes of repo probe worker processes
+
+#define PROBE_WORKER_OK         0
+#define PROBE_WORKER_NO_REPO    1
+#define PROBE_WORKER_ERROR      2
+
+#define DEFAULT_PROBE_TIMEOUT_SEC       20
+
+
+RepoProber::RepoProber( QObject * parent )
+    : QObject( parent )
+    , _running( false )
+    , _timeoutSec( DEFAULT_PROBE_TIMEOUT_SEC )
+{
+}
+
+
+RepoProber::~RepoProber()
+{
+    cancel();
+}
+
+
+void RepoProber::probe( const QStringList & urls )
+{
+    cancel();
+    _probes.clear();
+
+    for ( const QString & url: urls )
+    {
+        Probe probe;
+        probe.url      = url;
+        probe.process  = 0;
+        probe.done     = false;
+        probe.timedOut = false;
+
+        _probes << probe;
+    }
+
+    logInfo() << "Probing " << urls.size() << " repo URLs: " << urls << endl;
+
+    _running = true;
+    _timer.start();
+
+    for ( int i=0; i < _probes.size(); i++ )
+        startWorker( i );
+
+    checkFinished(); // Maybe there was nothing to do, or no worker started
+}
+
+
+void RepoProber::startWorker( int index )
+{
+    Probe & probe = _probes[ index ];
+
+    QProcess * process = new QProcess( this );
+    CHECK_NEW( process );
+
+    process->setProperty( "probeIndex", index );
+
+    // The result comes on stdout; stderr is only for diagnostics
+    process->setProcessChannelMode( QProcess::ForwardedErrorChannel );
+
+    connect( process, SIGNAL( finished       ( int, QProcess::ExitStatus ) ),
+             this,    SLOT  ( processFinished( int, QProcess::ExitStatus ) ) );
+
+    QStringList args;
+    args << "--probe-repo-worker" << QString::number( index ) << probe.url;
+
+    process->start( QCoreApplication::applicationFilePath(), args );
+
+    if ( ! process->waitForStarted() )
+    {
+        logError() << "Could not start a repo probe worker process: "
+                   << process->errorString() << endl;
+
+        probe.error = process->errorString();
+        probe.done  = true;
+        delete process;
+
+        return;
+    }
+
+    probe.process = process;
+
+    // Owned by the process, so it goes away with it
+
+    QTimer * timeoutTimer = new QTimer( process );
+    CHECK_NEW( timeoutTimer );
+
+    timeoutTimer->setSingleShot( true );
+
+    connect( timeoutTimer, SIGNAL( timeout()        ),
+             this,         SLOT  ( processTimeout() ) );
+
+    timeoutTimer->start( _timeoutSec * 1000 );
+}
+
+
+void RepoProber::cancel()
+{
+    for ( Probe & probe: _probes )
+    {
+        if ( ! probe.process )
+            continue;
+
+        probe.process->disconnect( this );
+        probe.process->kill();
+        probe.process->waitForFinished( 1000 ); // millisec
+        probe.process->deleteLater();
+        probe.process = 0;
+    }
+
+    _running = false;
+}
+
+
+void RepoProber::processTimeout()
+{
+    QTimer * timeoutTimer = qobject_cast<QTimer *>( sender() );
+
+    if ( ! timeoutTimer )
+        return;
+
+    QProcess * process = qobject_cast<QProcess *>( timeoutTimer->parent() );
+
+    if ( ! process )
+        return;
+
+    int index = process->property( "probeIndex" ).toInt();
+
+    if ( index >= 0 && index < _probes.size() )
+    {
+        logWarning() << "Timeout probing " << _probes[ index ].url << endl;
+        _probes[ index ].timedOut = true;
+    }
+
+    process->kill(); // This will end up in processFinished()
+}
+
+
+void RepoProber::processFinished( int exitCode, QProcess::ExitStatus exitStatus )
+{
+    QProcess * process = qobject_cast<QProcess *>( sender() );
+
+    if ( ! process )
+        return;
+
+    int index = process->property( "probeIndex" ).toInt();
+    QString output = QString::fromUtf8( process->readAllStandardOutput() ).trimmed();
+    process->deleteLater();
+
+    if ( index < 0 || index >= _probes.size() || _probes[ index ].process != process )
+        return;
+
+    Probe & probe = _probes[ index ];
+    probe.process = 0;
+    probe.done    = true;
+
+    // Expected output:
+    //
+    //   type rpm-md
+    // or (only for the log)
+    //   error <message>
+    //
+    // The messages for the user only depend on the exit code: The worker's
+    // text is not translated.
+
+    if ( probe.timedOut )
+    {
+        probe.error = _( "Timeout after %1 sec" ).arg( _timeoutSec );
+    }
+    else if ( exitStatus == QProcess::NormalExit &&
+              exitCode   == PROBE_WORKER_OK      &&
+              output.startsWith( "type " ) )
+    {
+        probe.repoType = output.mid( 5 );
+    }
+    else if ( exitStatus == QProcess::NormalExit && exitCode == PROBE_WORKER_NO_REPO )
+    {
+        probe.error = _( "No repository found at this URL" );
+    }
+    else if ( exitStatus == QProcess::NormalExit && exitCode == PROBE_WORKER_ERROR )
+    {
+        if ( output.startsWith( "error " ) )
+            logWarning() << "Probing " << probe.url << " failed: " << output.mid( 6 ) << endl;
+
+        probe.error = _( "Could not access this URL" );
+    }
+    else
+    {
+        probe.error = _( "Probe worker failed with exit code %1" ).arg( exitCode );
+    }
+
+    logInfo() << "Probing " << probe.url << " done after "
+              << _timer.elapsed() / 1000.0 << " sec: "
+              << ( probe.repoType.isEmpty() ? probe.error : probe.repoType )
+              << endl;
+
+    emit probeDone( index, probe.repoType );
+    checkFinished();
+}
+
+
+void RepoProber::checkFinished()
+{
+    if ( ! _running )
+        return;
+
+    // The first candidate in the list wins, so a later one that is a valid
+    // repo can only be used when all the ones before it are known to fail.
+
+    for ( int i=0; i < _probes.size(); i++ )
+    {
+        const Probe & probe = _probes[ i ];
+
+        if ( ! probe.done )
+            return;
+
+        if ( ! probe.repoType.isEmpty() )
+        {
+            QString repoType = probe.repoType;
+            cancel();
+            emit finished( i, repoType );
+
+            return;
+        }
+    }
+
+    _running = false;
+    emit finished( -1, "" );
+}
+
+
+int RepoProber::doneCount() const
+{
+    int count = 0;
+
+    for ( const Probe & probe: _probes )
+    {
+        if ( probe.done )
+            ++count;
+    }
+
+    return count;
+}
+
+
+QString RepoProber::errorMessage( int index ) const
+{
+    if ( index < 0 || index >= _probes.size() )
+        return "";
+
+    return _probes[ index ].error;
+}
+
+
+int RepoProber::runWorker( const QString & url )
+{
+    // Don't take the zypp lock: The parent process holds it. Probing only
+    // downloads to a temporary directory; it doesn't change any repo
+    // configuration or cache.
+
+    try
+    {
+        zypp::RepoManager repoManager;
+        zypp::repo::RepoType repoType = repoManager.probe( zypp::Url( toUTF8( url ) ) );
+
+        if ( repoType == zypp::repo::RepoType::NONE )
+        {
+            logInfo() << "No repo at " << url << endl;
+
+            return PROBE_WORKER_NO_REPO;
+        }
+
+        logInfo() << "Repo type at " << url << ": " << repoType.asString() << endl;
+        std::cout << "type " << repoType.asString() << std::endl;
+
+        return PROBE_WORKER_OK;
+    }
+    catch ( const zypp::Exception & exception )
+    {
+        logError() << "Probing " << url << " failed: "
+                   << fromUTF8( exception.asUserString() ) << endl;
+
+        // Only the first line and only for the log of the caller
+
+        std::string msg = exception.asUserString();
+        std::cout << "error " << msg.substr( 0, msg.find( '\n' ) ) << std::endl;
+
+        return PROBE_WORKER_ERROR;
+    }
+}
@@ -0,0 +1,162 @@
+/*  ---------------------------------------------------------
+               __  __            _
+              |  \/  |_   _ _ __| |_   _ _ __
+              | |\/| | | | | '__| | | | | '_ \
+              | |  | | |_| | |  | | |_| | | | |
+              |_|  |_|\__, |_|  |_|\__, |_| |_|
+                      |___/        |___/
+    ---------------------------------------------------------
+
+    Project:  Myrlyn Package Manager GUI
+    Copyright (c) Stefan Hundhammer <Stefan.Hundhammer@gmx.de>
+    License:  GPL V2 - See file LICENSE for details.
+
+    Textdomain "qt-pkg"
+ */
+
+
+
+
+#ifndef RepoProber_h
+#define RepoProber_h
+
+
+#include <QElapsedTimer>
+#include <QList>
+#include <QObject>
+#include <QProcess>
+#include <QStringList>
+
+
+/**
+ * Probe candidate URLs for a repo in worker processes without blocking the
+ * GUI: Each worker process is Myrlyn started with the internal
+ * --probe-repo-worker option. It asks libzypp what type of repo (rpm-md,
+ * yast2, plain directory) is at that URL, which may mean downloading
+ * metadata from a slow or unreachable server.
+ *
+ * All candidates are probed at the same time, each one with a timeout. The
+ * result is the first candidate in the list that is a valid repo; as soon
+ * as that is known, the remaining workers are killed.
+ **/
+class RepoProber: public QObject
+{
+    Q_OBJECT
+
+public:
+
+    /**
+     * Constructor.
+     **/
+    RepoProber( QObject * parent = 0 );
+
+    /**
+     * Destructor. This kills any worker processes that are still running.
+     **/
+    virtual ~RepoProber();
+
+    /**
+     * Start probing the (already expanded) candidate URLs 'urls'.
+     * This cancels any probing that is still going on.
+     **/
+    void probe( const QStringList & urls );
+
+    /**
+     * Kill all worker processes. This does not emit any signal.
+     **/
+    void cancel();
+
+    /**
+     * Return 'true' if probing is still going on.
+     **/
+    bool isRunning() const { return _running; }
+
+    /**
+     * Return the number of candidate URLs that are done probing.
+     **/
+    int doneCount() const;
+
+    /**
+     * Return the translated error message for the candidate with index
+     * 'index' or an empty string if there was no error (yet).
+     **/
+    QString errorMessage( int index ) const;
+
+    /**
+     * Set the timeout for probing one URL in seconds.
+     **/
+    void setTimeout( int sec ) { _timeoutSec = sec; }
+
+    /**
+     * Probe one URL in a worker process (command line option
+     * --probe-repo-worker) and write the repo type to stdout.
+     *
+     * Return the exit code for the worker process: 0 for success,
+     * nonzero for failure.
+     **/
+    static int runWorker( const QString & url );
+
+
+signals:
+
+    /**
+     * Emitted when probing the candidate with index 'index' is done.
+     * 'repoType' is empty if it is not a valid repo.
+     **/
+    void probeDone( int index, const QString & repoType );
+
+    /**
+     * Emitted when the result is known: 'index' is the first candidate that
+     * is a valid repo of type 'repoType', or -1 if there is none.
+     **/
+    void finished( int index, const QString & repoType );
+
+
+protected slots:
+
+    /**
+     * Notification that a worker process finished.
+     **/
+    void processFinished( int exitCode, QProcess::ExitStatus exitStatus );
+
+    /**
+     * Notification that a worker process took too long.
+     **/
+    void processTimeout();
+
+
+protected:
+
+    /**
+     * Start a worker process for the candidate with index 'index'.
+     **/
+    void startWorker( int index );
+
+    /**
+     * Emit finished() if the result is known and cancel the remaining
+     * workers.
+     **/
+    void checkFinished();
+
+
+    struct Probe
+    {
+        QString    url;
+        QString    repoType;
+        QString    error;
+        QProcess * process;
+        bool       done;
+        bool       timedOut;
+    };
+
+
+    // Data members
+
+    QList<Probe>  _probes;
+    bool          _running;
+    int           _timeoutSec;
+    QElapsedTimer _timer;
+};
+
+
+#endif // RepoProber_h
@@ -0,0 +1,82 @@
+/*  ---------------------------------------------------------
+               __  __            _
+              |  \/  |_   _ _ __| |_   _ _ __
+              | |\/| | | | | '__| | | | | '_ \
+              | |  | | |_| | |  | | |_| | | | |
+              |_|  |_|\__, |_|  |_|\__, |_| |_|
+                      |___/        |___/
+    ---------------------------------------------------------
+
+    Project:  Myrlyn Package Manager GUI
+    Copyright (c) Stefan Hundhammer <Stefan.Hundhammer@gmx.de>
+    License:  GPL V2 - See file LICENSE for details.
+
+    Textdomain "qt-pkg"
+ */
+
+
+#include "Logger.h"
+#include "PoolGeneration.h"
+#include "SelectableIds.h"
+
+
+std::vector<ZyppSel>                                  SelectableIds::_selectables;
+std::unordered_map<const zypp::ui::Selectable *, int> SelectableIds::_ids;
+int                                                   SelectableIds::_contentGeneration = -1;
+
+
+int
+SelectableIds::count()
+{
+    ensureUpToDate();
+
+    return (int) _selectables.size();
+}
+
+
+int
+SelectableIds::id( ZyppSel selectable )
+{
+    ensureUpToDate();
+
+    auto it = _ids.find( selectable.get() );
+
+    return it == _ids.end() ? -1 : it->second;
+}
+
+
+ZyppSel
+SelectableIds::selectable( int id )
+{
+    ensureUpToDate();
+
+    if ( id < 0 || id >= (int) _selectables.size() )
+        return ZyppSel();
+
+    return _selectables[ id ];
+}
+
+
+void
+SelectableIds::ensureUpToDate()
+{
+    int contentGeneration = PoolGeneration::contentGeneration();
+
+    if ( contentGeneration == _contentGeneration )
+        return;
+
+    _selectables.clear();
+    _ids.clear();
+
+    for ( ZyppPoolIterator it = zyppPkgBegin();
+          it != zyppPkgEnd();
+          ++it )
+    {
+        _ids[ (*it).get() ] = (int) _selectables.size();
+        _selectables.push_back( *it );
+    }
+
+    _contentGeneration = contentGeneration;
+
+    logDebug() << "Assigned IDs to " << _selectables.size() << " selectables" << endl;
+}
@@ -0,0 +1,77 @@
+/*  ---------------------------------------------------------
+               __  __            _
+              |  \/  |_   _ _ __| |_   _ _ __
+              | |\/| | | | | '__| | | | | '_ \
+              | |  | | |_| | |  | | |_| | | | |
+              |_|  |_|\__, |_|  |_|\__, |_| |_|
+                      |___/        |___/
+    ---------------------------------------------------------
+
+    Project:  Myrlyn Package Manager GUI
+    Copyright (c) Stefan Hundhammer <Stefan.Hundhammer@gmx.de>
+    License:  GPL V2 - See file LICENSE for details.
+
+    Textdomain "qt-pkg"
+ */
+
+
+#ifndef SelectableIds_h
+#define SelectableIds_h
+
+#include <unordered_map>
+#include <vector>
+
+#include "YQZypp.h"
+
+
+/**
+ * Dense integer IDs 0..count()-1 for all package selectables in the pool,
+ * assigned in pool order.
+ *
+ * The IDs are rebuilt automatically when the content of the pool changes
+ * (see PoolGeneration::contentGeneration()), so don't store them across
+ * repo refreshes.
+ *
+ * This is a purely static class.
+ **/
+class SelectableIds
+{
+public:
+
+    /**
+     * Return the number of package selectables, i.e. the first ID that is
+     * not used anymore.
+     **/
+    static int count();
+
+    /**
+     * Return the ID of 'selectable' or -1 if it is not a package selectable
+     * in the pool.
+     **/
+    static int id( ZyppSel selectable );
+
+    /**
+     * Return the selectable with ID 'id'.
+     **/
+    static ZyppSel selectable( int id );
+
+
+protected:
+
+    /**
+     * Rebuild the IDs if the pool content changed.
+     **/
+    static void ensureUpToDate();
+
+
+private:
+
+    SelectableIds() {}
+
+    static std::vector<ZyppSel>                                  _selectables;
+    static std::unordered_map<const zypp::ui::Selectable *, int> _ids;
+    static int                                                   _contentGeneration;
+};
+
+
+#endif // SelectableIds_h
@@ -0,0 +1,298 @@
+/*  ---------------------------------------------------------
+               __  __            _
+              |  \/  |_   _ _ __| |_   _ _ __
+              | |\/| | | | | '__| | | | | '_ \
+              | |  | | |_| | |  | | |_| | | | |
+              |_|  |_|\__, |_|  |_|\__, |_| |_|
+                      |___/        |___/
+    ---------------------------------------------------------
+
+    Project:  Myrlyn Package Manager GUI
+    Copyright (c) Stefan Hundhammer <Stefan.Hundhammer@gmx.de>
+    License:  GPL V2 - See file LICENSE for details.
+
+    Textdomain "qt-pkg"
+ */
+
+
+
+
+#include <iostream>             // cin, cout
+#include <string>
+
+#include <QCoreApplication>
+
+#include <zypp/ZYppFactory.h>
+#include <zypp/RepoManager.h>
+#include <zypp/Repository.h>
+#include <zypp/Resolver.h>
+#include <zypp/ResPool.h>
+#include <zypp/Target.h>
+#include <zypp/sat/Pool.h>
+
+#include "Exception.h"
+#include "Logger.h"
+#include "MyrlynRepoManager.h"
+#include "YQZypp.h"
+#include "utf8.h"
+#include "SolverWorker.h"
+
+
+// Exit codes of solver worker processes
+
+#define SOLVER_WORKER_OK        0
+#define SOLVER_WORKER_ERROR     1
+
+
+SolverWorker::SolverWorker( QObject * parent )
+    : QObject( parent )
+    , _process( 0 )
+{
+}
+
+
+SolverWorker::~SolverWorker()
+{
+    cancel();
+}
+
+
+void SolverWorker::start()
+{
+    if ( _process )
+        return;
+
+    QStringList args;
+    args << "--solver-worker";
+
+    zypp::Resolver_Ptr resolver = zypp::getZYpp()->resolver();
+
+    if ( resolver->onlyRequires()      ) args << "--only-requires";
+    if ( resolver->allowVendorChange() ) args << "--allow-vendor-change";
+    if ( resolver->cleandepsOnRemove() ) args << "--clean-deps";
+
+    // Load exactly the repos that are in the pool of this process, not
+    // just all enabled ones: Some of them might have been disabled because
+    // they could not be refreshed.
+
+    for ( zypp::Repository repo: zypp::sat::Pool::instance().repos() )
+    {
+        if ( ! repo.isSystemRepo() )
+            args << "--repo" << fromUTF8( repo.alias() );
+    }
+
+    _process = new QProcess( this );
+    CHECK_NEW( _process );
+
+    // The result comes on stdout; stderr is only for diagnostics
+    _process->setProcessChannelMode( QProcess::ForwardedErrorChannel );
+
+    connect( _process, SIGNAL( finished       ( int, QProcess::ExitStatus ) ),
+             this,     SLOT  ( processFinished( int, QProcess::ExitStatus ) ) );
+
+    logInfo() << "Verifying the system dependencies in a worker process..." << endl;
+    _process->start( QCoreApplication::applicationFilePath(), args );
+
+    if ( ! _process->waitForStarted() )
+    {
+        logError() << "Could not start a solver worker process: "
+                   << _process->errorString() << endl;
+
+        delete _process;
+        _process = 0;
+
+        emit failed();
+        return;
+    }
+
+    _timer.start();
+    _process->write( userStatusSnapshot() );
+    _process->closeWriteChannel();
+}
+
+
+void SolverWorker::cancel()
+{
+    if ( ! _process )
+        return;
+
+    logInfo() << "Killing the solver worker process" << endl;
+
+    _process->disconnect( this );
+    _process->kill();
+    _process->waitForFinished( 1000 ); // millisec
+    _process->deleteLater();
+    _process = 0;
+}
+
+
+void SolverWorker::processFinished( int exitCode, QProcess::ExitStatus exitStatus )
+{
+    if ( ! _process )
+        return;
+
+    QStringList output = QString::fromUtf8( _process->readAllStandardOutput() ).split( '\n' );
+    _process->deleteLater();
+    _process = 0;
+
+    if ( exitStatus != QProcess::NormalExit || exitCode != SOLVER_WORKER_OK )
+    {
+        logWarning() << "Solver worker failed with exit code " << exitCode << endl;
+        emit failed();
+        return;
+    }
+
+    // Expected output:
+    //
+    //   success 1
+    //   changes 0
+
+    int success = -1;
+    int changes = -1;
+
+    for ( const QString & line: output )
+    {
+        QStringList fields = line.split( ' ' );
+
+        if ( fields.size() != 2 )
+            continue;
+
+        if ( fields[0] == "success" ) success = fields[1].toInt();
+        if ( fields[0] == "changes" ) changes = fields[1].toInt();
+    }
+
+    if ( success < 0 || changes < 0 )
+    {
+        logWarning() << "Bad output from the solver worker: " << output.join( " | " ) << endl;
+        emit failed();
+        return;
+    }
+
+    logInfo() << "Solver worker done after " << _timer.elapsed() / 1000.0 << " sec: "
+              << ( success ? "success" : "dependency problems" )
+              << ", " << changes << " changes" << endl;
+
+    emit finished( success != 0, changes );
+}
+
+
+QByteArray SolverWorker::userStatusSnapshot() const
+{
+    QByteArray snapshot;
+
+    for ( const MyrlynRepoManager::SavedStatus & saved: MyrlynRepoManager::saveUserStatus() )
+    {
+        // kind <tab> name <tab> status <tab> edition <tab> arch <tab> repo <tab> pick
+
+        snapshot += QString( "%1\t%2\t%3\t%4\t%5\t%6\t%7\n" )
+            .arg( fromUTF8( saved.kind.asString() ) )
+            .arg( fromUTF8( saved.name ) )
+            .arg( (int) saved.status )
+            .arg( fromUTF8( saved.edition ) )
+            .arg( fromUTF8( saved.arch ) )
+            .arg( fromUTF8( saved.repoAlias ) )
+            .arg( saved.pick ? 1 : 0 ).toUtf8();
+    }
+
+    return snapshot;
+}
+
+
+int SolverWorker::runWorker( const QStringList & args )
+{
+    QElapsedTimer timer;
+    timer.start();
+
+    try
+    {
+        // Don't take the zypp lock: The parent process holds it. This
+        // process only reads the target and the repo caches and never
+        // commits anything.
+
+        zypp_readonly_hack::IWantIt();
+
+        zypp::ZYpp::Ptr zypp_ptr = zypp::getZYpp();
+        zypp_ptr->initializeTarget( "/", false );  // don't rebuild rpmdb
+        zypp_ptr->target()->load();
+
+        zypp::RepoManager repoManager;
+
+        for ( int i=0; i < args.size() - 1; i++ )
+        {
+            if ( args[i] != "--repo" )
+                continue;
+
+            std::string alias = toUTF8( args[ ++i ] );
+
+            try
+            {
+                ZyppRepoInfo repo = repoManager.getRepositoryInfo( alias );
+                repoManager.loadFromCache( repo );
+            }
+            catch ( const zypp::Exception & exception )
+            {
+                logWarning() << "CAUGHT zypp exception for repo " << alias
+                             << ": " << exception.asString() << endl;
+            }
+        }
+
+
+        // Apply the snapshot of the user status from the parent process
+
+        QList<MyrlynRepoManager::SavedStatus> savedStatus;
+        std::string line;
+
+        while ( std::getline( std::cin, line ) )
+        {
+            QStringList fields = fromUTF8( line ).split( '\t' );
+
+            if ( fields.size() == 7 )
+            {
+                MyrlynRepoManager::SavedStatus saved( zypp::ResKind( toUTF8( fields[0] ) ),
+                                                      toUTF8( fields[1] ),
+                                                      (ZyppStatus) fields[2].toInt() );
+                saved.edition   = toUTF8( fields[3] );
+                saved.arch      = toUTF8( fields[4] );
+                saved.repoAlias = toUTF8( fields[5] );
+                saved.pick      = fields[6].toInt() != 0;
+
+                savedStatus << saved;
+            }
+        }
+
+        logInfo() << "Applying the status of " << savedStatus.size() << " selectables" << endl;
+        MyrlynRepoManager::restoreUserStatus( savedStatus );
+
+
+        zypp::Resolver_Ptr resolver = zypp_ptr->resolver();
+
+        resolver->setOnlyRequires     ( args.contains( "--only-requires"       ) );
+        resolver->setAllowVendorChange( args.contains( "--allow-vendor-change" ) );
+        resolver->setCleandepsOnRemove( args.contains( "--clean-deps"          ) );
+
+        logInfo() << "Verifying all system dependencies..." << endl;
+        bool success = resolver->verifySystem();
+        int  changes = 0;
+
+        for ( const zypp::PoolItem & item: zypp_ptr->pool() )
+        {
+            if ( item.status().transacts() && item.status().isBySolver() )
+                ++changes;
+        }
+
+        logInfo() << "System dependencies verified after " << timer.elapsed() / 1000.0 << " sec: "
+                  << ( success ? "success" : "dependency problems" )
+                  << ", " << changes << " changes" << endl;
+
+        std::cout << "success " << ( success ? 1 : 0 ) << "\n"
+                  << "changes " << changes << std::endl;
+    }
+    catch ( const zypp::Exception & exception )
+    {
+        logError() << "CAUGHT zypp exception: " << exception.asString() << endl;
+
+        return SOLVER_WORKER_ERROR;
+    }
+
+    return SOLVER_WORKER_OK;
+}
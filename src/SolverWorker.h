@@ -0,0 +1,129 @@
+/*  ---------------------------------------------------------
+               __  __            _
+              |  \/  |_   _ _ __| |_   _ _ __
+              | |\/| | | | | '__| | | | | '_ \
+              | |  | | |_| | |  | | |_| | | | |
+              |_|  |_|\__, |_|  |_|\__, |_| |_|
+                      |___/        |___/
+    ---------------------------------------------------------
+
+    Project:  Myrlyn Package Manager GUI
+    Copyright (c) Stefan Hundhammer <Stefan.Hundhammer@gmx.de>
+    License:  GPL V2 - See file LICENSE for details.
+
+    Textdomain "qt-pkg"
+ */
+
+
+
+
+#ifndef SolverWorker_h
+#define SolverWorker_h
+
+
+#include <QElapsedTimer>
+#include <QObject>
+#include <QProcess>
+#include <QStringList>
+
+
+/**
+ * Verify the system dependencies in a worker process without blocking the
+ * GUI: The worker process is Myrlyn started with the internal
+ * --solver-worker option. It loads its own pool from the target and the
+ * caches of the repos in the pool of this process, applies a snapshot of the status that the
+ * user explicitly set in this process, and runs the dependency solver.
+ *
+ * This can't be a thread of this process: Any widget may access the pool
+ * at any time while the solver runs.
+ *
+ * The worker only reports if there were any problems and how many packages
+ * the solver would change. The problems themselves and their solutions only
+ * make sense for the pool of this process, so if there are any, the caller
+ * needs to run the solver again in this process to show them.
+ **/
+class SolverWorker: public QObject
+{
+    Q_OBJECT
+
+public:
+
+    /**
+     * Constructor.
+     **/
+    SolverWorker( QObject * parent = 0 );
+
+    /**
+     * Destructor. This kills the worker process if it is still running.
+     **/
+    virtual ~SolverWorker();
+
+    /**
+     * Start verifying the system dependencies in a worker process with a
+     * snapshot of the current user status and the current resolver flags.
+     * Do nothing if a worker process is already running.
+     **/
+    void start();
+
+    /**
+     * Return 'true' if a worker process is running.
+     **/
+    bool isRunning() const { return _process != 0; }
+
+    /**
+     * Kill the worker process. This does not emit any signal.
+     **/
+    void cancel();
+
+    /**
+     * Run the solver in a worker process (command line option
+     * --solver-worker), reading the snapshot from stdin and writing the
+     * result to stdout. 'args' are the command line arguments after
+     * --solver-worker.
+     *
+     * Return the exit code for the worker process: 0 for success,
+     * nonzero for failure.
+     **/
+    static int runWorker( const QStringList & args );
+
+
+signals:
+
+    /**
+     * Emitted when the worker process is finished. 'success' is the return
+     * value of the solver; 'changes' is the number of items that the solver
+     * set to be installed or removed.
+     **/
+    void finished( bool success, int changes );
+
+    /**
+     * Emitted when the worker process could not deliver a result.
+     **/
+    void failed();
+
+
+protected slots:
+
+    /**
+     * Notification that the worker process finished.
+     **/
+    void processFinished( int exitCode, QProcess::ExitStatus exitStatus );
+
+
+protected:
+
+    /**
+     * Return the snapshot of the user status for the worker process,
+     * one line per selectable.
+     **/
+    QByteArray userStatusSnapshot() const;
+
+
+    // Data members
+
+    QProcess *    _process;
+    QElapsedTimer _timer;
+};
+
+
+#endif // SolverWorker_h
@@ -0,0 +1,241 @@
+/*  ---------------------------------------------------------
+               __  __            _
+              |  \/  |_   _ _ __| |_   _ _ __
+              | |\/| | | | | '__| | | | | '_ \
+              | |  | | |_| | |  | | |_| | | | |
+              |_|  |_|\__, |_|  |_|\__, |_| |_|
+                      |___/        |___/
+    ---------------------------------------------------------
+
+    Project:  Myrlyn Package Manager GUI
+    Copyright (c) Stefan Hundhammer <Stefan.Hundhammer@gmx.de>
+    License:  GPL V2 - See file LICENSE for details.
+
+    Textdomain "qt-pkg"
+ */
+
+
+#include <time.h>               // clock_gettime()
+#include <unistd.h>             // sysconf()
+
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QTextStream>
+
+#include "Exception.h"
+#include "Logger.h"
+#include "StartupTimer.h"
+
+
+StartupTimer *
+StartupTimer::instance()
+{
+    static StartupTimer * _instance = 0;
+
+    if ( ! _instance )
+    {
+        _instance = new StartupTimer();
+        CHECK_NEW( _instance );
+    }
+
+    return _instance;
+}
+
+
+StartupTimer::StartupTimer()
+    : _finished( false )
+{
+    _clock.start();
+}
+
+
+void
+StartupTimer::begin( const QString & phase )
+{
+    if ( _finished || haveResult( phase ) || _running.contains( phase ) )
+        return;
+
+    Sample sample;
+    sample.start = _clock.elapsed();
+    sample.cpu   = cpuMillisec();
+    sample.rss   = rssKB();
+
+    _running[ phase ] = sample;
+}
+
+
+void
+StartupTimer::end( const QString & phase )
+{
+    if ( _finished || ! _running.contains( phase ) )
+        return;
+
+    Sample sample = _running.take( phase );
+
+    Phase result;
+    result.name     = phase;
+    result.start    = sample.start;
+    result.wall     = _clock.elapsed() - sample.start;
+    result.cpu      = cpuMillisec()    - sample.cpu;
+    result.rss      = rssKB();
+    result.rssDelta = result.rss       - sample.rss;
+
+    _phases << result;
+
+    logInfo() << "Startup phase " << phase
+              << ": " << result.wall << " ms wall"
+              << ", " << result.cpu  << " ms CPU"
+              << ", RSS " << result.rss << " kB ("
+              << ( result.rssDelta >= 0 ? "+" : "" ) << result.rssDelta << " kB)"
+              << endl;
+}
+
+
+void
+StartupTimer::add( const QString & phase, qint64 start, qint64 wall )
+{
+    if ( _finished || haveResult( phase ) )
+        return;
+
+    Phase result;
+    result.name     = phase;
+    result.start    = start;
+    result.wall     = wall;
+    result.cpu      = 0;
+    result.rss      = 0;
+    result.rssDelta = 0;
+
+    _phases << result;
+
+    logInfo() << "Startup phase " << phase << ": " << wall << " ms wall" << endl;
+}
+
+
+bool
+StartupTimer::haveResult( const QString & phase ) const
+{
+    for ( const Phase & result: _phases )
+    {
+        if ( result.name == phase )
+            return true;
+    }
+
+    return false;
+}
+
+
+void
+StartupTimer::finish()
+{
+    if ( _finished )
+        return;
+
+    _finished = true;
+
+    for ( const QString & phase: _running.keys() )
+        logWarning() << "Startup phase " << phase << " never ended" << endl;
+
+    _running.clear();
+
+    logInfo() << "Startup finished after " << _clock.elapsed() << " ms" << endl;
+    writeReport();
+}
+
+
+QString
+StartupTimer::reportFileName() const
+{
+    return Logger::lastLogDir() + "/startup-report.json";
+}
+
+
+void
+StartupTimer::writeReport() const
+{
+    QJsonArray phases;
+
+    for ( const Phase & phase: _phases )
+    {
+        QJsonObject obj;
+
+        obj[ "name"         ] = phase.name;
+        obj[ "start_ms"     ] = phase.start;
+        obj[ "wall_ms"      ] = phase.wall;
+        obj[ "cpu_ms"       ] = phase.cpu;
+        obj[ "rss_kb"       ] = phase.rss;
+        obj[ "rss_delta_kb" ] = phase.rssDelta;
+
+        phases.append( obj );
+    }
+
+    QJsonObject report;
+    report[ "version"  ] = VERSION;
+    report[ "total_ms" ] = _clock.elapsed();
+    report[ "cpu_ms"   ] = cpuMillisec();
+    report[ "rss_kb"   ] = rssKB();
+    report[ "phases"   ] = phases;
+
+    QFile file( reportFileName() );
+
+    if ( ! file.open( QIODevice::WriteOnly | QIODevice::Truncate ) )
+    {
+        logError() << "Can't open " << reportFileName() << endl;
+        return;
+    }
+
+    file.write( QJsonDocument( report ).toJson() );
+    logInfo() << "Wrote startup report to " << reportFileName() << endl;
+}
+
+
+QString
+StartupTimer::summary() const
+{
+    QString text;
+    QTextStream str( &text );
+
+    for ( const Phase & phase: _phases )
+    {
+        str << QString( "%1  %2 ms  (CPU %3 ms, RSS %4%5 kB)\n" )
+            .arg( phase.name, -32 )
+            .arg( phase.wall, 7 )
+            .arg( phase.cpu )
+            .arg( phase.rssDelta >= 0 ? "+" : "" )
+            .arg( phase.rssDelta );
+    }
+
+    return text;
+}
+
+
+qint64
+StartupTimer::cpuMillisec()
+{
+    struct timespec ts;
+
+    if ( clock_gettime( CLOCK_PROCESS_CPUTIME_ID, &ts ) != 0 )
+        return 0;
+
+    return (qint64) ts.tv_sec * 1000 + ts.tv_nsec / 1000000;
+}
+
+
+qint64
+StartupTimer::rssKB()
+{
+    // The second field of /proc/self/statm is the resident set size in pages
+
+    QFile file( "/proc/self/statm" );
+
+    if ( ! file.open( QIODevice::ReadOnly ) )
+        return 0;
+
+    QList<QByteArray> fields = file.readAll().split( ' ' );
+
+    if ( fields.size() < 2 )
+        return 0;
+
+    return fields[1].toLongLong() * ( sysconf( _SC_PAGESIZE ) / 1024 );
+}
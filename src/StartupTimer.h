@@ -0,0 +1,176 @@
+/*  ---------------------------------------------------------
+               __  __            _
+              |  \/  |_   _ _ __| |_   _ _ __
+              | |\/| | | | | '__| | | | | '_ \
+              | |  | | |_| | |  | | |_| | | | |
+              |_|  |_|\__, |_|  |_|\__, |_| |_|
+                      |___/        |___/
+    ---------------------------------------------------------
+
+    Project:  Myrlyn Package Manager GUI
+    Copyright (c) Stefan Hundhammer <Stefan.Hundhammer@gmx.de>
+    License:  GPL V2 - See file LICENSE for details.
+
+    Textdomain "qt-pkg"
+ */
+
+
+#ifndef StartupTimer_h
+#define StartupTimer_h
+
+
+#include <QElapsedTimer>
+#include <QHash>
+#include <QList>
+#include <QString>
+
+
+/**
+ * Named phase timers for the program startup: Wall clock time, CPU time of
+ * this process and the change of its resident set size (RSS) for each phase.
+ *
+ * When the startup is finished (after the first solver run), finish() writes
+ * all results as a JSON report to startup-report.json in the log directory.
+ * After that, all begin() and end() calls are ignored, so instrumented code
+ * that also runs later does not add anything.
+ *
+ * Notice that the CPU time does not include any child processes like the
+ * repo refresh workers or repo2solv.
+ *
+ * This is a singleton class.
+ **/
+class StartupTimer
+{
+public:
+
+    /**
+     * Return the singleton instance of this class.
+     **/
+    static StartupTimer * instance();
+
+    /**
+     * Start timing the phase with the specified name.
+     * Phases may overlap or be nested.
+     *
+     * Each phase name is recorded only once: If a phase with that name is
+     * already running or already ended, this does nothing.
+     **/
+    void begin( const QString & phase );
+
+    /**
+     * Stop timing the phase with the specified name and record the result.
+     **/
+    void end( const QString & phase );
+
+    /**
+     * Record a phase that was timed somewhere else, e.g. in a worker
+     * process: 'start' is in millisec since the program start (see
+     * elapsed()), 'wall' is the duration in millisec. The CPU time and the
+     * RSS of such a phase are 0.
+     **/
+    void add( const QString & phase, qint64 start, qint64 wall );
+
+    /**
+     * Return the millisec since the program start.
+     **/
+    qint64 elapsed() const { return _clock.elapsed(); }
+
+    /**
+     * Mark the startup as finished and write the JSON report.
+     * Later calls do nothing.
+     **/
+    void finish();
+
+    /**
+     * Return 'true' if the startup is finished.
+     **/
+    bool isFinished() const { return _finished; }
+
+    /**
+     * Return a human-readable summary of all recorded phases.
+     **/
+    QString summary() const;
+
+    /**
+     * Return the full path of the JSON report.
+     **/
+    QString reportFileName() const;
+
+
+protected:
+
+    /**
+     * Constructor. Use instance() instead.
+     **/
+    StartupTimer();
+
+    /**
+     * Return 'true' if a phase with the specified name already ended.
+     **/
+    bool haveResult( const QString & phase ) const;
+
+    /**
+     * Write the JSON report to reportFileName().
+     **/
+    void writeReport() const;
+
+    /**
+     * Return the CPU time used by this process so far in millisec.
+     **/
+    static qint64 cpuMillisec();
+
+    /**
+     * Return the current resident set size of this process in kB.
+     **/
+    static qint64 rssKB();
+
+
+    struct Sample
+    {
+        qint64 start;   // millisec since program start
+        qint64 cpu;     // millisec
+        qint64 rss;     // kB
+    };
+
+    struct Phase
+    {
+        QString name;
+        qint64  start;
+        qint64  wall;
+        qint64  cpu;
+        qint64  rss;
+        qint64  rssDelta;
+    };
+
+
+    // Data members
+
+    QElapsedTimer          _clock;
+    QHash<QString, Sample> _running;
+    QList<Phase>           _phases;
+    bool                   _finished;
+};
+
+
+/**
+ * Scope guard for a StartupTimer phase: begin() in the constructor, end() in
+ * the destructor.
+ **/
+class StartupPhase
+{
+public:
+
+    StartupPhase( const QString & name )
+        : _name( name )
+        { StartupTimer::instance()->begin( _name ); }
+
+    ~StartupPhase()
+        { StartupTimer::instance()->end( _name ); }
+
+private:
+
+    QString _name;
+};
+
+
+#endif // StartupTimer_h
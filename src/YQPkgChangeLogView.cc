@@ -14,22 +14,49 @@
     Textdomain "qt-pkg"
  */
 
+#include <algorithm>
+
+#include <QLineEdit>
+#include <QResizeEvent>
+#include <QScrollBar>
+#include <QTextCursor>
+#include <QTimer>
+
 #include <zypp/Package.h>
 #include <zypp/PoolItem.h>
 #include <zypp/ui/Selectable.h>
 
+#include "Exception.h"
 #include "Logger.h"
+#include "PkgDetailsCache.h"
 #include "YQi18n.h"
 #include "utf8.h"
 #include "YQPkgChangeLogView.h"
 
 
-static const int MAX_ENTRIES = 512;
+// Number of change log entries to render at once
+static const int PAGE_SIZE = 50;
 
 
 YQPkgChangeLogView::YQPkgChangeLogView( QWidget * parent )
     : YQPkgGenericDetailsView( parent )
+    , _renderedEntries( 0 )
 {
+    _searchField = new QLineEdit( this );
+    CHECK_NEW( _searchField );
+
+    _searchField->setPlaceholderText( _( "Search in change log" ) );
+    _searchField->setClearButtonEnabled( true );
+    setViewportMargins( 0, 0, 0, _searchField->sizeHint().height() );
+
+    connect( _searchField,         SIGNAL( returnPressed()               ),
+             this,                 SLOT  ( findNext()                    ) );
+
+    connect( _searchField,         SIGNAL( textChanged( const QString & ) ),
+             this,                 SLOT  ( findFirst()                   ) );
+
+    connect( verticalScrollBar(),  SIGNAL( valueChanged( int ) ),
+             this,                 SLOT  ( scrolled    ( int ) ) );
 }
 
 
@@ -43,6 +70,8 @@ void
 YQPkgChangeLogView::showDetails( ZyppSel selectable )
 {
     _selectable = selectable;
+    _entries.clear();
+    _renderedEntries = 0;
 
     if ( ! selectable )
     {
@@ -59,16 +88,13 @@ YQPkgChangeLogView::showDetails( ZyppSel selectable )
 
     if ( installed )
     {
-        html += changeLogTable( installed->changelog() );
+        zypp::Changelog changeLog = PkgDetailsCache::instance()->changeLog( installed );
+        _entries.assign( changeLog.begin(), changeLog.end() );
 
-        int omittedCount = installed->changelog().size() - MAX_ENTRIES;
+        _renderedEntries = std::min( PAGE_SIZE, (int) _entries.size() );
 
-        if ( omittedCount > 0)
-        {
-            html.append( "<p class='note'>"
-                         + omittedEntries( omittedCount, installed->name() )
-                         + "</p>" );
-        }
+        if ( _renderedEntries > 0 )
+            html += table( changeLogRows( 0, _renderedEntries ) );
     }
     else
     {
@@ -76,50 +102,152 @@ YQPkgChangeLogView::showDetails( ZyppSel selectable )
     }
 
     html += htmlEnd();
+
+    // Not setDetailsHtml(): The HTML cache can't restore the rendering state
+
     setHtml( html );
+
+    if ( _renderedEntries < (int) _entries.size() )
+        QTimer::singleShot( 0, this, SLOT( fillViewport() ) );
 }
 
 
 
-QString YQPkgChangeLogView::changeLogTable( const zypp::Changelog & changeLog ) const
+QString YQPkgChangeLogView::changeLogRows( int first, int last ) const
 {
-    // logVerbose () << "Changelog size: " << changeLog.size() << " entries" << endl;
-
     QString html;
-    int count = 0;
 
-    for ( zypp::Changelog::const_iterator it = changeLog.begin();
-	  it != changeLog.end();
-	  ++it )
+    for ( int i = first; i < last && i < (int) _entries.size(); ++i )
     {
-	QString changes = htmlEscape( fromUTF8( (*it).text() ) );
+        const zypp::ChangelogEntry & entry = _entries[ i ];
+
+	QString changes = htmlEscape( fromUTF8( entry.text() ) );
 	changes.replace( "\n", "<br>"  );
-	changes.replace( " ", "&nbsp;" );
 
-	html += row( cell( (*it).date()   ) +   // cell() calls htmlEscape()!
-                     cell( (*it).author() ) +
+        // Keep the indentation, but leave single blanks alone so the
+        // search can find phrases
+	changes.replace( "  ", "&nbsp; " );
+
+	html += row( cell( entry.date()   ) +   // cell() calls htmlEscape()!
+                     cell( entry.author() ) +
                      "<td valign='top'>" + changes + "</td>"
                      );
+    }
+
+    return html;
+}
+
+
+void
+YQPkgChangeLogView::appendPage()
+{
+    if ( _renderedEntries >= (int) _entries.size() )
+        return;
+
+    int last = std::min( _renderedEntries + PAGE_SIZE, (int) _entries.size() );
+
+    QTextCursor cursor( document() );
+    cursor.movePosition( QTextCursor::End );
+    cursor.insertHtml( table( changeLogRows( _renderedEntries, last ) ) );
+
+    _renderedEntries = last;
+}
+
+
+void
+YQPkgChangeLogView::renderUpTo( int entry )
+{
+    while ( _renderedEntries <= entry && _renderedEntries < (int) _entries.size() )
+        appendPage();
+}
+
+
+void
+YQPkgChangeLogView::scrolled( int value )
+{
+    QScrollBar * scrollBar = verticalScrollBar();
 
-        if ( ++count == MAX_ENTRIES )
-            break;
+    if ( value >= scrollBar->maximum() - scrollBar->pageStep() / 2 )
+        appendPage();
+}
+
+
+void
+YQPkgChangeLogView::fillViewport()
+{
+    while ( verticalScrollBar()->maximum() == 0 &&
+            _renderedEntries < (int) _entries.size() )
+    {
+        appendPage();
     }
+}
+
+
+int
+YQPkgChangeLogView::findEntry( const QString & text, int first ) const
+{
+    for ( int i = first; i < (int) _entries.size(); ++i )
+    {
+        const zypp::ChangelogEntry & entry = _entries[ i ];
+
+        if ( fromUTF8( entry.text()   ).contains( text, Qt::CaseInsensitive ) ||
+             fromUTF8( entry.author() ).contains( text, Qt::CaseInsensitive )   )
+        {
+            return i;
+        }
+    }
+
+    return -1;
+}
 
-    return html.isEmpty() ? "" : table( html );
+
+void
+YQPkgChangeLogView::findFirst()
+{
+    moveCursor( QTextCursor::Start );
+    findNext();
 }
 
 
-QString YQPkgChangeLogView::omittedEntries( int                 omittedCount,
-                                            const std::string & pkgName )
+void
+YQPkgChangeLogView::findNext()
 {
-    QString rpmCmd = QString( "rpm -q --changelog %1" ).arg( fromUTF8( pkgName ) );
+    QString text = _searchField->text();
+
+    if ( text.isEmpty() )
+        return;
 
-    QString msg = _( "(%1 more; run \"%2\" to see the complete change log)" )
-        .arg( omittedCount )
-        .arg( rpmCmd );
+    if ( find( text ) )
+        return;
 
-    msg = QString( "<i>" ) + msg + "</i>";
+    // Not in the rendered part after the cursor: Render up to the next
+    // entry that contains the text.
 
-    return msg;
+    int entry = findEntry( text, _renderedEntries );
+
+    if ( entry >= 0 )
+    {
+        renderUpTo( entry );
+
+        if ( find( text ) )
+            return;
+    }
+
+    // Wrap around
+
+    moveCursor( QTextCursor::Start );
+    find( text );
 }
 
+
+void
+YQPkgChangeLogView::resizeEvent( QResizeEvent * event )
+{
+    YQPkgGenericDetailsView::resizeEvent( event );
+
+    QRect rect   = contentsRect();
+    int   height = _searchField->sizeHint().height();
+
+    _searchField->setGeometry( rect.left(), rect.bottom() - height + 1,
+                               rect.width(), height );
+}
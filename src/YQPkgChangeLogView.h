@@ -18,17 +18,29 @@
 #ifndef YQPkgChangeLogView_h
 #define YQPkgChangeLogView_h
 
+#include <vector>
+
 #include <zypp/Changelog.h>
 #include "YQPkgGenericDetailsView.h"
 #include "YQZypp.h"
 
 
+class QLineEdit;
+class QResizeEvent;
+
 using std::list;
 using std::string;
 
 
 /**
- * Display a pkg's file list
+ * Display a pkg's change log.
+ *
+ * Only the first page of entries is rendered right away; older entries are
+ * appended when the user scrolls down to the end. The change log itself is
+ * fetched only once per package (see PkgDetailsCache).
+ *
+ * A search field below the text finds text in all entries, rendering more
+ * pages as needed.
  **/
 class YQPkgChangeLogView : public YQPkgGenericDetailsView
 {
@@ -54,19 +66,68 @@ public:
      **/
     virtual void showDetails( ZyppSel selectable );
 
+
+protected slots:
+
+    /**
+     * Append the next page of entries if the user scrolled to the end.
+     **/
+    void scrolled( int value );
+
+    /**
+     * Append pages until the view can be scrolled or all entries are
+     * rendered.
+     **/
+    void fillViewport();
+
+    /**
+     * Find the next occurrence of the text in the search field, starting
+     * at the current cursor position and wrapping around at the end.
+     **/
+    void findNext();
+
+    /**
+     * Find the first occurrence of the text in the search field.
+     **/
+    void findFirst();
+
+
 protected:
 
     /**
-     * Format a change log list in HTML
+     * Format change log entries [first, last) as HTML table rows.
+     **/
+    QString changeLogRows( int first, int last ) const;
+
+    /**
+     * Append the next page of entries to the document.
      **/
-    QString changeLogTable( const zypp::Changelog & changeLog ) const;
+    void appendPage();
 
     /**
-     * Format an info message about not displayed changes
-     * and return the ranslated message.
-     */
-    QString omittedEntries( int                 omittedCount,
-                            const std::string & pkgName );
+     * Render all entries up to and including 'entry'.
+     **/
+    void renderUpTo( int entry );
+
+    /**
+     * Return the index of the first entry from 'first' on that contains
+     * 'text' or -1 if there is none.
+     **/
+    int findEntry( const QString & text, int first ) const;
+
+    /**
+     * Position the search field below the text.
+     *
+     * Reimplemented from QWidget.
+     **/
+    virtual void resizeEvent( QResizeEvent * event ) override;
+
+
+    // Data members
+
+    std::vector<zypp::ChangelogEntry> _entries;
+    int                               _renderedEntries;
+    QLineEdit *                       _searchField;
 };
 
 
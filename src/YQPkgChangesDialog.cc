@@ -29,9 +29,11 @@
 
 #include "Logger.h"
 #include "MainWindow.h"
+#include "PkgIndex.h"
 #include "QY2CursorHelper.h"
 #include "QY2IconLoader.h"
 #include "QY2LayoutUtils.h"
+#include "SelectableIds.h"
 #include "YQPkgList.h"
 #include "YQZypp.h"
 #include "YQi18n.h"
@@ -229,11 +231,13 @@ YQPkgChangesDialog::filter( const QRegularExpression & regexp, Filters flt )
     if ( ! byUser || ! byApp )
         ignoredNames = zypp::ui::userWantedPackageNames();
 
-    for ( ZyppPoolIterator it = zyppPkgBegin();
-          it != zyppPkgEnd();
-          ++it )
+    // Only packages with a pending change are candidates
+
+    PkgBitset toModify = PkgIndex::instance()->withStatus( PkgIndex::toModifyMask() );
+
+    for ( int id = toModify.next( 0 ); id >= 0; id = toModify.next( id + 1 ) )
     {
-        ZyppSel selectable = *it;
+        ZyppSel selectable = SelectableIds::selectable( id );
 
         if ( selectable->toModify() )
         {
@@ -28,6 +28,9 @@
 #include <zypp/ui/Selectable.h>
 
 #include "Logger.h"
+#include "PkgIndex.h"
+#include "PoolGeneration.h"
+#include "SelectableIds.h"
 #include "YQi18n.h"
 #include "YQPkgClassificationFilterView.h"
 
@@ -131,7 +134,7 @@ YQPkgClassificationFilterView::filter()
 
     emit filterStart();
 
-    if ( selectedPkgClass() != YQPkgClassNone )
+    if ( selectedPkgClass() != YQPkgClassNone && ! indexFilter() )
     {
 	for ( ZyppPoolIterator it = zyppPkgBegin();
 	      it != zyppPkgEnd();
@@ -174,6 +177,50 @@ YQPkgClassificationFilterView::filter()
 }
 
 
+bool
+YQPkgClassificationFilterView::indexFilter()
+{
+    PkgIndex::Flags flags = 0;
+
+    switch ( selectedPkgClass() )
+    {
+        case YQPkgClassMultiversion:            flags = PkgIndex::Multiversion;         break;
+        case YQPkgClassRetracted:               flags = PkgIndex::Retracted;            break;
+        case YQPkgClassRetractedInstalled:      flags = PkgIndex::RetractedInstalled;   break;
+        case YQPkgClassAll:                     flags = 0;                              break;
+
+        default:
+            // The solver-related classes are a property of each individual
+            // package, not of the selectable
+            return false;
+    }
+
+    PkgBitset matches = PkgIndex::instance()->withFlags( flags );
+
+    for ( int id = matches.next( 0 ); id >= 0; id = matches.next( id + 1 ) )
+    {
+        ZyppSel selectable = SelectableIds::selectable( id );
+
+        // Same preference as in filter(): installed, candidate, anything else
+
+        ZyppObj zyppObj = selectable->installedObj();
+
+        if ( ! zyppObj )
+            zyppObj = selectable->candidateObj();
+
+        if ( ! zyppObj )
+            zyppObj = selectable->theObj();
+
+        ZyppPkg zyppPkg = tryCastToZyppPkg( zyppObj );
+
+        if ( zyppPkg )
+            emit filterMatch( selectable, zyppPkg );
+    }
+
+    return true;
+}
+
+
 void
 YQPkgClassificationFilterView::slotSelectionChanged( QTreeWidgetItem * newSelection )
 {
@@ -201,6 +248,7 @@ YQPkgClassificationFilterView::slotSelectionChanged( QTreeWidgetItem * newSelect
 	{
 	    QApplication::setOverrideCursor(Qt::WaitCursor);
 	    zypp::getZYpp()->resolver()->resolvePool();
+	    PoolGeneration::invalidate();
 	    QApplication::restoreOverrideCursor();
 	}
     }
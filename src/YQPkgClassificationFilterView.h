@@ -126,6 +126,15 @@ protected:
 
     void fillPkgClasses();
 
+    /**
+     * Filter with the PkgIndex if the selected package class can be decided
+     * for the selectable as a whole. Emit filterMatch() for each match.
+     *
+     * Returns 'false' if that is not possible for the selected package
+     * class, i.e. if each package needs to be checked individually.
+     **/
+    bool indexFilter();
+
 };
 
 
@@ -33,9 +33,12 @@
 #include <QBoxLayout>
 
 #include "BusyPopup.h"
+#include "Exception.h"
 #include "Logger.h"
 #include "MainWindow.h"
+#include "PoolGeneration.h"
 #include "QY2LayoutUtils.h"
+#include "SolverWorker.h"
 #include "WindowSettings.h"
 #include "YQPkgConflictList.h"
 #include "YQPkgConflictDialog.h"
@@ -50,6 +53,7 @@ YQPkgConflictDialog * YQPkgConflictDialog::_instance = 0;
 
 YQPkgConflictDialog::YQPkgConflictDialog( QWidget * parent )
     : QDialog( parent ? parent : MainWindow::instance() )
+    , _solverWorker( 0 )
 {
     if ( ! _instance )
         _instance = this;
@@ -211,6 +215,73 @@ YQPkgConflictDialog::verifySystemWithBusyPopup()
 }
 
 
+void
+YQPkgConflictDialog::verifySystemInBackground()
+{
+    if ( ! _solverWorker )
+    {
+        _solverWorker = new SolverWorker( this );
+        CHECK_NEW( _solverWorker );
+
+        connect( _solverWorker, SIGNAL( finished            ( bool, int ) ),
+                 this,          SLOT  ( solverWorkerFinished( bool, int ) ) );
+
+        connect( _solverWorker, SIGNAL( failed()             ),
+                 this,          SLOT  ( solverWorkerFailed() ) );
+    }
+
+    if ( _solverWorker->isRunning() )
+        return;
+
+    emit backgroundVerifyStarted();
+    _solverWorker->start(); // This might emit failed() right away
+}
+
+
+void
+YQPkgConflictDialog::cancelBackgroundVerify()
+{
+    if ( ! _solverWorker || ! _solverWorker->isRunning() )
+        return;
+
+    logInfo() << "Background system verification canceled" << endl;
+    _solverWorker->cancel();
+
+    emit backgroundVerifyFinished();
+}
+
+
+void
+YQPkgConflictDialog::solverWorkerFinished( bool success, int changes )
+{
+    emit backgroundVerifyFinished();
+
+    if ( success && changes == 0 )
+    {
+        logInfo() << "System dependencies verified in the background: OK" << endl;
+        return;
+    }
+
+    // Something to show: Do it again in this process for the real problems
+    // and their solutions, or for the solver's changes in the package lists.
+
+    logInfo() << "System verification in the background found "
+              << ( success ? "changes" : "problems" ) << endl;
+
+    verifySystemWithBusyPopup();
+}
+
+
+void
+YQPkgConflictDialog::solverWorkerFailed()
+{
+    emit backgroundVerifyFinished();
+
+    logWarning() << "System verification in the background failed; "
+                 << "not verifying the system at all" << endl;
+}
+
+
 
 int
 YQPkgConflictDialog::doPackageUpdate()
@@ -268,6 +339,7 @@ YQPkgConflictDialog::processSolverResult( bool success )
 {
     // Package states may have changed: The solver may have set packages to
     // autoInstall or autoUpdate. Make those changes known.
+    PoolGeneration::invalidate();
     emit updatePackages();
 
     normalCursor();
@@ -22,6 +22,7 @@
 #include <QDialog>
 
 class YQPkgConflictList;
+class SolverWorker;
 class QMenu;
 
 
@@ -99,6 +100,24 @@ public slots:
      **/
     int verifySystemWithBusyPopup();
 
+    /**
+     * Verify the system dependencies in a worker process without blocking
+     * the GUI. This returns immediately; backgroundVerifyFinished() is
+     * emitted when done.
+     *
+     * Only if the worker process finds any problems or any changes by the
+     * solver, verifySystem() is run in this process to show them in this
+     * dialog: The problems and their solutions can only be applied to the
+     * pool of this process.
+     **/
+    void verifySystemInBackground();
+
+    /**
+     * Cancel a running verifySystemInBackground(). This still emits
+     * backgroundVerifyFinished().
+     **/
+    void cancelBackgroundVerify();
+
     /**
      * Update all installed packages that can be updated without a problem.
      * This is the counterpart to 'zypper up'.
@@ -137,6 +156,30 @@ signals:
      **/
     void updatePackages();
 
+    /**
+     * Emitted when verifySystemInBackground() starts.
+     **/
+    void backgroundVerifyStarted();
+
+    /**
+     * Emitted when verifySystemInBackground() is finished or canceled.
+     **/
+    void backgroundVerifyFinished();
+
+
+protected slots:
+
+    /**
+     * Notification that the solver worker process finished.
+     **/
+    void solverWorkerFinished( bool success, int changes );
+
+    /**
+     * Notification that the solver worker process could not deliver a
+     * result.
+     **/
+    void solverWorkerFailed();
+
 
 protected:
 
@@ -159,6 +202,7 @@ protected:
 
     YQPkgConflictList * _conflictList;
     QMenu *             _expertMenu;
+    SolverWorker *      _solverWorker;
 
     static YQPkgConflictDialog * _instance;
 };
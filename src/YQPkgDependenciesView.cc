@@ -14,21 +14,75 @@
     Textdomain "qt-pkg"
  */
 
+
+#include <QFont>
+#include <QHash>
+#include <QHeaderView>
+#include <QLabel>
+#include <QSet>
+#include <QTabWidget>
+#include <QTreeWidget>
+#include <QVBoxLayout>
+
 #include <zypp/Capability.h>
 #include <zypp/Dep.h>
 #include <zypp/Edition.h>
 #include <zypp/PoolItem.h>
 #include <zypp/ResObject.h>
 #include <zypp/ResTraits.h>
+#include <zypp/sat/WhatProvides.h>
 #include <zypp/ui/Selectable.h>
 
+#include "Exception.h"
+#include "PkgDetailsCache.h"
+#include "YQPkgGenericDetailsView.h"
 #include "YQi18n.h"
+#include "utf8.h"
 #include "YQPkgDependenciesView.h"
 
 
+// Item data roles
+#define DepRole         Qt::UserRole
+#define PopulatedRole   ( Qt::UserRole + 1 )
+#define CapIdRole       ( Qt::UserRole + 2 )
+
+
 YQPkgDependenciesView::YQPkgDependenciesView( QWidget * parent )
-    : YQPkgGenericDetailsView( parent )
+    : QWidget( parent )
+    , _parentTab( dynamic_cast<QTabWidget *>( parent ) )
 {
+    QVBoxLayout * layout = new QVBoxLayout( this );
+    CHECK_NEW( layout );
+    layout->setContentsMargins( 0, 0, 0, 0 );
+
+    _heading = new QLabel( this );
+    CHECK_NEW( _heading );
+    _heading->setTextFormat( Qt::RichText );
+    layout->addWidget( _heading );
+
+    _tree = new QTreeWidget( this );
+    CHECK_NEW( _tree );
+
+    _tree->setColumnCount( 2 );
+    _tree->setHeaderHidden( true );
+    _tree->setUniformRowHeights( true ); // Important for thousands of provides
+    _tree->setFrameStyle( QFrame::NoFrame );
+    _tree->header()->setSectionResizeMode( 0, QHeaderView::Stretch );
+    _tree->header()->setSectionResizeMode( 1, QHeaderView::ResizeToContents );
+    _tree->header()->setStretchLastSection( false );
+    layout->addWidget( _tree );
+
+    connect( _tree, SIGNAL( itemExpanded( QTreeWidgetItem * ) ),
+             this,  SLOT  ( populate    ( QTreeWidgetItem * ) ) );
+
+    connect( _tree, SIGNAL( itemActivated( QTreeWidgetItem *, int ) ),
+             this,  SLOT  ( showProvider ( QTreeWidgetItem *      ) ) );
+
+    if ( _parentTab )
+    {
+        connect( _parentTab, SIGNAL( currentChanged( int ) ),
+                 this,       SLOT  ( reloadTab     ( int ) ) );
+    }
 }
 
 
@@ -38,143 +92,256 @@ YQPkgDependenciesView::~YQPkgDependenciesView()
 }
 
 
+void
+YQPkgDependenciesView::reloadTab( int newCurrent )
+{
+    if ( _parentTab && _parentTab->widget( newCurrent ) == this )
+        showDetailsIfVisible( _selectable );
+}
+
+
+void
+YQPkgDependenciesView::showDetailsIfVisible( ZyppSel selectable )
+{
+    _selectable = selectable;
+
+    if ( _parentTab )  // Is this view embedded into a tab widget?
+    {
+        if ( _parentTab->currentWidget() == this )  // Is this page the topmost?
+            showDetails( selectable );
+    }
+    else  // No tab parent - simply show data unconditionally.
+    {
+        showDetails( selectable );
+    }
+}
+
+
 void
 YQPkgDependenciesView::showDetails( ZyppSel selectable )
 {
     _selectable = selectable;
+    _providers.clear();
+    _tree->clear();
 
     if ( ! selectable )
     {
-	clear();
+        _heading->clear();
+        _candidate = ZyppObj();
+        _installed = ZyppObj();
+
 	return;
     }
 
-    QString html_text = htmlStart();
-    html_text += htmlHeading( selectable );
+    _candidate = selectable->candidateObj();
+    _installed = selectable->installedObj();
+
+    if ( _candidate == _installed )
+        _installed = ZyppObj();
 
-    ZyppObj candidate = selectable->candidateObj();
-    ZyppObj installed = selectable->installedObj();
+    QString heading = YQPkgGenericDetailsView::htmlHeading( selectable );
 
-    if ( candidate && installed && candidate != installed )
+    if ( _candidate && _installed )
     {
-	html_text += complexTable( installed, candidate );
+        heading += _( "Alternate Version" ) + ": " + fromUTF8( _candidate->edition().asString() ) + "<br>"
+            +      _( "Installed Version" ) + ": " + fromUTF8( _installed->edition().asString() );
     }
-    else
+    else if ( _candidate || _installed )
     {
-	if ( candidate )
-	    html_text += simpleTable( candidate );
-
-	if ( installed )
-	    html_text += simpleTable( installed );
+        ZyppObj obj = _candidate ? _candidate : _installed;
+        heading += _( "Version:" ) + " " + fromUTF8( obj->edition().asString() );
     }
 
-    html_text += htmlEnd();
-
-    setHtml( html_text );
+    _heading->setText( heading );
+
+    addSection( _( "Provides:"    ), zypp::Dep::PROVIDES    );
+    addSection( _( "Prerequires:" ), zypp::Dep::PREREQUIRES );
+    addSection( _( "Requires:"    ), zypp::Dep::REQUIRES    );
+    addSection( _( "Conflicts:"   ), zypp::Dep::CONFLICTS   );
+    addSection( _( "Obsoletes:"   ), zypp::Dep::OBSOLETES   );
+    addSection( _( "Recommends:"  ), zypp::Dep::RECOMMENDS  );
+    addSection( _( "Suggests:"    ), zypp::Dep::SUGGESTS    );
+    addSection( _( "Enhances:"    ), zypp::Dep::ENHANCES    );
+    addSection( _( "Supplements:" ), zypp::Dep::SUPPLEMENTS );
 }
 
 
-QString
-YQPkgDependenciesView::simpleTable( ZyppObj pkg )
+void
+YQPkgDependenciesView::addSection( const QString & heading, zypp::Dep dep )
 {
-    QString html = "<br>" +
-	table(
-	      row( hcell( _( "Version:" ) ) + cell( pkg->edition().asString()	) ) +
-
-	      row( _("Provides:"),	pkg->dep( zypp::Dep::PROVIDES		) ) +
-	      row( _("Prerequires:"),	pkg->dep( zypp::Dep::PREREQUIRES	) ) +
-	      row( _("Requires:"),	pkg->dep( zypp::Dep::REQUIRES		) ) +
-	      row( _("Conflicts:"),	pkg->dep( zypp::Dep::CONFLICTS		) ) +
-	      row( _("Obsoletes:"),	pkg->dep( zypp::Dep::OBSOLETES		) ) +
-	      row( _("Recommends:"),	pkg->dep( zypp::Dep::RECOMMENDS		) ) +
-	      row( _("Suggests:"),	pkg->dep( zypp::Dep::SUGGESTS		) ) +
-	      row( _("Enhances:"),	pkg->dep( zypp::Dep::ENHANCES		) ) +
-	      row( _("Supplements:"),	pkg->dep( zypp::Dep::SUPPLEMENTS	) )
-	      );
-
-    return html;
-}
+    PkgDetailsCache * cache = PkgDetailsCache::instance();
 
+    QStringList candidateCaps = cache->dependencies( _candidate, dep );
+    QStringList installedCaps = cache->dependencies( _installed, dep );
 
-QString
-YQPkgDependenciesView::complexTable( ZyppObj installed, ZyppObj candidate )
-{
-    ZyppObj p1 = candidate;
-    ZyppObj p2 = installed;
-
-    QString p1_header = _( "<b>Alternate Version</b>" );
-    QString p2_header = _( "<b>Installed Version</b>" );
-
-    QString html = "<br>" +
-	table(
-	      row( hcell( QString( "" ) ) + hcell( "<b>" + p1_header + "</b>"	    ) + hcell( "<b>" + p2_header + "</b>" ) ) +
-
-	      row( hcell( _( "Version:" ) ) + cell( p1->edition().asString()	) + cell( p2->edition().asString()	) ) +
-
-	      row( _("Provides:"),	p1->dep( zypp::Dep::PROVIDES	), p2->dep( zypp::Dep::PROVIDES		) ) +
-	      row( _("Prerequires:"),	p1->dep( zypp::Dep::PREREQUIRES	), p2->dep( zypp::Dep::PREREQUIRES	) ) +
-	      row( _("Requires:"),	p1->dep( zypp::Dep::REQUIRES	), p2->dep( zypp::Dep::REQUIRES		) ) +
-	      row( _("Conflicts:"),	p1->dep( zypp::Dep::CONFLICTS	), p2->dep( zypp::Dep::CONFLICTS	) ) +
-	      row( _("Obsoletes:"),	p1->dep( zypp::Dep::OBSOLETES	), p2->dep( zypp::Dep::OBSOLETES	) ) +
-	      row( _("Recommends:"),	p1->dep( zypp::Dep::RECOMMENDS	), p2->dep( zypp::Dep::RECOMMENDS	) ) +
-	      row( _("Suggests:"),	p1->dep( zypp::Dep::SUGGESTS	), p2->dep( zypp::Dep::SUGGESTS		) ) +
-	      row( _("Enhances:"),	p1->dep( zypp::Dep::ENHANCES	), p2->dep( zypp::Dep::ENHANCES		) ) +
-	      row( _("Supplements:"),	p1->dep( zypp::Dep::SUPPLEMENTS	), p2->dep( zypp::Dep::SUPPLEMENTS	) )
-	      );
-
-    return html;
+    // Count the rows like addCapabilities() creates them: the installed
+    // capabilities only if the candidate doesn't have them as well
+
+    QSet<QString> candidateSet( candidateCaps.begin(), candidateCaps.end() );
+    int count = candidateCaps.size();
+
+    for ( const QString & cap: installedCaps )
+    {
+        if ( ! candidateSet.contains( cap ) )
+            ++count;
+    }
+
+    if ( count == 0 )
+        return;
+
+    QString text = heading;
+    text.remove( ':' );
+
+    QTreeWidgetItem * section = new QTreeWidgetItem( _tree, SectionItem );
+    CHECK_NEW( section );
+
+    section->setText( 0, QString( "%1 (%2)" ).arg( text ).arg( count ) );
+    section->setData( 0, DepRole, fromUTF8( dep.asString() ) );
+    section->setChildIndicatorPolicy( QTreeWidgetItem::ShowIndicator );
+    section->setFirstColumnSpanned( true );
+
+    QFont font = section->font( 0 );
+    font.setBold( true );
+    section->setFont( 0, font );
 }
 
 
-QString
-YQPkgDependenciesView::row( const QString & heading,
-			    const ZyppCap & capSet )
+void
+YQPkgDependenciesView::populate( QTreeWidgetItem * item )
 {
-    QString content = htmlLines( capSet );
+    if ( ! item || item->data( 0, PopulatedRole ).toBool() )
+        return;
+
+    item->setData( 0, PopulatedRole, true );
+
+    switch ( item->type() )
+    {
+        case SectionItem:
+            addCapabilities( item, zypp::Dep( toUTF8( item->data( 0, DepRole ).toString() ) ) );
+            break;
+
+        case CapabilityItem:
+            addProviders( item );
+            break;
 
-    if ( content.isEmpty() )
-	return "";
+        default:
+            break;
+    }
 
-    return QString( "<tr>" ) +
-	hcell( heading ) +
-	"<td>" + content + "</td>"
-	+ "</tr>";
+    if ( item->childCount() == 0 )
+        item->setChildIndicatorPolicy( QTreeWidgetItem::DontShowIndicatorWhenChildless );
 }
 
 
-QString
-YQPkgDependenciesView::row( const QString & heading,
-			    const ZyppCap & capSet1,
-			    const ZyppCap & capSet2 )
+void
+YQPkgDependenciesView::addCapabilities( QTreeWidgetItem * section, zypp::Dep dep )
 {
-    QString content1 = htmlLines( capSet1 );
-    QString content2 = htmlLines( capSet2 );
+    PkgDetailsCache * cache = PkgDetailsCache::instance();
+
+    // The providers are looked up by the ID of the capability, not by its
+    // string: Rich (boolean) and namespace dependencies don't survive
+    // parsing their display string again.
 
-    if ( content1.isEmpty() && content2.isEmpty() )
-	return "";
+    QHash<QString, zypp::sat::detail::IdType> capIds;
+
+    auto capabilities = [&]( ZyppObj obj )
+    {
+        QStringList caps;
 
-    return QString( "<tr>" ) +
-	hcell( heading ) +
-	"<td>" + content1 + "</td>" +
-	"<td>" + content2 + "</td>" +
-	"</tr>";
+        if ( obj )
+        {
+            for ( const zypp::Capability & cap: obj->dep( dep ) )
+            {
+                QString str = cache->capabilityString( cap );
+                capIds.insert( str, cap.id() );
+                caps << str;
+            }
+        }
+
+        return caps;
+    };
+
+    QStringList candidateCaps = capabilities( _candidate );
+    QStringList installedCaps = capabilities( _installed );
+
+    bool          both          = _candidate && _installed;
+    QSet<QString> candidateSet;
+    QSet<QString> installedSet;
+
+    if ( both )
+    {
+        candidateSet = QSet<QString>( candidateCaps.begin(), candidateCaps.end() );
+        installedSet = QSet<QString>( installedCaps.begin(), installedCaps.end() );
+    }
+
+    QList<QTreeWidgetItem *> items;
+
+    auto addItem = [&]( const QString & cap, const QString & where )
+    {
+        QTreeWidgetItem * item = new QTreeWidgetItem( CapabilityItem );
+        CHECK_NEW( item );
+
+        item->setText( 0, cap );
+        item->setText( 1, where );
+        item->setData( 0, CapIdRole, (int) capIds.value( cap ) );
+        item->setChildIndicatorPolicy( QTreeWidgetItem::ShowIndicator );
+        items << item;
+    };
+
+    for ( const QString & cap: candidateCaps )
+        addItem( cap, both && ! installedSet.contains( cap ) ? _( "Alternate" ) : "" );
+
+    for ( const QString & cap: installedCaps )
+    {
+        if ( ! candidateSet.contains( cap ) )
+            addItem( cap, both ? _( "Installed" ) : "" );
+    }
+
+    // Adding all children at once is much faster than one by one
+
+    section->addChildren( items );
 }
 
 
-QString
-YQPkgDependenciesView::htmlLines( const ZyppCap & capSet )
+void
+YQPkgDependenciesView::addProviders( QTreeWidgetItem * item )
 {
-    QString html;
+    // The providers of each capability are precomputed in the solver pool,
+    // so this is a direct lookup.
+
+    zypp::Capability         cap( (zypp::sat::detail::IdType) item->data( 0, CapIdRole ).toInt() );
+    zypp::sat::WhatProvides  providers( cap );
+    QList<QTreeWidgetItem *> items;
 
-    for ( ZyppCap::const_iterator it = capSet.begin();
-	  it != capSet.end();
-	  ++it )
+    for ( const zypp::sat::Solvable & solvable: providers )
     {
-	if ( ! html.isEmpty() )
-	    html += "<br>";
+        ZyppSel selectable = zypp::ui::Selectable::get( solvable );
 
-	html += htmlEscape( ( *it).asString().c_str() );
+        if ( ! selectable )
+            continue;
+
+        QTreeWidgetItem * provider = new QTreeWidgetItem( ProviderItem );
+        CHECK_NEW( provider );
+
+        provider->setText( 0, QString( "%1-%2" )
+                           .arg( fromUTF8( solvable.name() ) )
+                           .arg( fromUTF8( solvable.edition().asString() ) ) );
+        provider->setText( 1, fromUTF8( solvable.repository().alias() ) );
+        provider->setToolTip( 0, _( "Activate to show the dependencies of this package" ) );
+
+        _providers.insert( provider, selectable );
+        items << provider;
     }
 
-    return html;
+    item->addChildren( items );
+}
+
+
+void
+YQPkgDependenciesView::showProvider( QTreeWidgetItem * item )
+{
+    ZyppSel selectable = _providers.value( item );
+
+    if ( selectable && selectable != _selectable )
+        showDetails( selectable );
 }
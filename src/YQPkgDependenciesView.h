@@ -18,19 +18,34 @@
 #ifndef YQPkgDependenciesView_h
 #define YQPkgDependenciesView_h
 
+#include <QHash>
+#include <QStringList>
+#include <QWidget>
+#include <zypp/Dep.h>
+
 #include "YQZypp.h"
-#include "YQPkgGenericDetailsView.h"
 
 
-typedef zypp::Capabilities ZyppCap;
+class QLabel;
+class QTabWidget;
+class QTreeWidget;
+class QTreeWidgetItem;
 
 
 /**
- * Display technical details ( very much like 'rpm -qi' ) for a zypp::Package
- * object - the installed instance, the candidate instance or both ( in two
- * columns ) if both exist. All other available instances are ignored.
+ * Browser for the dependencies of a zypp::ResObject: The installed
+ * instance, the candidate instance or both (in that case, each capability
+ * is marked if it belongs to only one of them). All other available
+ * instances are ignored.
+ *
+ * There is one collapsible section for each kind of dependency; its
+ * capabilities are only added when it is expanded. Expanding a capability
+ * shows its providers, and activating a provider shows its dependencies.
+ *
+ * Like the other details views, this only updates its content if it is
+ * visible at all: It may be hidden if it's part of a QTabWidget.
  **/
-class YQPkgDependenciesView : public YQPkgGenericDetailsView
+class YQPkgDependenciesView : public QWidget
 {
     Q_OBJECT
 
@@ -41,71 +56,84 @@ public:
      **/
     YQPkgDependenciesView( QWidget * parent );
 
-
     /**
      * Destructor
      **/
     virtual ~YQPkgDependenciesView();
 
 
-protected:
+public slots:
 
     /**
-     * Show details for the specified selectable:
-     * In this case technical data, very much like "rpm -qi".
-     * Overwritten from YQPkgGenericDetailsView.
+     * Show the dependencies of the specified selectable.
+     * Delayed display if this is embedded into a QTabWidget parent:
+     * In this case, wait until this page becomes visible.
      **/
-    virtual void showDetails( ZyppSel selectable );
+    void showDetailsIfVisible( ZyppSel selectable );
 
     /**
-     * Returns a string containing a HTML table for technical details for one
-     * package.
+     * Show the dependencies of the specified selectable.
      **/
-    QString simpleTable( ZyppObj pkg );
+    void showDetails( ZyppSel selectable );
+
 
+protected slots:
 
     /**
-     * Returns a string containing a HTML table for technical details for two
-     * package instances: The installed instance and an alternate instance.
-     * (usually the candidate instance).
+     * Show the dependencies if the page with index 'newCurrent' of the
+     * parent tab widget is this view.
      **/
-    QString complexTable( ZyppObj installed,
-			  ZyppObj candidate );
+    void reloadTab( int newCurrent );
 
     /**
-     * Format a zypp::CapSet (describing zypp::Dep::REQUIRES etc.)
-     * with a heading in HTML lines.
-     *
-     * Returns an empty string if capSet is empty.
+     * Add the children of 'item' if that wasn't done yet: The capabilities
+     * of a section or the providers of a capability.
      **/
-    static QString row( const QString &	heading,
-			const ZyppCap & capSet );
+    void populate( QTreeWidgetItem * item );
 
+    /**
+     * Show the dependencies of the provider 'item' if it is one.
+     **/
+    void showProvider( QTreeWidgetItem * item );
+
+
+protected:
+
+    enum ItemType
+    {
+        SectionItem = QTreeWidgetItem::UserType,
+        CapabilityItem,
+        ProviderItem
+    };
 
     /**
-     * Format two ZyppCap (describing zypp::Dep::REQUIRES etc.)
-     * with a heading in HTML lines.
-     *
-     * Returns an empty string both capSets are empty.
+     * Add a section for dependency kind 'dep' with heading 'heading' if
+     * there are any dependencies of that kind.
      **/
-    static QString row( const QString & heading,
-			const ZyppCap & capSet1,
-			const ZyppCap & capSet2 );
+    void addSection( const QString & heading, zypp::Dep dep );
 
     /**
-     * Returns a string containing a HTML table row with 'contents'.
-     *
-     * Required here to avoid inheritance ambiguities.
+     * Add the capabilities of dependency kind 'dep' to 'section'.
      **/
-    static QString row( const QString & contents )
-	{ return YQPkgGenericDetailsView::row( contents ); }
+    void addCapabilities( QTreeWidgetItem * section, zypp::Dep dep );
 
     /**
-     * Format a ZyppCap (describing zypp::Dep::REQUIRES etc.)
-     * in HTML lines, separated with <BR>.
-     * Returns an empty string if capSet is empty.
+     * Add the providers of the capability of 'item' to 'item'.
      **/
-    static QString htmlLines( const ZyppCap & capSet );
+    void addProviders( QTreeWidgetItem * item );
+
+
+    // Data members
+
+    QTabWidget *  _parentTab;
+    ZyppSel       _selectable;
+    ZyppObj       _candidate;
+    ZyppObj       _installed;
+
+    QLabel *      _heading;
+    QTreeWidget * _tree;
+
+    QHash<QTreeWidgetItem *, ZyppSel> _providers;
 };
 
 
@@ -27,7 +27,9 @@
 #include <zypp/ResObject.h>
 #include <zypp/ui/Selectable.h>
 
+#include "DesktopFileCache.h"
 #include "Logger.h"
+#include "PkgDetailsCache.h"
 #include "QY2IconLoader.h"
 #include "YQi18n.h"
 #include "utf8.h"
@@ -36,7 +38,6 @@
 #include "YQPkgDescriptionView.h"
 
 #define DESKTOP_TRANSLATIONS    "desktop_translations"
-#define DESKTOP_FILE_DIR        "\\/share\\/applications\\/.*\\.desktop$"       // RegularExpression
 
 
 using std::list;
@@ -114,13 +115,12 @@ YQPkgDescriptionView::showDetails( ZyppSel selectable )
 
     if ( installed )
     {
-        zypp::Package::FileList fileList( installed->filelist() );
-        std::list<std::string> tmp( fileList.begin(), fileList.end() );
+        std::list<std::string> tmp = PkgDetailsCache::instance()->fileList( installed );
         html_text += applicationIconList( tmp );
     }
 
     html_text += htmlEnd();
-    setHtml( html_text );
+    setDetailsHtml( html_text );
 }
 
 
@@ -198,7 +198,6 @@ QString
 YQPkgDescriptionView::applicationIconList( const list<string> & fileList ) const
 {
     QString html = "";
-    QMap<QString, QString> desktopEntries;
 
     QStringList desktopFiles = findDesktopFiles( fileList );
 
@@ -209,21 +208,14 @@ YQPkgDescriptionView::applicationIconList( const list<string> & fileList ) const
 
     for ( int i = 0; i < desktopFiles.size(); ++i )
     {
-        desktopEntries = readDesktopFile( desktopFiles[i] );
-
-        QIcon icon = QY2IconLoader::loadIcon( desktopEntries["Icon"] );
+        DesktopFileEntry entry = desktopFileEntry( desktopFiles[i] );
 
-        if ( ! icon.isNull() )
+        if ( ! entry.iconPng.isEmpty() )
         {
-            QPixmap pixmap = icon.pixmap(32);
-            QByteArray byteArray;
-            QBuffer buffer(&byteArray);
-            pixmap.save(&buffer, "PNG");
-
             html += "<tr><td valign='middle' align='center'>";
-            html += QString("<td><img src=\"data:image/png;base64,") + byteArray.toBase64() + QString( "\">" );
+            html += QString("<td><img src=\"data:image/png;base64,") + entry.iconPng + QString( "\">" );
             html += "</td><td valign='middle' align='left'>";
-            html += "<b>" + desktopEntries[ "Name" ] + "</b>";
+            html += "<b>" + entry.name + "</b>";
             html += "</td></tr>";
         }
     }
@@ -240,6 +232,39 @@ YQPkgDescriptionView::applicationIconList( const list<string> & fileList ) const
 }
 
 
+DesktopFileEntry
+YQPkgDescriptionView::desktopFileEntry( const QString & fileName ) const
+{
+    DesktopFileCache * cache = DesktopFileCache::instance();
+    DesktopFileEntry   entry;
+
+    if ( cache->lookup( fileName, _langWithCountry, entry ) )
+        return entry;
+
+    QMap<QString, QString> desktopEntries = readDesktopFile( fileName );
+
+    entry.name = desktopEntries[ "Name" ];
+    entry.exec = desktopEntries[ "Exec" ];
+    entry.icon = desktopEntries[ "Icon" ];
+
+    QIcon icon = QY2IconLoader::loadIcon( entry.icon );
+
+    if ( ! icon.isNull() )
+    {
+        QPixmap pixmap = icon.pixmap(32);
+        QByteArray byteArray;
+        QBuffer buffer(&byteArray);
+        pixmap.save(&buffer, "PNG");
+
+        entry.iconPng = byteArray.toBase64();
+    }
+
+    cache->insert( fileName, _langWithCountry, entry );
+
+    return entry;
+}
+
+
 QMap<QString, QString>
 YQPkgDescriptionView::readDesktopFile( const QString & fileName ) const
 {
@@ -292,7 +317,7 @@ YQPkgDescriptionView::findDesktopFiles( const list<string> & fileList ) const
     {
         QString line = fromUTF8( *it );
 
-        if ( line.contains( QRegularExpression( DESKTOP_FILE_DIR ) ) )
+        if ( DesktopFileCache::isDesktopFile( line ) )
             desktopFiles << line;
     }
 
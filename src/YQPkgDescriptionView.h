@@ -21,6 +21,7 @@
 
 #include <QUrl>
 
+#include "DesktopFileCache.h"
 #include "YQZypp.h"
 #include "YQPkgGenericDetailsView.h"
 
@@ -86,6 +87,13 @@ protected:
      **/
     QString findDesktopIcon ( const QString& iconName ) const;
 
+    /**
+     * Return the parsed desktop file 'fileName' with its encoded icon from
+     * the DesktopFileCache. Parse the file and encode the icon only if it is
+     * not in the cache yet.
+     **/
+    DesktopFileEntry desktopFileEntry( const QString & fileName ) const;
+
     /**
      * Extract name, icon and exec attributes from a desktop file.
      **/
@@ -15,17 +15,83 @@
  */
 
 
-#include "YQPkgFileListView.h"
+#include <QHeaderView>
+#include <QLabel>
+#include <QLineEdit>
+#include <QTabWidget>
+#include <QTreeView>
+#include <QVBoxLayout>
+
+#include <zypp/Package.h>
+#include <zypp/ui/Selectable.h>
+
+#include "Exception.h"
+#include "FileListModel.h"
+#include "PkgDetailsCache.h"
+#include "PoolGeneration.h"
+#include "YQPkgGenericDetailsView.h"
 #include "YQi18n.h"
 #include "utf8.h"
+#include "YQPkgFileListView.h"
 
 
-#define MAX_LINES 500
+// Delay after the last key press in the search field
+#define SEARCH_DELAY_MILLISEC   250
 
 
 YQPkgFileListView::YQPkgFileListView( QWidget * parent )
-    : YQPkgGenericDetailsView( parent )
+    : QWidget( parent )
+    , _parentTab( dynamic_cast<QTabWidget *>( parent ) )
+    , _shownGeneration( -1 )
 {
+    QVBoxLayout * layout = new QVBoxLayout( this );
+    CHECK_NEW( layout );
+    layout->setContentsMargins( 0, 0, 0, 0 );
+
+    _heading = new QLabel( this );
+    CHECK_NEW( _heading );
+    _heading->setTextFormat( Qt::RichText );
+    layout->addWidget( _heading );
+
+    _searchField = new QLineEdit( this );
+    CHECK_NEW( _searchField );
+    _searchField->setPlaceholderText( _( "Search in file list" ) );
+    _searchField->setClearButtonEnabled( true );
+    layout->addWidget( _searchField );
+
+    _model = new FileListModel( this );
+    CHECK_NEW( _model );
+
+    _searchModel = new FileSearchModel( this );
+    CHECK_NEW( _searchModel );
+
+    _treeView = new QTreeView( this );
+    CHECK_NEW( _treeView );
+    _treeView->setModel( _model );
+    _treeView->setHeaderHidden( true );
+    _treeView->setUniformRowHeights( true ); // Important for huge lists
+    _treeView->setEditTriggers( QAbstractItemView::NoEditTriggers );
+    _treeView->setFrameStyle( QFrame::NoFrame );
+    layout->addWidget( _treeView );
+
+    _footer = new QLabel( this );
+    CHECK_NEW( _footer );
+    layout->addWidget( _footer );
+
+    _searchTimer.setSingleShot( true );
+    _searchTimer.setInterval( SEARCH_DELAY_MILLISEC );
+
+    connect( _searchField,  SIGNAL( textChanged( const QString & ) ),
+             this,          SLOT  ( startSearch()                 ) );
+
+    connect( &_searchTimer, SIGNAL( timeout() ),
+             this,          SLOT  ( search()  ) );
+
+    if ( _parentTab )
+    {
+        connect( _parentTab, SIGNAL( currentChanged( int ) ),
+                 this,       SLOT  ( reloadTab     ( int ) ) );
+    }
 }
 
 
@@ -35,70 +101,127 @@ YQPkgFileListView::~YQPkgFileListView()
 }
 
 
+void
+YQPkgFileListView::reloadTab( int newCurrent )
+{
+    if ( _parentTab && _parentTab->widget( newCurrent ) == this )
+        showDetailsIfVisible( _selectable );
+}
+
+
+void
+YQPkgFileListView::showDetailsIfVisible( ZyppSel selectable )
+{
+    _selectable = selectable;
+
+    if ( _parentTab )  // Is this view embedded into a tab widget?
+    {
+        if ( _parentTab->currentWidget() == this )  // Is this page the topmost?
+            showDetails( selectable );
+    }
+    else  // No tab parent - simply show data unconditionally.
+    {
+        showDetails( selectable );
+    }
+}
+
+
 void
 YQPkgFileListView::showDetails( ZyppSel selectable )
 {
     _selectable = selectable;
 
+    int generation = PoolGeneration::contentGeneration();
+
+    if ( selectable == _shownSelectable && generation == _shownGeneration )
+        return; // Nothing changed
+
+    _shownSelectable = selectable;
+    _shownGeneration = generation;
+
     if ( ! selectable )
     {
-        clear();
+        _heading->clear();
+        _model->clear();
+        search();
+
         return;
     }
 
-    QString html = htmlHeading( selectable,
-                                false ); // showVersion
+    _heading->setText( YQPkgGenericDetailsView::htmlHeading( selectable,
+                                                             false ) ); // showVersion
 
     ZyppPkg installed = tryCastToZyppPkg( selectable->installedObj() );
 
     if ( installed )
+        _model->setFileList( PkgDetailsCache::instance()->fileList( installed ) );
+    else
+        _model->clear();
+
+    search(); // Apply the current search text to the new list
+}
+
+
+void
+YQPkgFileListView::startSearch()
+{
+    _searchTimer.start();
+}
+
+
+void
+YQPkgFileListView::search()
+{
+    _searchTimer.stop();
+
+    QString text = _searchField->text().trimmed();
+
+    if ( text.isEmpty() )
     {
-        zypp::Package::FileList fileList( installed->filelist() );
-        std::list<string> stringList( fileList.begin(), fileList.end() );
+        _searchModel->setStringList( QStringList() );
+
+        if ( _treeView->model() != _model )
+            _treeView->setModel( _model );
 
-        html += formatFileList( stringList );
+        _treeView->setRootIsDecorated( true );
     }
     else
     {
-        html += "<p><i>" + _( "Information only available for installed packages." ) + "</i></p>";
+        _searchModel->setStringList( _model->find( text ) );
+
+        if ( _treeView->model() != _searchModel )
+            _treeView->setModel( _searchModel );
+
+        _treeView->setRootIsDecorated( false );
     }
 
-    setHtml( html );
+    updateFooter();
 }
 
 
-
-QString YQPkgFileListView::formatFileList( const std::list<string> & fileList ) const
+void
+YQPkgFileListView::updateFooter()
 {
-    QString  html;
-    unsigned lineCount = 0;
-
-    for ( std::list<string>::const_iterator it = fileList.begin();
-          it != fileList.end() && lineCount < MAX_LINES;
-          ++it, ++lineCount )
+    if ( ! _selectable )
     {
-        QString line = htmlEscape( fromUTF8( *it ) );
-
-        if ( line.contains( "/bin/"  ) ||
-             line.contains( "/sbin/" )   )
-        {
-            line = "<b>" + line + "</b>";
-        }
-
-        html += line + "<br>";
+        _footer->clear();
+        return;
     }
 
-    if ( fileList.size() > MAX_LINES )
+    if ( ! _selectable->installedObj() )
     {
-        html += "...<br>";
-        html += "...<br>";
+        _footer->setText( "<i>" + _( "Information only available for installed packages." ) + "</i>" );
+        return;
     }
-    else
+
+    // %1 is the total number of files in a file list
+    QString text = _( "%1 files total" ).arg( _model->pathCount() );
+
+    if ( _treeView->model() == _searchModel )
     {
-        // %1 is the total number of files in a file list
-        html += "<br>" + _( "%1 files total" ).arg( (unsigned long) fileList.size() );
+        // %1 is the number of files matching a search in a file list
+        text += " - " + _( "%1 matches" ).arg( _searchModel->rowCount() );
     }
 
-    return "<p>" + html + "</p>";
+    _footer->setText( text );
 }
-
@@ -18,16 +18,32 @@
 #ifndef YQPkgFileListView_h
 #define YQPkgFileListView_h
 
-#include "YQPkgGenericDetailsView.h"
+#include <QTimer>
+#include <QWidget>
 
+#include "YQZypp.h"
 
-using std::string;
+
+class QLabel;
+class QLineEdit;
+class QTabWidget;
+class QTreeView;
+class FileListModel;
+class FileSearchModel;
 
 
 /**
- * Display a package's file list
+ * Display a package's file list as a collapsible directory tree with a
+ * search field.
+ *
+ * The tree is backed by a FileListModel that only creates the nodes of
+ * expanded directories, so even huge file lists are shown completely and
+ * instantly. Searching shows a flat list of all matching paths instead.
+ *
+ * Like the other details views, this only updates its content if it is
+ * visible at all: It may be hidden if it's part of a QTabWidget.
  **/
-class YQPkgFileListView : public YQPkgGenericDetailsView
+class YQPkgFileListView : public QWidget
 {
     Q_OBJECT
 
@@ -43,20 +59,66 @@ public:
      **/
     virtual ~YQPkgFileListView();
 
+
+public slots:
+
+    /**
+     * Show the file list of the specified package.
+     * Delayed display if this is embedded into a QTabWidget parent:
+     * In this case, wait until this page becomes visible.
+     **/
+    void showDetailsIfVisible( ZyppSel selectable );
+
     /**
-     * Show details for the specified package:
-     * In this case the package description.
-     *
-     * Reimplemented from YQPkgGenericDetailsView.
+     * Show the file list of the specified package.
      **/
-    virtual void showDetails( ZyppSel selectable ) override;
+    void showDetails( ZyppSel selectable );
+
+
+protected slots:
+
+    /**
+     * Show the file list if the page with index 'newCurrent' of the parent
+     * tab widget is this view.
+     **/
+    void reloadTab( int newCurrent );
+
+    /**
+     * Search for the text in the search field after the user stopped
+     * typing for a moment.
+     **/
+    void startSearch();
+
+    /**
+     * Search for the text in the search field: Show the tree if it is
+     * empty, otherwise a flat list of all matching paths.
+     **/
+    void search();
+
 
 protected:
 
     /**
-     * Format a file list in HTML
+     * Update the label below the list.
      **/
-    QString formatFileList( const std::list<string> & fileList ) const;
+    void updateFooter();
+
+
+    // Data members
+
+    QTabWidget *       _parentTab;
+    ZyppSel            _selectable;
+    ZyppSel            _shownSelectable;
+    int                _shownGeneration;
+
+    QLabel *           _heading;
+    QLineEdit *        _searchField;
+    QTreeView *        _treeView;
+    QLabel *           _footer;
+
+    FileListModel *    _model;
+    FileSearchModel *  _searchModel;
+    QTimer             _searchTimer;
 };
 
 
@@ -19,6 +19,7 @@
 #include <vector>
 
 #include <QHBoxLayout>
+#include <QLabel>
 #include <QMenu>
 #include <QPushButton>
 #include <QSettings>
@@ -308,6 +309,84 @@ YQPkgFilterTab::addPage( const QString &      pageLabel,
 }
 
 
+void
+YQPkgFilterTab::addLazyPage( const QString &      pageLabel,
+                             const QString &      internalName,
+                             const QKeySequence & hotkey   )
+{
+    QLabel * placeholder = new QLabel( _( "Loading..." ) );
+    CHECK_NEW( placeholder );
+    placeholder->setAlignment( Qt::AlignCenter );
+
+    addPage( pageLabel, placeholder, internalName, hotkey );
+
+    YQPkgFilterPage * page = findPage( internalName );
+    CHECK_PTR( page );
+    page->lazy = true;
+}
+
+
+void
+YQPkgFilterTab::setPageContent( const QString & internalName, QWidget * pageContent )
+{
+    YQPkgFilterPage * page = findPage( internalName );
+    CHECK_PTR( page );
+    CHECK_PTR( pageContent );
+
+    if ( ! page->lazy )
+    {
+        logWarning() << "Page \"" << internalName << "\" already has its content" << endl;
+        return;
+    }
+
+    QWidget * placeholder = page->content;
+    bool      wasCurrent  = _priv->filtersWidgetStack->currentWidget() == placeholder;
+
+    _priv->filtersWidgetStack->addWidget( pageContent );
+
+    if ( wasCurrent )
+        _priv->filtersWidgetStack->setCurrentWidget( pageContent );
+
+    _priv->filtersWidgetStack->removeWidget( placeholder );
+    placeholder->deleteLater();
+
+    page->content = pageContent;
+    page->lazy    = false;
+
+    if ( page->action )
+        page->action->setData( QVariant::fromValue( pageContent ) );
+}
+
+
+void
+YQPkgFilterTab::createPageContent( YQPkgFilterPage * page )
+{
+    if ( ! page || ! page->lazy )
+        return;
+
+    logDebug() << "Requesting the content of page " << page->id << endl;
+    emit pageContentNeeded( page->id );
+
+    if ( page->lazy ) // Signals blocked or nobody connected?
+        logDebug() << "Still no content for page " << page->id << endl;
+}
+
+
+YQPkgFilterPageVector
+YQPkgFilterTab::lazyPages() const
+{
+    YQPkgFilterPageVector result;
+
+    for ( YQPkgFilterPage * page: constPages() )
+    {
+        if ( page->lazy )
+            result.push_back( page );
+    }
+
+    return result;
+}
+
+
 void
 YQPkgFilterTab::showPage( QWidget * pageContent )
 {
@@ -355,6 +434,12 @@ void
 YQPkgFilterTab::showPage( YQPkgFilterPage * page )
 {
     CHECK_PTR( page );
+
+    // Create the content of a lazy page before it becomes visible.
+    // While signals are blocked, this keeps showing the placeholder.
+
+    createPageContent( page );
+
     QSignalBlocker sigBlocker( tabBar() );
 
     if ( page->tabIndex < 0 ) // No corresponding tab yet?
@@ -453,6 +538,13 @@ YQPkgFilterTab::findPage( int tabIndex ) const
 }
 
 
+YQPkgFilterPage *
+YQPkgFilterTab::currentPage() const
+{
+    return findPage( tabBar()->currentIndex() );
+}
+
+
 int
 YQPkgFilterTab::tabCount() const
 {
@@ -93,6 +93,37 @@ public:
                   const QString &      internalName,
                   const QKeySequence & hotkey = QKeySequence() );
 
+    /**
+     * Add a page whose content widget is not created yet. Until it is, a
+     * lightweight placeholder is shown for that page.
+     *
+     * The content is requested with the pageContentNeeded() signal when the
+     * page is shown for the first time or with createPageContent(); the
+     * receiver is expected to create it and call setPageContent().
+     **/
+    void addLazyPage( const QString &      pageLabel,
+                      const QString &      internalName,
+                      const QKeySequence & hotkey = QKeySequence() );
+
+    /**
+     * Replace the placeholder of the lazy page 'internalName' with the real
+     * content widget 'pageContent'.
+     *
+     * 'pageContent' will be reparented to a subwidget of this class.
+     **/
+    void setPageContent( const QString & internalName, QWidget * pageContent );
+
+    /**
+     * Request the content of a lazy page with the pageContentNeeded() signal
+     * if it is not created yet. Do nothing for all other pages.
+     **/
+    void createPageContent( YQPkgFilterPage * page );
+
+    /**
+     * Return all lazy pages whose content is not created yet.
+     **/
+    YQPkgFilterPageVector lazyPages() const;
+
     /**
      * Return the right pane.
      **/
@@ -122,6 +153,11 @@ public:
      **/
     YQPkgFilterPage * findPage( int tabIndex ) const;
 
+    /**
+     * Return the page of the current tab or 0 if there is none.
+     **/
+    YQPkgFilterPage * currentPage() const;
+
     /**
      * Return the number of open tabs.
      **/
@@ -145,6 +181,13 @@ signals:
      **/
     void currentChanged( QWidget * newPageContent );
 
+    /**
+     * Emitted when the content of the lazy page 'internalName' is needed.
+     * Receivers need to use a direct connection and call setPageContent()
+     * before returning.
+     **/
+    void pageContentNeeded( const QString & internalName );
+
 
 public slots:
 
@@ -271,6 +314,7 @@ public:
         , closeEnabled( true )
         , tabIndex( -1 )
         , action( 0 )
+        , lazy( false )
         {}
 
     virtual ~YQPkgFilterPage()
@@ -286,6 +330,7 @@ public:
     bool        closeEnabled;
     int         tabIndex;       // index of the corresponding tab or -1 if none
     QAction *   action;
+    bool        lazy;           // content is only a placeholder so far
 };
 
 
@@ -21,7 +21,15 @@
 #include <zypp/PoolItem.h>
 
 #include "Logger.h"
+#include "PoolGeneration.h"
 #include "YQPkgFilters.h"
+#include "utf8.h"
+
+
+QHash<QString, ZyppProductList> YQPkgFilters::_productsByRepo;
+QHash<QString, ZyppProductList> YQPkgFilters::_productsByService;
+QList<ZyppSel>                  YQPkgFilters::_productSelectables;
+int                             YQPkgFilters::_productTableGeneration = -1;
 
 
 ZyppProduct
@@ -67,3 +75,101 @@ YQPkgFilters::singleProductFilter(std::function<bool( const zypp::PoolItem & ite
 
     return ZyppProduct(); // NULL pointer
 }
+
+
+ZyppProductList
+YQPkgFilters::repoProducts( const std::string & repoAlias )
+{
+    checkProductTable();
+
+    return _productsByRepo.value( fromUTF8( repoAlias ) );
+}
+
+
+ZyppProductList
+YQPkgFilters::serviceProducts( const std::string & serviceName )
+{
+    checkProductTable();
+
+    return _productsByService.value( fromUTF8( serviceName ) );
+}
+
+
+ZyppProduct
+YQPkgFilters::singleRepoProduct( const std::string & repoAlias )
+{
+    return singleProduct( repoProducts( repoAlias ) );
+}
+
+
+ZyppProduct
+YQPkgFilters::singleServiceProduct( const std::string & serviceName )
+{
+    return singleProduct( serviceProducts( serviceName ) );
+}
+
+
+ZyppProduct
+YQPkgFilters::singleProduct( const ZyppProductList & products )
+{
+    if ( products.size() != 1 )
+        return ZyppProduct(); // NULL pointer
+
+    return products.first();
+}
+
+
+const QList<ZyppSel> &
+YQPkgFilters::productSelectables()
+{
+    checkProductTable();
+
+    return _productSelectables;
+}
+
+
+void
+YQPkgFilters::checkProductTable()
+{
+    int contentGeneration = PoolGeneration::contentGeneration();
+
+    if ( contentGeneration == _productTableGeneration )
+        return;
+
+    _productsByRepo.clear();
+    _productsByService.clear();
+    _productSelectables.clear();
+
+    // One pass over all product pool items, installed and available
+
+    for ( auto it = zypp::ResPool::instance().byKindBegin( zypp::ResKind::product );
+          it != zypp::ResPool::instance().byKindEnd  ( zypp::ResKind::product );
+          ++it )
+    {
+        ZyppProduct product = zypp::asKind<zypp::Product>( it->resolvable() );
+
+        if ( ! product )
+            continue;
+
+        const zypp::RepoInfo & repoInfo = it->resolvable()->repoInfo();
+
+        _productsByRepo[ fromUTF8( repoInfo.alias() ) ] << product;
+
+        if ( ! repoInfo.service().empty() )
+            _productsByService[ fromUTF8( repoInfo.service() ) ] << product;
+    }
+
+    for ( ZyppPoolIterator it = zyppProductsBegin();
+          it != zyppProductsEnd();
+          ++it )
+    {
+        _productSelectables << *it;
+    }
+
+    _productTableGeneration = contentGeneration;
+
+    logDebug() << "Product table: "
+               << _productsByRepo.size()     << " repos, "
+               << _productSelectables.size() << " products"
+               << endl;
+}
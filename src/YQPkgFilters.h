@@ -18,10 +18,24 @@
 #ifndef YQPkgFilters_h
 #define YQPkgFilters_h
 
+#include <string>
+
+#include <QHash>
+#include <QList>
+#include <QString>
+
 #include "YQZypp.h"
 
+
+typedef QList<ZyppProduct> ZyppProductList;
+
+
 /**
  * Zypp filtering helpers
+ *
+ * This also maintains a table of the products in the pool by repo and by
+ * service. It is built in one pass over all products and rebuilt
+ * automatically when the pool content changes.
  **/
 class YQPkgFilters
 {
@@ -36,6 +50,58 @@ public:
       * item. This function returns true if it matches the expectations.
       */
     static ZyppProduct singleProductFilter( std::function<bool(const zypp::PoolItem & item)> filter );
+
+    /**
+     * Return the products from the repo with alias 'repoAlias'.
+     **/
+    static ZyppProductList repoProducts( const std::string & repoAlias );
+
+    /**
+     * Return the products from the repos of service 'serviceName'.
+     **/
+    static ZyppProductList serviceProducts( const std::string & serviceName );
+
+    /**
+     * Return the product of the repo with alias 'repoAlias' if there is
+     * exactly one, or null if there are none or several.
+     *
+     * This is equivalent to a singleProductFilter() that matches the repo
+     * alias, but it uses the product table.
+     **/
+    static ZyppProduct singleRepoProduct( const std::string & repoAlias );
+
+    /**
+     * Return the product of the service 'serviceName' if there is exactly
+     * one, or null if there are none or several.
+     **/
+    static ZyppProduct singleServiceProduct( const std::string & serviceName );
+
+    /**
+     * Return all product selectables in pool order.
+     **/
+    static const QList<ZyppSel> & productSelectables();
+
+
+protected:
+
+    /**
+     * Rebuild the product table if the pool content changed.
+     **/
+    static void checkProductTable();
+
+    /**
+     * Return the single product in 'products' or null if there are none or
+     * several.
+     **/
+    static ZyppProduct singleProduct( const ZyppProductList & products );
+
+
+    // Data members
+
+    static QHash<QString, ZyppProductList> _productsByRepo;
+    static QHash<QString, ZyppProductList> _productsByService;
+    static QList<ZyppSel>                  _productSelectables;
+    static int                             _productTableGeneration;
 };
 
 
@@ -23,6 +23,7 @@
 #include <zypp/ui/Selectable.h>
 
 #include "Logger.h"
+#include "PoolGeneration.h"
 #include "utf8.h"
 #include "YQPkgGenericDetailsView.h"
 
@@ -30,9 +31,19 @@
 #  define VERBOSE_DETAILS_VIEWS  0
 #endif
 
+// Minimum time between two HTML rebuilds of the same view
+#define DETAILS_DEBOUNCE_MILLISEC       80
+
+// Total size of the HTML cache in characters
+#define HTML_CACHE_MAX_CHARS            ( 4 * 1024 * 1024 )
+
+
+QCache<QString, QString> YQPkgGenericDetailsView::_htmlCache( HTML_CACHE_MAX_CHARS );
+
 
 YQPkgGenericDetailsView::YQPkgGenericDetailsView( QWidget * parent )
     : QTextBrowser( parent )
+    , _pendingDetails( false )
 {
     _selectable = 0;
     setFrameStyle( QFrame::NoFrame );
@@ -44,6 +55,12 @@ YQPkgGenericDetailsView::YQPkgGenericDetailsView( QWidget * parent )
                  this,       SLOT  ( reloadTab     ( int ) ) );
     }
 
+    _debounceTimer.setSingleShot( true );
+    _debounceTimer.setInterval( DETAILS_DEBOUNCE_MILLISEC );
+
+    connect( &_debounceTimer, SIGNAL( timeout()            ),
+             this,            SLOT  ( showPendingDetails() ) );
+
     // DO NOT add anything like 'font-size: small' here; that makes the text
     // unreadable for everybody over 40 years of age.
 
@@ -110,13 +127,97 @@ YQPkgGenericDetailsView::showDetailsIfVisible( ZyppSel selectable )
                          << ( selectable ? fromUTF8( selectable->name() ) : "NULL" )
                          << endl;
 #endif
-            showDetails( selectable );
+            updateDetails( selectable );
         }
     }
     else  // No tab parent - simply show data unconditionally.
     {
-        showDetails( selectable );
+        updateDetails( selectable );
+    }
+}
+
+
+void
+YQPkgGenericDetailsView::updateDetails( ZyppSel selectable )
+{
+    if ( showCachedDetails( selectable ) )
+    {
+        _pendingDetails = false;
+        return;
     }
+
+    if ( _debounceTimer.isActive() )
+    {
+        // Rapid navigation: Only show the latest selectable when the timer
+        // expires
+
+        _pendingDetails = true;
+        return;
+    }
+
+    showDetails( selectable );
+    _debounceTimer.start();
+}
+
+
+void
+YQPkgGenericDetailsView::showPendingDetails()
+{
+    if ( ! _pendingDetails )
+        return;
+
+    _pendingDetails = false;
+
+    if ( _parentTab && _parentTab->currentWidget() != this )
+        return; // reloadTab() will take care of it
+
+    if ( ! showCachedDetails( _selectable ) )
+    {
+        showDetails( _selectable );
+        _debounceTimer.start();
+    }
+}
+
+
+bool
+YQPkgGenericDetailsView::showCachedDetails( ZyppSel selectable )
+{
+    if ( ! selectable )
+        return false;
+
+    QString * html = _htmlCache.object( cacheKey( selectable ) );
+
+    if ( ! html )
+        return false;
+
+    _selectable = selectable;
+    setHtml( *html );
+
+    return true;
+}
+
+
+void
+YQPkgGenericDetailsView::setDetailsHtml( const QString & html )
+{
+    setHtml( html );
+
+    if ( _selectable )
+        _htmlCache.insert( cacheKey( _selectable ), new QString( html ), html.size() );
+}
+
+
+QString
+YQPkgGenericDetailsView::cacheKey( ZyppSel selectable ) const
+{
+    // The pool generation changes with every status change and whenever the
+    // pool content changes, so a selectable address can't be reused for a
+    // different selectable within the same generation.
+
+    return QString( "%1|%2|%3" )
+        .arg( metaObject()->className() )
+        .arg( (quintptr) selectable.get() )
+        .arg( PoolGeneration::current() );
 }
 
 
@@ -22,7 +22,9 @@
 #include <zypp-core/Date.h>
 
 #include "YQZypp.h"
+#include <QCache>
 #include <QTextBrowser>
+#include <QTimer>
 
 
 class QTabWidget;
@@ -34,6 +36,10 @@ using std::string;
  * Abstract base class for details views. Handles generic stuff like HTML
  * formatting, Qt slots and display only if this view is visible at all: It may
  * be hidden if it's part of a QTabWidget.
+ *
+ * Rapid updates (e.g. while the user holds down an arrow key in a package
+ * list) are coalesced, and the generated HTML is kept in an LRU cache shared
+ * by all details views, so revisiting a package is instant.
  **/
 class YQPkgGenericDetailsView : public QTextBrowser
 {
@@ -138,11 +144,50 @@ protected slots:
 
     virtual void reload() { QTextBrowser::reload(); }
 
+    /**
+     * Show the details of the latest selectable if any update was
+     * postponed while the debounce timer was running.
+     **/
+    void showPendingDetails();
+
 
 protected:
 
+    /**
+     * Show the details for 'selectable' from the HTML cache if possible.
+     * Otherwise call showDetails() now or, during rapid navigation, when the
+     * debounce timer expires.
+     **/
+    void updateDetails( ZyppSel selectable );
+
+    /**
+     * Show cached HTML for 'selectable' if there is any for the current pool
+     * generation. Return 'true' if there was.
+     **/
+    bool showCachedDetails( ZyppSel selectable );
+
+    /**
+     * Set 'html' as the content of this view and store it in the HTML cache
+     * for _selectable. Derived classes should use this instead of setHtml()
+     * in showDetails().
+     **/
+    void setDetailsHtml( const QString & html );
+
+    /**
+     * Return the HTML cache key for 'selectable' in this view for the
+     * current pool generation.
+     **/
+    QString cacheKey( ZyppSel selectable ) const;
+
+
+    // Data members
+
     QTabWidget * _parentTab;
     ZyppSel      _selectable;
+    QTimer       _debounceTimer;
+    bool         _pendingDetails;
+
+    static QCache<QString, QString> _htmlCache;
 };
 
 
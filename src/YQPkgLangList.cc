@@ -19,9 +19,13 @@
 #include <zypp/sat/LocaleSupport.h>
 
 #include "Logger.h"
+#include "PkgIndex.h"
+#include "PoolGeneration.h"
 #include "QY2ListView.h"
+#include "SelectableIds.h"
 #include "YQi18n.h"
 #include "YQPkgLangList.h"
+#include "utf8.h"
 
 #ifndef VERBOSE_FILTER_VIEWS
 #  define VERBOSE_FILTER_VIEWS  0
@@ -30,6 +34,9 @@
 
 YQPkgLangList::YQPkgLangList( QWidget * parent )
     : YQPkgObjList( parent )
+    , _packagesCol( -1 )
+    , _localePkgsGeneration( -1 )
+    , _notInstalledGeneration( -1 )
 {
     // FIXME: The base class works with zypp::Resolvable, but zypp::Locale
     // isn't one any longer!
@@ -43,16 +50,22 @@ YQPkgLangList::YQPkgLangList( QWidget * parent )
     // Full (human readable) language / country name like "German (Austria)"
     QString langheader = _( "Language");
 
+    // Number of packages that are not installed yet and that this language
+    // would add
+    QString pkgHeader = _( "Packages" );
+
     int numCol = 0;
     QStringList headers;
-    headers <<  "";         _statusCol  = numCol++;
-    headers << codeHeader;  _nameCol    = numCol++;
-    headers << langheader;  _summaryCol = numCol++;
+    headers <<  "";         _statusCol   = numCol++;
+    headers << codeHeader;  _nameCol     = numCol++;
+    headers << langheader;  _summaryCol  = numCol++;
+    headers << pkgHeader;   _packagesCol = numCol++;
 
     setHeaderLabels( headers );
 
-    header()->setSectionResizeMode( _nameCol,    QHeaderView::ResizeToContents );
-    header()->setSectionResizeMode( _summaryCol, QHeaderView::Stretch );
+    header()->setSectionResizeMode( _nameCol,     QHeaderView::ResizeToContents );
+    header()->setSectionResizeMode( _summaryCol,  QHeaderView::Stretch );
+    header()->setSectionResizeMode( _packagesCol, QHeaderView::ResizeToContents );
 
     setAllColumnsShowFocus( true );
     header()->setSortIndicatorShown( true );
@@ -65,6 +78,12 @@ YQPkgLangList::YQPkgLangList( QWidget * parent )
                                                QTreeWidgetItem * ) ),
              this, SLOT  ( filter() ) );
 
+    // Calculate one locale's packages whenever the event loop is idle
+    _countTimer.setInterval( 0 );
+
+    connect( &_countTimer, SIGNAL( timeout()              ),
+             this,         SLOT  ( calcNextPackageCount() ) );
+
     fillList();
     selectSomething();
     resizeColumnToContents(_statusCol);
@@ -82,6 +101,7 @@ YQPkgLangList::~YQPkgLangList()
 void
 YQPkgLangList::fillList()
 {
+    _pendingCounts.clear();
     clear();
     // logVerbose() << "Filling language list" << endl;
 
@@ -94,10 +114,114 @@ YQPkgLangList::fillList()
         addLangItem( *it );
     }
 
+    QTreeWidgetItemIterator it( this );
+
+    while ( *it )
+    {
+        YQPkgLangListItem * item = dynamic_cast<YQPkgLangListItem *>( *it );
+
+        if ( item )
+            _pendingCounts << item;
+
+        ++it;
+    }
+
+    if ( ! _pendingCounts.isEmpty() )
+        _countTimer.start();
+
     // logVerbose() << "Language list filled" << endl;
 }
 
 
+PkgBitset
+YQPkgLangList::localePackages( const zypp::Locale & lang )
+{
+    checkCache();
+
+    QString code = fromUTF8( lang.code() );
+    auto cached = _localePkgs.find( code );
+
+    if ( cached != _localePkgs.end() )
+        return cached.value();
+
+    PkgBitset pkgs( SelectableIds::count() );
+    zypp::sat::LocaleSupport localeSupport( lang );
+
+    for_( it, localeSupport.selectableBegin(), localeSupport.selectableEnd() )
+    {
+        int id = SelectableIds::id( *it ); // -1 for anything but packages
+
+        if ( id >= 0 )
+            pkgs.set( id );
+    }
+
+    _localePkgs.insert( code, pkgs );
+
+    return pkgs;
+}
+
+
+bool
+YQPkgLangList::haveCachedPackages( const zypp::Locale & lang ) const
+{
+    checkCache();
+
+    return _localePkgs.contains( fromUTF8( lang.code() ) );
+}
+
+
+void
+YQPkgLangList::checkCache() const
+{
+    int contentGeneration = PoolGeneration::contentGeneration();
+
+    if ( contentGeneration != _localePkgsGeneration )
+    {
+        _localePkgs.clear();
+        _localePkgsGeneration = contentGeneration;
+    }
+}
+
+
+void
+YQPkgLangList::updatePackageCount( YQPkgLangListItem * item )
+{
+    if ( ! item || ! haveCachedPackages( item->zyppLang() ) )
+        return;
+
+    int generation = PoolGeneration::current();
+
+    if ( generation != _notInstalledGeneration )
+    {
+        _notInstalledPkgs       = PkgIndex::instance()->withFlags( 0, PkgIndex::Installed );
+        _notInstalledGeneration = generation;
+    }
+
+    PkgBitset missing = localePackages( item->zyppLang() );
+    missing &= _notInstalledPkgs;
+
+    item->setPackageCount( missing.count() );
+}
+
+
+void
+YQPkgLangList::calcNextPackageCount()
+{
+    if ( _pendingCounts.isEmpty() )
+    {
+        _countTimer.stop();
+        return;
+    }
+
+    // Only one locale per timer tick
+
+    YQPkgLangListItem * item = _pendingCounts.takeFirst();
+
+    localePackages( item->zyppLang() );
+    updatePackageCount( item );
+}
+
+
 void
 YQPkgLangList::showFilter( QWidget * newFilter )
 {
@@ -117,18 +241,20 @@ YQPkgLangList::filter()
 
     if ( selection() )
     {
-        zypp::Locale lang = selection()->zyppLang();
+        PkgBitset pkgs = localePackages( selection()->zyppLang() );
 
-        zypp::sat::LocaleSupport currentLocale( lang );
-        for_( it, currentLocale.selectableBegin(), currentLocale.selectableEnd() )
+        for ( int id = pkgs.next( 0 ); id >= 0; id = pkgs.next( id + 1 ) )
         {
-            ZyppPkg zyppPkg = tryCastToZyppPkg( (*it)->theObj() );
+            ZyppSel selectable = SelectableIds::selectable( id );
+            ZyppPkg zyppPkg    = tryCastToZyppPkg( selectable->theObj() );
 
             if ( zyppPkg )
             {
-                emit filterMatch( *it, zyppPkg );
+                emit filterMatch( selectable, zyppPkg );
             }
         }
+
+        updatePackageCount( selection() );
     }
     emit filterFinished();
 }
@@ -169,7 +295,9 @@ YQPkgLangList::updateActions( YQPkgObjListItem * item)
 YQPkgLangListItem::YQPkgLangListItem( YQPkgLangList *      langList,
                                       const zypp::Locale & lang )
     : YQPkgObjListItem( langList )
+    , _langList( langList )
     , _zyppLang( lang )
+    , _packageCount( -1 )
 {
     init();
 }
@@ -201,6 +329,16 @@ YQPkgLangListItem::init()
 }
 
 
+void
+YQPkgLangListItem::setPackageCount( int count )
+{
+    _packageCount = count;
+
+    if ( _langList->packagesCol() >= 0 )
+        setText( _langList->packagesCol(), QString::number( count ) );
+}
+
+
 ZyppStatus
 YQPkgLangListItem::status() const
 {
@@ -297,6 +435,10 @@ bool YQPkgLangListItem::operator<( const QTreeWidgetItem & otherListViewItem ) c
             return ( strcoll( this->zyppLang().name().c_str(),
                               other->zyppLang().name().c_str() ) < 0 );
         }
+        if ( col == _langList->packagesCol() )
+        {
+            return this->packageCount() < other->packageCount();
+        }
     }
 
     return QY2ListViewItem::operator<( otherListViewItem );
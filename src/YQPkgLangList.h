@@ -18,6 +18,11 @@
 #ifndef YQPkgLangList_h
 #define YQPkgLangList_h
 
+#include <QHash>
+#include <QList>
+#include <QTimer>
+
+#include "PkgBitset.h"
 #include "YQPkgObjList.h"
 #include "YQZypp.h"
 
@@ -25,6 +30,10 @@ class YQPkgLangListItem;
 
 /**
  * Display a list of languages and locales.
+ *
+ * The packages of each locale are cached until the pool content changes.
+ * After the list is filled, they are calculated in the background, one
+ * locale at a time, to show how many packages each locale would add.
  **/
 class YQPkgLangList : public YQPkgObjList
 {
@@ -42,6 +51,22 @@ public:
      **/
     virtual ~YQPkgLangList();
 
+    /**
+     * Return the column number of the "Packages" column.
+     **/
+    int packagesCol() const { return _packagesCol; }
+
+    /**
+     * Return the set of packages that support 'lang'. This uses the cache
+     * if possible; otherwise it calculates the set and caches it.
+     **/
+    PkgBitset localePackages( const zypp::Locale & lang );
+
+    /**
+     * Return 'true' if the packages of 'lang' are in the cache.
+     **/
+    bool haveCachedPackages( const zypp::Locale & lang ) const;
+
 
 public slots:
 
@@ -105,6 +130,42 @@ protected slots:
      * Fill the language list.
      **/
     void fillList();
+
+    /**
+     * Calculate the packages of the next locale in the background queue
+     * and update its package count.
+     **/
+    void calcNextPackageCount();
+
+
+protected:
+
+    /**
+     * Update the number of packages that 'item' would add, i.e. the
+     * packages of its locale that are not installed yet. Do nothing if the
+     * packages of that locale are not in the cache yet.
+     **/
+    void updatePackageCount( YQPkgLangListItem * item );
+
+    /**
+     * Clear the cache if the pool content changed.
+     **/
+    void checkCache() const;
+
+
+    // Data members
+
+    int _packagesCol;
+
+    // Packages by locale code
+    mutable QHash<QString, PkgBitset> _localePkgs;
+    mutable int _localePkgsGeneration;
+
+    PkgBitset _notInstalledPkgs;
+    int       _notInstalledGeneration;
+
+    QList<YQPkgLangListItem *> _pendingCounts;
+    QTimer                     _countTimer;
 };
 
 
@@ -166,6 +227,17 @@ public:
      **/
     virtual bool operator< ( const QTreeWidgetItem & other ) const;
 
+    /**
+     * Set the number of packages that this locale would add.
+     **/
+    void setPackageCount( int count );
+
+    /**
+     * Return the number of packages that this locale would add
+     * or -1 if that is not known yet.
+     **/
+    int packageCount() const { return _packageCount; }
+
 protected:
 
     void init();
@@ -183,6 +255,7 @@ protected:
 
     YQPkgLangList * _langList;
     zypp::Locale    _zyppLang;
+    int             _packageCount;
 };
 
 
@@ -21,6 +21,7 @@
 #include <QMenu>
 
 #include "Logger.h"
+#include "PkgIndex.h"
 #include "QY2CursorHelper.h"
 #include "YQi18n.h"
 #include "utf8.h"
@@ -492,7 +493,9 @@ YQPkgList::globalSetPkgStatus( ZyppStatus newStatus, bool force, bool countOnly
             if ( doChange )
             {
                 if ( ! countOnly && oldStatus != S_Protected )
-                    selectable->setStatus( newStatus );
+                {
+                    PkgIndex::setStatus( selectable, newStatus );
+                }
 
                 changedCount++;
                 // logInfo() << "Updating " << selectable->name() << endl;
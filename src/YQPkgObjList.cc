@@ -27,6 +27,9 @@
 
 #include "LicenseCache.h"
 #include "Logger.h"
+#include "PkgDetailsCache.h"
+#include "PkgIndex.h"
+#include "PoolGeneration.h"
 #include "QY2CursorHelper.h"
 #include "YQIconPool.h"
 #include "YQPkgTextDialog.h"
@@ -36,6 +39,9 @@
 
 #define VERBOSE_EXCLUDE_RULES    0
 
+// Number of rows above and below the current item whose details to prefetch
+#define PREFETCH_NEIGHBOURS      3
+
 using std::list;
 using std::string;
 
@@ -167,6 +173,39 @@ YQPkgObjList::currentItemChangedInternal( QTreeWidgetItem * listViewItem )
     YQPkgObjListItem * item = dynamic_cast<YQPkgObjListItem *>( listViewItem );
 
     emit currentItemChanged( item ? item->selectable() : ZyppSel() );
+
+    if ( item )
+        prefetchNeighbourDetails( item );
+}
+
+
+void
+YQPkgObjList::prefetchNeighbourDetails( QTreeWidgetItem * listViewItem )
+{
+    // Alternate between the rows below and above, nearest first: The next
+    // current item is most likely one of them.
+
+    QList<ZyppSel>    neighbours;
+    QTreeWidgetItem * below = listViewItem;
+    QTreeWidgetItem * above = listViewItem;
+
+    for ( int i = 0; i < PREFETCH_NEIGHBOURS; ++i )
+    {
+        below = below ? itemBelow( below ) : 0;
+        above = above ? itemAbove( above ) : 0;
+
+        YQPkgObjListItem * item = dynamic_cast<YQPkgObjListItem *>( below );
+
+        if ( item && item->selectable() )
+            neighbours << item->selectable();
+
+        item = dynamic_cast<YQPkgObjListItem *>( above );
+
+        if ( item && item->selectable() )
+            neighbours << item->selectable();
+    }
+
+    PkgDetailsCache::instance()->prefetch( neighbours );
 }
 
 
@@ -1029,10 +1068,7 @@ YQPkgObjListItem::bySelection() const
 void
 YQPkgObjListItem::setStatus( ZyppStatus newStatus, bool sendSignals )
 {
-    ZyppStatus oldStatus = selectable()->status();
-    selectable()->setStatus( newStatus );
-
-    if ( oldStatus != selectable()->status() )
+    if ( PkgIndex::setStatus( selectable(), newStatus ) )
     {
         applyChanges();
 
@@ -1051,6 +1087,7 @@ void
 YQPkgObjListItem::solveResolvableCollections()
 {
     zypp::getZYpp()->resolver()->resolvePool();
+    PoolGeneration::invalidate();
 }
 
 
@@ -1256,7 +1293,7 @@ YQPkgObjListItem::showLicenseAgreement( ZyppSel sel )
                              << " - setting to TABOO"
                              << endl;
 
-                sel->setStatus( S_Taboo );
+                PkgIndex::setStatus( sel, S_Taboo );
                 break;
 
 
@@ -1267,7 +1304,7 @@ YQPkgObjListItem::showLicenseAgreement( ZyppSel sel )
                              << "  - setting to PROTECTED"
                              << endl;
 
-                sel->setStatus( S_Protected );
+                PkgIndex::setStatus( sel, S_Protected );
                 // S_Keep wouldn't be good enough: The next solver run might
                 // set it to S_AutoUpdate again
                 break;
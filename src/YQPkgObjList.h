@@ -312,6 +312,12 @@ protected:
      **/
     virtual void keyPressEvent( QKeyEvent * ev );
 
+    /**
+     * Have the PkgDetailsCache prefetch the details of the visible rows
+     * next to 'item' while the GUI is idle.
+     **/
+    void prefetchNeighbourDetails( QTreeWidgetItem * item );
+
     /**
      * Returns the context menu for items that are not installed.
      * Creates the menu upon the first call.
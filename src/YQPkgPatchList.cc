@@ -15,12 +15,16 @@
  */
 
 
+#include <limits.h>     // INT_MAX
+
 #include <QAction>
 #include <QHeaderView>
 #include <QMenu>
 #include <QTreeWidgetItem>
 
 #include "Logger.h"
+#include "PoolGeneration.h"
+#include "SelectableIds.h"
 #include "YQIconPool.h"
 #include "YQi18n.h"
 #include "utf8.h"
@@ -33,9 +37,20 @@
 #define VERBOSE_PATCHES         0
 #define ENABLE_DELETING_PATCHES 1
 
+// Number of patches to classify in one background slice
+#define CLASSIFY_SLICE_SIZE     100
+
+
+QVector<YQPkgPatchList::PatchInfo> YQPkgPatchList::_patches;
+int YQPkgPatchList::_patchesContentGeneration = -1;
+int YQPkgPatchList::_relevanceGeneration      = -1;
+int YQPkgPatchList::_nextToClassify           = 0;
+
 
 YQPkgPatchList::YQPkgPatchList( QWidget * parent )
     : YQPkgObjList( parent )
+    , _contentsGeneration( -1 )
+    , _nextContents( 0 )
 {
     logDebug() << "Creating patch list" << endl;
 
@@ -61,6 +76,12 @@ YQPkgPatchList::YQPkgPatchList( QWidget * parent )
                                                QTreeWidgetItem* ) ),
              this, SLOT  ( filter() ) );
 
+    // Classify the patches and calculate their content whenever the event
+    // loop is idle
+    _backgroundTimer.setInterval( 0 );
+
+    connect( &_backgroundTimer, SIGNAL( timeout()            ),
+             this,              SLOT  ( calcNextPatchSlice() ) );
 
     fillList();
 
@@ -123,14 +144,11 @@ YQPkgPatchList::haveAnyPatches()
 bool
 YQPkgPatchList::haveNeededPatches()
 {
-    for ( ZyppPoolIterator it = zyppPatchesBegin();
-          it != zyppPatchesEnd();
-          ++it )
-    {
-        ZyppSel   selectable = *it;
-        ZyppPatch zyppPatch  = tryCastToZyppPatch( selectable->theObj() );
+    classifyPatches( INT_MAX ); // Uses the cache if possible
 
-        if ( isNeeded( selectable, zyppPatch ) )
+    for ( const PatchInfo & info: _patches )
+    {
+        if ( info.relevance == NeededPatch )
             return true;
     }
 
@@ -141,16 +159,13 @@ YQPkgPatchList::haveNeededPatches()
 int
 YQPkgPatchList::countNeededPatches()
 {
+    classifyPatches( INT_MAX ); // Uses the cache if possible
+
     int count = 0;
 
-    for ( ZyppPoolIterator it = zyppPatchesBegin();
-          it != zyppPatchesEnd();
-          ++it )
+    for ( const PatchInfo & info: _patches )
     {
-        ZyppSel   selectable = *it;
-        ZyppPatch zyppPatch  = tryCastToZyppPatch( selectable->theObj() );
-
-        if ( isNeeded( selectable, zyppPatch ) )
+        if ( info.relevance == NeededPatch )
             ++count;
     }
 
@@ -158,89 +173,117 @@ YQPkgPatchList::countNeededPatches()
 }
 
 
-bool YQPkgPatchList::isNeeded( ZyppSel selectable, ZyppPatch zyppPatch )
+YQPkgPatchList::PatchRelevance
+YQPkgPatchList::relevance( ZyppSel selectable, ZyppPatch zyppPatch )
 {
-    if ( zyppPatch )
+    if ( ! zyppPatch || ! selectable->hasCandidateObj() )
+        return NoCandidatePatch;
+
+    if ( selectable->candidateObj().isRelevant() &&
+         ( ! selectable->candidateObj().isSatisfied() ||
+           selectable->candidateObj().status().isToBeInstalled() ) )
+    {
+        return NeededPatch;
+    }
+
+    // Not relevant or satisfied: Show satisfied patches too
+
+    return UnneededPatch;
+}
+
+
+bool
+YQPkgPatchList::classifyPatches( int maxItems )
+{
+    int contentGeneration = PoolGeneration::contentGeneration();
+
+    if ( contentGeneration != _patchesContentGeneration )
     {
-        if ( selectable->hasCandidateObj() &&
-             selectable->candidateObj().isRelevant() )
+        _patches.clear();
+        _relevanceGeneration = -1;
+
+        for ( ZyppPoolIterator it = zyppPatchesBegin();
+              it != zyppPatchesEnd();
+              ++it )
         {
-            if ( ! selectable->candidateObj().isSatisfied() ||
-                 selectable->candidateObj().status().isToBeInstalled() )
-            {
-                return true;
-            }
+            ZyppSel   selectable = *it;
+            ZyppPatch zyppPatch  = tryCastToZyppPatch( selectable->theObj() );
+
+            if ( zyppPatch )
+                _patches << PatchInfo { selectable, zyppPatch, NoCandidatePatch };
+            else
+                logError() << "Found non-patch selectable" << endl;
         }
+
+        _patchesContentGeneration = contentGeneration;
+    }
+
+    int generation = PoolGeneration::current();
+
+    if ( generation != _relevanceGeneration )
+    {
+        // Any status change may change the relevance of any patch
+
+        _relevanceGeneration = generation;
+        _nextToClassify      = 0;
+    }
+
+    for ( int count = 0;
+          count < maxItems && _nextToClassify < _patches.size();
+          ++count, ++_nextToClassify )
+    {
+        PatchInfo & info = _patches[ _nextToClassify ];
+        info.relevance = relevance( info.selectable, info.zyppPatch );
     }
 
-    return false;
+    return _nextToClassify >= _patches.size();
 }
 
 
 void
 YQPkgPatchList::fillList()
 {
-    // wee need to do a full solve in order
-    // to get the satisfied status correctly
+    // The satisfied status is only correct after a full solver run;
+    // classifyPatches() starts over after each one.
 
     _categories.clear();
 
     clear();
     // logDebug() << "Filling patch list" << endl;
 
-    for ( ZyppPoolIterator it = zyppPatchesBegin();
-          it != zyppPatchesEnd();
-          ++it )
+    classifyPatches( INT_MAX ); // Uses the cache if possible
+
+    for ( const PatchInfo & info: _patches )
     {
-        ZyppSel   selectable = *it;
-        ZyppPatch zyppPatch  = tryCastToZyppPatch( selectable->theObj() );
+        bool displayPatch = false;
 
-        if ( zyppPatch )
+        switch ( _filterCriteria )
         {
-            bool displayPatch = false;
+            case RelevantPatches:   // needed + broken + satisfied (but not installed)
+                displayPatch = info.relevance == NeededPatch;
+                break;
 
-            switch ( _filterCriteria )
-            {
-                case RelevantPatches:   // needed + broken + satisfied (but not installed)
-                    displayPatch = isNeeded( selectable, zyppPatch );
-                    break;
-
-                case RelevantAndInstalledPatches:       // patches we dont need
-
-                    // only shows patches relevant to the system
-                    if ( ( selectable->hasCandidateObj() ) &&
-                         ( ! selectable->candidateObj().isRelevant()
-                           || ( selectable->candidateObj().isSatisfied() &&
-                                ! selectable->candidateObj().status().isToBeInstalled() ) ) )
-                    {
-                        // now we show satisfied patches too
-                        displayPatch = true;
-                    }
-                    break;
-
-                case AllPatches:
-                    displayPatch = true;
-                    break;
-
-                default:
-                    logDebug() << "unknown patch filter" << endl;
-                    break;
+            case RelevantAndInstalledPatches:       // patches we dont need
+                displayPatch = info.relevance == UnneededPatch;
+                break;
 
-            }
+            case AllPatches:
+                displayPatch = true;
+                break;
 
-            if ( displayPatch )
-            {
-#if VERBOSE_PATCHES
-                logDebug() << "Displaying patch " << zyppPatch->name()
-                           << " - " <<  zyppPatch->summary()
-                           << endl;
-#endif
-                addPatchItem( *it, zyppPatch);
-            }
+            default:
+                logDebug() << "unknown patch filter" << endl;
+                break;
         }
-        else
+
+        if ( displayPatch )
         {
-            logError() << "Found non-patch selectable" << endl;
+#if VERBOSE_PATCHES
+            logDebug() << "Displaying patch " << info.zyppPatch->name()
+                       << " - " <<  info.zyppPatch->summary()
+                       << endl;
+#endif
+            addPatchItem( info.selectable, info.zyppPatch );
         }
     }
 
@@ -286,18 +329,15 @@ YQPkgPatchList::filter()
 
         if ( patch )
         {
-            zypp::Patch::Contents contents( patch->contents() );
+            PkgBitset contents = patchContents( selection()->selectable() );
 
-            for ( zypp::Patch::Contents::Selectable_iterator it = contents.selectableBegin();
-                  it != contents.selectableEnd();
-                  ++it )
+            for ( int id = contents.next( 0 ); id >= 0; id = contents.next( id + 1 ) )
             {
-                ZyppPkg zyppPkg = tryCastToZyppPkg( (*it)->theObj() );
+                ZyppSel selectable = SelectableIds::selectable( id );
+                ZyppPkg zyppPkg    = tryCastToZyppPkg( selectable->theObj() );
 
                 if ( zyppPkg )
-                {
-                    emit filterMatch( *it, zyppPkg );
-                }
+                    emit filterMatch( selectable, zyppPkg );
             }
         }
         else
@@ -311,6 +351,130 @@ YQPkgPatchList::filter()
 }
 
 
+PkgBitset
+YQPkgPatchList::patchContents( ZyppSel patch )
+{
+    checkContentsCache();
+
+    auto it = _contents.find( patch.get() );
+
+    if ( it != _contents.end() )
+        return it.value();
+
+    PkgBitset contents( SelectableIds::count() );
+    ZyppPatch zyppPatch = tryCastToZyppPatch( patch->theObj() );
+
+    if ( zyppPatch )
+    {
+        zypp::Patch::Contents patchContents( zyppPatch->contents() );
+
+        for ( zypp::Patch::Contents::Selectable_iterator it = patchContents.selectableBegin();
+              it != patchContents.selectableEnd();
+              ++it )
+        {
+            int id = SelectableIds::id( *it ); // -1 for anything but packages
+
+            if ( id >= 0 )
+                contents.set( id );
+        }
+    }
+
+    _contents.insert( patch.get(), contents );
+
+    return contents;
+}
+
+
+bool
+YQPkgPatchList::haveCachedContents( ZyppSel patch ) const
+{
+    checkContentsCache();
+
+    return _contents.contains( patch.get() );
+}
+
+
+void
+YQPkgPatchList::checkContentsCache() const
+{
+    int contentGeneration = PoolGeneration::contentGeneration();
+
+    if ( contentGeneration != _contentsGeneration )
+    {
+        _contents.clear();
+        _contentsGeneration = contentGeneration;
+    }
+}
+
+
+void
+YQPkgPatchList::startBackgroundPass()
+{
+    _nextContents = 0;
+    _backgroundTimer.start();
+}
+
+
+void
+YQPkgPatchList::calcNextPatchSlice()
+{
+    // First classify all patches, then cache their contents
+
+    if ( ! classifyPatches( CLASSIFY_SLICE_SIZE ) )
+        return; // Continue in the next slice
+
+    while ( _nextContents < _patches.size() )
+    {
+        ZyppSel patch = _patches[ _nextContents++ ].selectable;
+
+        if ( ! haveCachedContents( patch ) )
+        {
+            patchContents( patch );
+            return; // Continue in the next slice
+        }
+    }
+
+    _backgroundTimer.stop();
+
+#if VERBOSE_PATCHES
+    logDebug() << "Background pass done for " << _patches.size() << " patches" << endl;
+#endif
+}
+
+
+bool
+YQPkgPatchList::prefetchValid() const
+{
+    YQPkgPatchListItem * item = nextFilterItem();
+
+    if ( ! item )
+        return true; // Nothing to prefetch
+
+    return haveCachedContents( item->selectable() );
+}
+
+
+bool
+YQPkgPatchList::prefetchSlice( int maxItems )
+{
+    Q_UNUSED( maxItems );
+
+    YQPkgPatchListItem * item = nextFilterItem();
+
+    if ( item )
+        patchContents( item->selectable() );
+
+    return true;
+}
+
+
+YQPkgPatchListItem *
+YQPkgPatchList::nextFilterItem() const
+{
+    return selection() ? selection() : firstPatchItem();
+}
+
+
 void
 YQPkgPatchList::addPatchItem( ZyppSel   selectable,
                               ZyppPatch zyppPatch )
@@ -436,21 +600,30 @@ YQPkgPatchList::keyPressEvent( QKeyEvent * event )
 void
 YQPkgPatchList::selectSomething()
 {
-    QTreeWidgetItemIterator it( this );
+    YQPkgPatchListItem * patchItem = firstPatchItem();
+
+    if ( patchItem ) // Select a real patch, not a category
+        setCurrentItem( patchItem ); // Sends a signal
+}
+
+
+YQPkgPatchListItem *
+YQPkgPatchList::firstPatchItem() const
+{
+    QTreeWidgetItemIterator it( const_cast<YQPkgPatchList *>( this ) );
 
     while ( *it )
     {
         YQPkgPatchListItem * patchItem =
             dynamic_cast<YQPkgPatchListItem *>( *it );
 
-        if ( patchItem ) // Select a real patch, not a category
-        {
-            setCurrentItem( patchItem ); // Sends a signal
-            return;
-        }
+        if ( patchItem )
+            return patchItem;
 
         ++it;
     }
+
+    return 0;
 }
 
 
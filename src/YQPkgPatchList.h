@@ -22,6 +22,12 @@
 
 #include <string>
 
+#include <QHash>
+#include <QTimer>
+#include <QVector>
+
+#include "FilterPrefetcher.h"
+#include "PkgBitset.h"
 #include "QY2ListView.h"
 #include "YQPkgObjList.h"
 #include "YQZypp.h"
@@ -46,8 +52,16 @@ enum YQPkgPatchCategory // This is also the sort order
 
 /**
  * Display a list of zypp::Patch objects.
+ *
+ * Classifying the patches (needed or not) is expensive on systems with many
+ * patches, so the result is cached for the current pool generation and
+ * shared by all instances and by the static methods. Switching the filter
+ * criteria only re-buckets the cached classification.
+ *
+ * The content of each patch is cached as well. Both caches are filled in the
+ * background in small slices while the GUI is idle.
  **/
-class YQPkgPatchList : public YQPkgObjList
+class YQPkgPatchList : public YQPkgObjList, public PrefetchableFilter
 {
     Q_OBJECT
 
@@ -93,6 +107,33 @@ public:
      **/
     static int countNeededPatches();
 
+    /**
+     * Return 'true' if the content of the patch that will be shown next is
+     * in the cache.
+     *
+     * Implemented from PrefetchableFilter.
+     **/
+    virtual bool prefetchValid() const override;
+
+    /**
+     * Calculate the content of the patch that will be shown next.
+     * This is always done in one slice.
+     *
+     * Implemented from PrefetchableFilter.
+     **/
+    virtual bool prefetchSlice( int maxItems ) override;
+
+    /**
+     * Return the set of packages of 'patch'. This uses the cache if
+     * possible; otherwise it calculates the content and caches it.
+     **/
+    PkgBitset patchContents( ZyppSel patch );
+
+    /**
+     * Return 'true' if the content of 'patch' is in the cache.
+     **/
+    bool haveCachedContents( ZyppSel patch ) const;
+
 
 public slots:
 
@@ -136,6 +177,22 @@ public slots:
      **/
     virtual void selectSomething() override;
 
+    /**
+     * Start classifying all patches and calculating their content in the
+     * background. Connect this to a signal that is emitted after a solver
+     * run.
+     **/
+    void startBackgroundPass();
+
+
+protected slots:
+
+    /**
+     * Classify the next few patches or calculate the content of the next
+     * patch in the background pass.
+     **/
+    void calcNextPatchSlice();
+
 
 public:
 
@@ -197,14 +254,55 @@ protected:
      */
     YQPkgPatchCategoryItem * category( YQPkgPatchCategory category );
 
+    enum PatchRelevance
+    {
+        NeededPatch,        // relevant and not satisfied or to be installed
+        UnneededPatch,      // not relevant or satisfied
+        NoCandidatePatch    // shown only with AllPatches
+    };
+
+    struct PatchInfo
+    {
+        ZyppSel        selectable;
+        ZyppPatch      zyppPatch;
+        PatchRelevance relevance;
+    };
+
     /**
-     * Return 'true' if 'zyppPatch' is non-null and a needed patch, i.e. a
-     * relevant patch that is not installed or satisfied yet.
+     * Return the relevance class of a patch. This is what fillList() uses
+     * to decide which patches to show for which filter criteria.
      *
-     * A patch is relevant if the packages that it consists of are installed,
-     * but in older versions than the ones that the patch brings.
+     * A needed patch is a relevant patch that is not installed or satisfied
+     * yet. A patch is relevant if the packages that it consists of are
+     * installed, but in older versions than the ones that the patch brings.
+     **/
+    static PatchRelevance relevance( ZyppSel selectable, ZyppPatch zyppPatch );
+
+    /**
+     * Classify up to 'maxItems' more patches for the current pool
+     * generation. Return 'true' if all patches are classified.
+     *
+     * This restarts from the first patch if the pool generation changed
+     * and rebuilds the list of patches if the pool content changed.
+     **/
+    static bool classifyPatches( int maxItems );
+
+    /**
+     * Return the first patch item in the list (not a category)
+     * or 0 if there is none.
+     **/
+    YQPkgPatchListItem * firstPatchItem() const;
+
+    /**
+     * Return the patch item that filter() will use when this list is shown
+     * next: The current item or the one that selectSomething() would select.
      **/
-    static bool isNeeded( ZyppSel selectable, ZyppPatch zyppPatch );
+    YQPkgPatchListItem * nextFilterItem() const;
+
+    /**
+     * Clear the contents cache if the pool content changed.
+     **/
+    void checkContentsCache() const;
 
     /**
      * Create the context menu for items that are not installed.
@@ -233,6 +331,19 @@ protected:
 
     FilterCriteria _filterCriteria;
     QMap<YQPkgPatchCategory, YQPkgPatchCategoryItem*> _categories;
+
+    // Patch contents by patch selectable
+    mutable QHash<const zypp::ui::Selectable *, PkgBitset> _contents;
+    mutable int _contentsGeneration;
+
+    int    _nextContents;
+    QTimer _backgroundTimer;
+
+    // Classification of all patches, shared by all instances
+    static QVector<PatchInfo> _patches;
+    static int                _patchesContentGeneration;
+    static int                _relevanceGeneration;
+    static int                _nextToClassify;
 };
 
 
@@ -26,7 +26,10 @@
 #include <zypp/ui/Status.h>
 
 #include "Logger.h"
+#include "PkgIndex.h"
+#include "PoolGeneration.h"
 #include "QY2IconLoader.h"
+#include "SelectableIds.h"
 #include "YQIconPool.h"
 #include "YQi18n.h"
 #include "utf8.h"
@@ -47,6 +50,9 @@ YQPkgPatternList::YQPkgPatternList( QWidget * parent,
                                     bool      autoFilter )
     : YQPkgObjList( parent )
     , _orderCol( -1 )
+    , _packagesCol( -1 )
+    , _contentsGeneration( -1 )
+    , _statsGeneration( -1 )
 {
     logDebug() << "Creating pattern list" << endl;
 
@@ -62,6 +68,9 @@ YQPkgPatternList::YQPkgPatternList( QWidget * parent,
     headers << "";             _iconCol    = numCol++;
     headers << patternHeader;  _summaryCol = numCol++;
 
+    // Translators: Column header for "installed / total" package counts
+    headers << _( "Packages" ); _packagesCol = numCol++;
+
     // Set this environment variable to get an "Order" column in the patterns list
 
     if ( getenv( "Y2_SHOW_PATTERNS_ORDER" ) )
@@ -83,8 +92,9 @@ YQPkgPatternList::YQPkgPatternList( QWidget * parent,
     setAllColumnsShowFocus( true );
     setVerticalScrollMode( QAbstractItemView::ScrollPerPixel ); // bsc#1189550
 
-    header()->setSectionResizeMode( statusCol(),  QHeaderView::Fixed   );
-    header()->setSectionResizeMode( summaryCol(), QHeaderView::Stretch );
+    header()->setSectionResizeMode( statusCol(),   QHeaderView::Fixed            );
+    header()->setSectionResizeMode( summaryCol(),  QHeaderView::Stretch          );
+    header()->setSectionResizeMode( packagesCol(), QHeaderView::ResizeToContents );
     header()->resizeSection( statusCol(), 25 );
 
     setColumnWidth( statusCol(),   25 );
@@ -100,6 +110,13 @@ YQPkgPatternList::YQPkgPatternList( QWidget * parent,
     setIconSize(QSize(32,32));
     header()->resizeSection( iconCol(), 34 );
 
+    // Calculate one pattern's content and statistics whenever the event
+    // loop is idle
+    _statsTimer.setInterval( 0 );
+
+    connect( &_statsTimer, SIGNAL( timeout()              ),
+             this,         SLOT  ( calcNextPatternStats() ) );
+
     if ( autoFill )
     {
         fillList();
@@ -132,6 +149,7 @@ void
 YQPkgPatternList::fillList()
 {
     _categories.clear();
+    _pendingStats.clear();
 
     clear();
     logDebug() << "Filling pattern list" << endl;
@@ -167,6 +185,8 @@ YQPkgPatternList::fillList()
 
     resizeColumnToContents( _iconCol   );
     resizeColumnToContents( _statusCol );
+
+    startPatternStats();
 }
 
 
@@ -213,41 +233,186 @@ YQPkgPatternList::filter()
 
     emit filterStart();
 
-    if ( selection() )  // The seleted QListViewItem
+    YQPkgPatternListItem * item = selection(); // The seleted QListViewItem
+
+    if ( item && item->zyppPattern() )
     {
-        ZyppPattern zyppPattern = selection()->zyppPattern();
+        PkgBitset contents = patternContents( item->selectable() );
 
-        if ( zyppPattern )
+        for ( int id = contents.next( 0 ); id >= 0; id = contents.next( id + 1 ) )
         {
-            int total = 0;
-            int installed = 0;
+            ZyppSel selectable = SelectableIds::selectable( id );
+            ZyppPkg zyppPkg    = tryCastToZyppPkg( selectable->theObj() );
 
-            zypp::Pattern::Contents contents( zyppPattern->contents() );
+            if ( zyppPkg )
+                emit filterMatch( selectable, zyppPkg );
+        }
 
-            for ( zypp::Pattern::Contents::Selectable_iterator it = contents.selectableBegin();
-                  it != contents.selectableEnd();
-                  ++it )
-            {
-                ZyppPkg zyppPkg = tryCastToZyppPkg( (*it)->theObj() );
+        updatePatternStats( item );
+    }
+
+    emit filterFinished();
+    resizeColumnToContents( _statusCol );
+}
 
-                if ( zyppPkg )
-                {
-                    if ( (*it)->installedSize() > 0 )
-                        ++installed;
-                    ++total;
 
-                    emit filterMatch( *it, zyppPkg );
-                }
-            }
+PkgBitset
+YQPkgPatternList::patternContents( ZyppSel pattern )
+{
+    checkContentsCache();
+
+    auto it = _contents.find( pattern.get() );
 
-            selection()->setInstalledPackages( installed );
-            selection()->setTotalPackages( total );
-            selection()->resetToolTip();
+    if ( it != _contents.end() )
+        return it.value();
+
+    PkgBitset   contents( SelectableIds::count() );
+    ZyppPattern zyppPattern = tryCastToZyppPattern( pattern->theObj() );
+
+    if ( zyppPattern )
+    {
+        zypp::Pattern::Contents patternContents( zyppPattern->contents() );
+
+        for ( zypp::Pattern::Contents::Selectable_iterator it = patternContents.selectableBegin();
+              it != patternContents.selectableEnd();
+              ++it )
+        {
+            int id = SelectableIds::id( *it ); // -1 for anything but packages
+
+            if ( id >= 0 )
+                contents.set( id );
         }
     }
 
-    emit filterFinished();
-    resizeColumnToContents( _statusCol );
+    _contents.insert( pattern.get(), contents );
+
+    return contents;
+}
+
+
+bool
+YQPkgPatternList::haveCachedContents( ZyppSel pattern ) const
+{
+    checkContentsCache();
+
+    return _contents.contains( pattern.get() );
+}
+
+
+void
+YQPkgPatternList::checkContentsCache() const
+{
+    int contentGeneration = PoolGeneration::contentGeneration();
+
+    if ( contentGeneration != _contentsGeneration )
+    {
+        _contents.clear();
+        _contentsGeneration = contentGeneration;
+    }
+}
+
+
+void
+YQPkgPatternList::updatePatternStats( YQPkgPatternListItem * item )
+{
+    if ( ! item || ! haveCachedContents( item->selectable() ) )
+        return;
+
+    int generation = PoolGeneration::current();
+
+    if ( generation != _statsGeneration )
+    {
+        _installedPkgs    = PkgIndex::instance()->withFlags( PkgIndex::Installed );
+        _notInstalledPkgs = PkgIndex::instance()->withFlags( 0, PkgIndex::Installed );
+        _statsGeneration  = generation;
+    }
+
+    PkgBitset contents  = patternContents( item->selectable() );
+    PkgBitset installed = contents;
+    PkgBitset missing   = contents;
+
+    installed &= _installedPkgs;
+    missing   &= _notInstalledPkgs;
+
+    item->setPackageStats( installed.count(),
+                           contents.count(),
+                           zypp::ByteCount( PkgIndex::instance()->totalDownloadSize( missing ) ) );
+}
+
+
+void
+YQPkgPatternList::startPatternStats()
+{
+    _pendingStats.clear();
+
+    QTreeWidgetItemIterator it( this );
+
+    while ( *it )
+    {
+        YQPkgPatternListItem * item = dynamic_cast<YQPkgPatternListItem *>( *it );
+
+        if ( item )
+            _pendingStats << item;
+
+        ++it;
+    }
+
+    if ( ! _pendingStats.isEmpty() )
+        _statsTimer.start();
+}
+
+
+void
+YQPkgPatternList::calcNextPatternStats()
+{
+    if ( _pendingStats.isEmpty() )
+    {
+        _statsTimer.stop();
+        return;
+    }
+
+    // Only one pattern per timer tick
+
+    YQPkgPatternListItem * item = _pendingStats.takeFirst();
+
+    patternContents( item->selectable() );
+    updatePatternStats( item );
+}
+
+
+bool
+YQPkgPatternList::prefetchValid() const
+{
+    YQPkgPatternListItem * item = nextFilterItem();
+
+    if ( ! item )
+        return true; // Nothing to prefetch
+
+    return haveCachedContents( item->selectable() );
+}
+
+
+bool
+YQPkgPatternList::prefetchSlice( int maxItems )
+{
+    Q_UNUSED( maxItems );
+
+    YQPkgPatternListItem * item = nextFilterItem();
+
+    if ( item )
+    {
+        patternContents( item->selectable() );
+        updatePatternStats( item );
+    }
+
+    return true;
+}
+
+
+YQPkgPatternListItem *
+YQPkgPatternList::nextFilterItem() const
+{
+    return selection() ? selection() : firstPatternItem();
 }
 
 
@@ -325,22 +490,30 @@ YQPkgPatternList::pkgObjClicked( int               button,
 void
 YQPkgPatternList::selectSomething()
 {
-    QTreeWidgetItemIterator it( this );
+    YQPkgPatternListItem * item = firstPatternItem();
+
+    if ( item ) // Select a real pattern, not a category
+        setCurrentItem( item ); // Sends a signal
+}
+
+
+YQPkgPatternListItem *
+YQPkgPatternList::firstPatternItem() const
+{
+    QTreeWidgetItemIterator it( const_cast<YQPkgPatternList *>( this ) );
 
     while ( *it )
     {
-        QTreeWidgetItem * item = *it;
-        YQPkgPatternCategoryItem * categoryItem =
-            dynamic_cast<YQPkgPatternCategoryItem *>( item );
+        YQPkgPatternListItem * patternItem =
+            dynamic_cast<YQPkgPatternListItem *>( *it );
 
-        if ( ! categoryItem ) // Select a real pattern, not a category
-        {
-            setCurrentItem( item ); // Sends a signal
-            return;
-        }
+        if ( patternItem )
+            return patternItem;
 
         ++it;
     }
+
+    return 0;
 }
 
 
@@ -464,6 +637,22 @@ YQPkgPatternListItem::cycleStatus()
 }
 
 
+void
+YQPkgPatternListItem::setPackageStats( int             installed,
+                                       int             total,
+                                       zypp::ByteCount downloadSize )
+{
+    _installed    = installed;
+    _total        = total;
+    _downloadSize = downloadSize;
+
+    if ( _patternList->packagesCol() >= 0 )
+        setText( _patternList->packagesCol(), QString( "%1 / %2" ).arg( installed ).arg( total ) );
+
+    resetToolTip();
+}
+
+
 void
 YQPkgPatternListItem::resetToolTip()
 {
@@ -475,7 +664,23 @@ YQPkgPatternListItem::resetToolTip()
         infoToolTip += ("<p>" + zypp::str::form("%d / %d", installedPackages(), totalPackages() ) + "</p>");
     }
 
-    setToolTip(_patternList->summaryCol(), fromUTF8( infoToolTip ) );
+    QString toolTip = fromUTF8( infoToolTip );
+
+    if ( downloadSize() > 0 )
+    {
+        // Translators: %1 is a size like "42.0 MiB"
+        toolTip += "<p>" + _( "Download size: %1" ).arg( fromUTF8( downloadSize().asString() ) ) + "</p>";
+    }
+
+    setToolTip(_patternList->summaryCol(), toolTip );
+}
+
+
+void
+YQPkgPatternListItem::updateStatus()
+{
+    YQPkgObjListItem::updateStatus();
+    _patternList->updatePatternStats( this );
 }
 
 
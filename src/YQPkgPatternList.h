@@ -18,10 +18,16 @@
 #ifndef YQPkgPatternList_h
 #define YQPkgPatternList_h
 
+#include <QHash>
+#include <QList>
 #include <QMap>
+#include <QTimer>
 
+#include <zypp/ByteCount.h>
 #include <zypp/Pattern.h>
 
+#include "FilterPrefetcher.h"
+#include "PkgBitset.h"
 #include "QY2ListView.h"
 #include "YQPkgObjList.h"
 #include "YQZypp.h"
@@ -33,8 +39,14 @@ class YQPkgPatternCategoryItem;
 
 /**
  * Display a list of zypp::Pattern objects.
+ *
+ * The contents of all patterns and their statistics (installed and total
+ * packages, download size) are calculated in small steps while the GUI is
+ * idle after the list is filled, and they are cached: The contents until the
+ * pool content changes, the statistics until the pool generation changes.
+ * Clicking on a pattern just fills the package list from that cache.
  **/
-class YQPkgPatternList : public YQPkgObjList
+class YQPkgPatternList : public YQPkgObjList, public PrefetchableFilter
 {
     Q_OBJECT
 
@@ -76,6 +88,46 @@ public:
      **/
     bool showInvisiblePatterns() const { return _showInvisiblePatterns; }
 
+    /**
+     * Column number for the "installed / total packages" column.
+     **/
+    int packagesCol() const { return _packagesCol; }
+
+    /**
+     * Return 'true' if the content of the pattern that will be shown next
+     * is already cached.
+     *
+     * Implemented from PrefetchableFilter.
+     **/
+    virtual bool prefetchValid() const override;
+
+    /**
+     * Calculate the content of the pattern that will be shown next.
+     * This is always done in one slice.
+     *
+     * Implemented from PrefetchableFilter.
+     **/
+    virtual bool prefetchSlice( int maxItems ) override;
+
+    /**
+     * Return the set of packages of 'pattern'. This uses the cache if
+     * possible; otherwise it calculates the content and caches it.
+     **/
+    PkgBitset patternContents( ZyppSel pattern );
+
+    /**
+     * Return 'true' if the content of 'pattern' is in the cache.
+     **/
+    bool haveCachedContents( ZyppSel pattern ) const;
+
+    /**
+     * Update the statistics (installed and total packages, download size)
+     * of 'item' from the cached pattern content. Do nothing if the content
+     * of that pattern is not cached yet; the background calculation will
+     * take care of it.
+     **/
+    void updatePatternStats( YQPkgPatternListItem * item );
+
 
 public slots:
 
@@ -125,6 +177,15 @@ public slots:
     virtual void selectSomething() override;
 
 
+protected slots:
+
+    /**
+     * Calculate the content and the statistics of the next pattern in the
+     * background queue.
+     **/
+    void calcNextPatternStats();
+
+
 public:
 
     /**
@@ -161,6 +222,29 @@ protected:
      **/
     YQPkgPatternCategoryItem * category( const QString & categoryName );
 
+    /**
+     * Return the first pattern item (not category item) in the list
+     * or 0 if there is none.
+     **/
+    YQPkgPatternListItem * firstPatternItem() const;
+
+    /**
+     * Return the item whose content will be shown by the next filter():
+     * the selected one or, if there is none, the first one.
+     **/
+    YQPkgPatternListItem * nextFilterItem() const;
+
+    /**
+     * Queue all pattern items for the background calculation of their
+     * content and statistics and start it.
+     **/
+    void startPatternStats();
+
+    /**
+     * Drop all cached contents if the pool content changed.
+     **/
+    void checkContentsCache() const;
+
 
     //
     // Data members
@@ -169,7 +253,20 @@ protected:
     QMap<QString, YQPkgPatternCategoryItem*> _categories;
 
     int  _orderCol;
+    int  _packagesCol;
     bool _showInvisiblePatterns;
+
+    // Pattern contents by pattern selectable
+    mutable QHash<const zypp::ui::Selectable *, PkgBitset> _contents;
+    mutable int _contentsGeneration;
+
+    // Installed / not installed packages for the statistics
+    PkgBitset _installedPkgs;
+    PkgBitset _notInstalledPkgs;
+    int       _statsGeneration;
+
+    QList<YQPkgPatternListItem *> _pendingStats;
+    QTimer                        _statsTimer;
 };
 
 
@@ -220,17 +317,29 @@ public:
     int summaryCol() const { return _patternList->summaryCol(); }
     int orderCol()   const { return _patternList->orderCol();   }
 
-    int totalPackages()     const { return _total;     }
-    int installedPackages() const { return _installed; }
+    int             totalPackages()     const { return _total;        }
+    int             installedPackages() const { return _installed;    }
+    zypp::ByteCount downloadSize()      const { return _downloadSize; }
 
-    void setTotalPackages    ( int value ) { _total     = value; }
-    void setInstalledPackages( int value ) { _installed = value; }
+    /**
+     * Set the statistics of this pattern and display them.
+     **/
+    void setPackageStats( int             installed,
+                          int             total,
+                          zypp::ByteCount downloadSize );
 
     /**
      * resets the tooltip with the current available information
      */
     void resetToolTip();
 
+    /**
+     * Update this item's status and statistics.
+     *
+     * Reimplemented from YQPkgObjListItem.
+     **/
+    virtual void updateStatus() override;
+
 protected:
 
     /**
@@ -255,8 +364,9 @@ protected:
 
     // Cached values
 
-    int _total;
-    int _installed;
+    int             _total;
+    int             _installed;
+    zypp::ByteCount _downloadSize;
 };
 
 
@@ -17,6 +17,7 @@
 
 #include "Logger.h"
 #include "YQi18n.h"
+#include "YQPkgFilters.h"
 #include "YQPkgProductList.h"
 
 
@@ -69,15 +70,13 @@ YQPkgProductList::fillList()
     clear();
     // logVerbose() << "Filling product list" << endl;
 
-    for ( ZyppPoolIterator it = zyppProductsBegin();
-          it != zyppProductsEnd();
-          ++it )
+    for ( ZyppSel selectable: YQPkgFilters::productSelectables() )
     {
-        ZyppProduct zyppProduct = tryCastToZyppProduct( (*it)->theObj() );
+        ZyppProduct zyppProduct = tryCastToZyppProduct( selectable->theObj() );
 
         if ( zyppProduct )
         {
-            addProductItem( *it, zyppProduct );
+            addProductItem( selectable, zyppProduct );
         }
         else
         {
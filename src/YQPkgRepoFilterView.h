@@ -44,6 +44,11 @@ public:
      **/
     zypp::Repository selectedRepo() const;
 
+    /**
+     * Return the repo list inside this filter view.
+     **/
+    YQPkgRepoList * repoList() const { return _repoList; }
+
 
 protected:
 
@@ -23,6 +23,7 @@
 
 #include "Logger.h"
 #include "QY2IconLoader.h"
+#include "SelectableIds.h"
 #include "YQPkgFilters.h"
 #include "YQi18n.h"
 #include "utf8.h"
@@ -117,9 +118,44 @@ void YQPkgRepoList::filter()
         return;
     }
 
+    PkgBitset matches( SelectableIds::count() );
+    filterBits( matches, 0 );
+
+    for ( int id = matches.next( 0 ); id >= 0; id = matches.next( id + 1 ) )
+    {
+        ZyppSel selectable = SelectableIds::selectable( id );
+        emit filterMatch( selectable, tryCastToZyppPkg( selectable->theObj() ) );
+    }
+
+    emit filterFinished();
+}
+
+
+QString
+YQPkgRepoList::filterKey() const
+{
+    QString key( "repo:" );
+
+    for ( QTreeWidgetItem * item: selectedItems() )
+    {
+        YQPkgRepoListItem * repoItem = dynamic_cast<YQPkgRepoListItem *>( item );
+
+        if ( repoItem )
+            key += QString::fromUtf8( repoItem->zyppRepo().info().alias().c_str() ) + " ";
+    }
+
+    return key;
+}
+
+
+void
+YQPkgRepoList::filterBits( PkgBitset &       result,
+                           const PkgBitset * candidates )
+{
+    Q_UNUSED( candidates ); // The PoolQuery is cheap enough
 
     //
-    // Collect all packages of this repository
+    // Collect all packages of the selected repositories
     //
 
     QList<QTreeWidgetItem *> items = selectedItems();
@@ -142,12 +178,13 @@ void YQPkgRepoList::filter()
 	         it != query.selectableEnd();
                  ++it )
     	    {
-		emit filterMatch( *it, tryCastToZyppPkg( (*it)->theObj() ) );
+                int id = SelectableIds::id( *it );
+
+                if ( id >= 0 )
+                    result.set( id );
     	    }
 	}
     }
-
-    emit filterFinished();
 }
 
 
@@ -211,11 +248,7 @@ YQPkgRepoListItem::~YQPkgRepoListItem()
 ZyppProduct
 YQPkgRepoListItem::singleProduct( ZyppRepo zyppRepo )
 {
-    return YQPkgFilters::singleProductFilter( [&](const zypp::PoolItem & item )
-        {
-            // filter the products from the requested repository
-            return item.resolvable()->repoInfo().alias() == zyppRepo.info().alias();
-        } );
+    return YQPkgFilters::singleRepoProduct( zyppRepo.info().alias() );
 }
 
 
@@ -22,6 +22,7 @@
 
 #include "YQZypp.h"
 #include "QY2ListView.h"
+#include "PkgFilterEngine.h"
 
 
 class YQPkgRepoListItem;
@@ -36,7 +37,7 @@ typedef zypp::Repository ZyppRepo;
  * This is the simple version used in YQPkgRepoFilterView, not to confuse with
  * the more complex RepoTable in the RepoEditor.
  **/
-class YQPkgRepoList : public QY2ListView
+class YQPkgRepoList : public QY2ListView, public PkgFilterSource
 {
     Q_OBJECT
 
@@ -57,6 +58,26 @@ public:
      **/
     static int countEnabledRepositories();
 
+    /**
+     * Return a key identifying the currently selected repositories.
+     *
+     * Implemented from PkgFilterSource.
+     **/
+    virtual QString filterKey() const override;
+
+    /**
+     * Implemented from PkgFilterSource.
+     **/
+    virtual int filterCost() const override { return 1; }
+
+    /**
+     * Set the bits of all packages in the selected repositories.
+     *
+     * Implemented from PkgFilterSource.
+     **/
+    virtual void filterBits( PkgBitset &       result,
+                             const PkgBitset * candidates ) override;
+
 
 public slots:
 
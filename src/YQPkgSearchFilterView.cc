@@ -32,6 +32,7 @@
 #include "Exception.h"
 #include "Logger.h"
 #include "SearchFilter.h"
+#include "SelectableIds.h"
 #include "YQi18n.h"
 #include "utf8.h"
 
@@ -84,7 +85,7 @@ YQPkgSearchFilterView::~YQPkgSearchFilterView()
 
 
 SearchFilter
-YQPkgSearchFilterView::buildSearchFilterFromWidgets()
+YQPkgSearchFilterView::buildSearchFilterFromWidgets() const
 {
     SearchFilter searchFilter( _ui->searchText->text(),
                                (SearchFilter::FilterMode) _ui->searchMode->currentIndex() );
@@ -348,12 +349,20 @@ YQPkgSearchFilterView::filter()
 bool
 YQPkgSearchFilterView::check( ZyppSel   selectable,
                               ZyppObj   zyppObj )
+{
+    Q_UNUSED( selectable );
+
+    return check( zyppObj, buildSearchFilterFromWidgets() );
+}
+
+
+bool
+YQPkgSearchFilterView::check( ZyppObj              zyppObj,
+                              const SearchFilter & searchFilter )
 {
     if ( ! zyppObj )
         return false;
 
-    SearchFilter searchFilter( buildSearchFilterFromWidgets() );
-
     bool match =
         ( _ui->searchInName->isChecked()        && searchFilter.matches( zyppObj->name()         ) ) ||
         ( _ui->searchInSummary->isChecked()     && searchFilter.matches( zyppObj->summary()      ) ) ||
@@ -365,6 +374,44 @@ YQPkgSearchFilterView::check( ZyppSel   selectable,
 }
 
 
+QString
+YQPkgSearchFilterView::filterKey() const
+{
+    QString fields;
+
+    fields += _ui->searchInName->isChecked()        ? "n" : "-";
+    fields += _ui->searchInSummary->isChecked()     ? "s" : "-";
+    fields += _ui->searchInDescription->isChecked() ? "d" : "-";
+    fields += _ui->searchInProvides->isChecked()    ? "p" : "-";
+    fields += _ui->searchInRequires->isChecked()    ? "r" : "-";
+
+    return QString( "search:%1:%2:%3:%4" )
+        .arg( fields )
+        .arg( _ui->searchMode->currentIndex() )
+        .arg( _ui->caseSensitive->isChecked() ? 1 : 0 )
+        .arg( _ui->searchText->text() );
+}
+
+
+void
+YQPkgSearchFilterView::filterBits( PkgBitset &       result,
+                                   const PkgBitset * candidates )
+{
+    // Build the search filter (and its regexp) only once, not for each package
+
+    SearchFilter searchFilter( buildSearchFilterFromWidgets() );
+    int          size = SelectableIds::count();
+
+    for ( int id = candidates ? candidates->next( 0 ) : 0;
+          id >= 0 && id < size;
+          id = candidates ? candidates->next( id + 1 ) : id + 1 )
+    {
+        if ( check( SelectableIds::selectable( id )->theObj(), searchFilter ) )
+            result.set( id );
+    }
+}
+
+
 bool
 YQPkgSearchFilterView::checkCap( zypp::Capabilities   capSet,
                                  const SearchFilter & searchFilter )
@@ -23,6 +23,7 @@
 #include <QEvent>
 #include <QWidget>
 
+#include "PkgFilterEngine.h"
 #include "SearchFilter.h"
 
 
@@ -43,7 +44,7 @@ class QRadioButton;
 /**
  * Filter view for searching within packages
  **/
-class YQPkgSearchFilterView : public QWidget
+class YQPkgSearchFilterView : public QWidget, public PkgFilterSource
 {
     Q_OBJECT
 
@@ -66,6 +67,26 @@ public:
     bool check( ZyppSel selectable,
                 ZyppObj zyppObj );
 
+    /**
+     * Return a key identifying the current search criteria.
+     *
+     * Implemented from PkgFilterSource.
+     **/
+    virtual QString filterKey() const override;
+
+    /**
+     * Implemented from PkgFilterSource.
+     **/
+    virtual int filterCost() const override { return 100; }
+
+    /**
+     * Set the bits of all packages that match the current search criteria.
+     *
+     * Implemented from PkgFilterSource.
+     **/
+    virtual void filterBits( PkgBitset &       result,
+                             const PkgBitset * candidates ) override;
+
 
 public slots:
 
@@ -146,7 +167,13 @@ protected:
     /**
      * Build a SearchFilter object from the widgets.
      **/
-    SearchFilter buildSearchFilterFromWidgets();
+    SearchFilter buildSearchFilterFromWidgets() const;
+
+    /**
+     * Check one ResObject against a prebuilt search filter.
+     **/
+    bool check( ZyppObj              zyppObj,
+                const SearchFilter & searchFilter );
 
     /**
      * Key press event: Execute search upon 'Return'
@@ -20,7 +20,9 @@
 
 #include "Exception.h"
 #include "Logger.h"
+#include "PkgFilterEngine.h"
 #include "QY2ComboTabWidget.h"
+#include "SelectableIds.h"
 #include "YQPkgSearchFilterView.h"
 #include "YQPkgStatusFilterView.h"
 #include "YQi18n.h"
@@ -33,6 +35,11 @@
 
 YQPkgSecondaryFilterView::YQPkgSecondaryFilterView( QWidget * parent )
     : QWidget( parent )
+    , _primarySource( 0 )
+    , _secondaryFilters( 0 )
+    , _allPackages( 0 )
+    , _searchFilterView( 0 )
+    , _statusFilterView( 0 )
 {
 }
 
@@ -51,22 +58,38 @@ void YQPkgSecondaryFilterView::init(QWidget * primaryWidget)
 
     primaryWidget->setSizePolicy( QSizePolicy( QSizePolicy::Ignored, QSizePolicy::Expanding ) );// hor/vert
 
-    // Directly propagate signals filterStart() and filterFinished()
-    // from the primary filter to the outside
+    _primarySource = dynamic_cast<PkgFilterSource *>( primaryWidget );
 
-    connect( primaryWidget, SIGNAL( filterStart() ),
-             this,          SIGNAL( filterStart() ) );
+    if ( _primarySource )
+    {
+        // The primary widget is a list view that filters whenever its
+        // selection changes. Let it trigger the combined filter instead.
+
+        disconnect( primaryWidget, SIGNAL( itemSelectionChanged() ),
+                    primaryWidget, SLOT  ( filter()               ) );
 
-    connect( primaryWidget, SIGNAL( filterFinished() ),
-             this,          SIGNAL( filterFinished() ) );
+        connect( primaryWidget, SIGNAL( itemSelectionChanged() ),
+                 this,          SLOT  ( filter()               ) );
+    }
+    else
+    {
+        // Directly propagate signals filterStart() and filterFinished()
+        // from the primary filter to the outside
 
-    // Redirect filterMatch() and filterNearMatch() signals to the secondary filter
+        connect( primaryWidget, SIGNAL( filterStart() ),
+                 this,          SIGNAL( filterStart() ) );
 
-    connect( primaryWidget, SIGNAL( filterMatch             ( ZyppSel, ZyppPkg ) ),
-             this,          SLOT  ( primaryFilterMatch      ( ZyppSel, ZyppPkg ) ) );
+        connect( primaryWidget, SIGNAL( filterFinished() ),
+                 this,          SIGNAL( filterFinished() ) );
 
-    connect( primaryWidget, SIGNAL( filterNearMatch         ( ZyppSel, ZyppPkg ) ),
-             this,          SLOT  ( primaryFilterNearMatch  ( ZyppSel, ZyppPkg ) ) );
+        // Redirect filterMatch() and filterNearMatch() signals to the secondary filter
+
+        connect( primaryWidget, SIGNAL( filterMatch             ( ZyppSel, ZyppPkg ) ),
+                 this,          SLOT  ( primaryFilterMatch      ( ZyppSel, ZyppPkg ) ) );
+
+        connect( primaryWidget, SIGNAL( filterNearMatch         ( ZyppSel, ZyppPkg ) ),
+                 this,          SLOT  ( primaryFilterNearMatch  ( ZyppSel, ZyppPkg ) ) );
+    }
 
     layoutSecondaryFilters( splitter, primaryWidget );
 
@@ -119,8 +142,12 @@ YQPkgSecondaryFilterView::layoutSecondaryFilters( QWidget * parent, QWidget * pr
     CHECK_NEW( _searchFilterView );
     _secondaryFilters->addPage( _( "Search" ), _searchFilterView );
 
+    // Changing the secondary filter triggers filtering again
+
+    QWidget * filterTarget = _primarySource ? this : primaryWidget;
+
     connect( _searchFilterView, SIGNAL( filterStart() ),
-             primaryWidget,     SLOT  ( filter()      ) );
+             filterTarget,      SLOT  ( filter()      ) );
 
     connect( _secondaryFilters, SIGNAL( currentChanged( QWidget * ) ),
              this,              SLOT  ( filter()                    ) );
@@ -136,7 +163,7 @@ YQPkgSecondaryFilterView::layoutSecondaryFilters( QWidget * parent, QWidget * pr
     _secondaryFilters->addPage( _( "Installation Summary" ), _statusFilterView );
 
     connect( _statusFilterView, SIGNAL( filterStart() ),
-             primaryWidget,     SLOT  ( filter()      ) );
+             filterTarget,      SLOT  ( filter()      ) );
 
 
     // Collapse the secondary filters whenever "All Packages" is selected
@@ -159,7 +186,45 @@ void YQPkgSecondaryFilterView::filter()
     logVerbose() << metaObject()->className() << ": Filtering" << endl;
 #endif
 
-    primaryFilter();
+    if ( _primarySource )
+        engineFilter();
+    else
+        primaryFilter();
+}
+
+
+void YQPkgSecondaryFilterView::engineFilter()
+{
+    emit filterStart();
+
+    PkgFilterExpr expr( _primarySource );
+    PkgFilterSource * secondary = secondaryFilterSource();
+
+    if ( secondary )
+        expr = PkgFilterExpr::makeAnd( expr, PkgFilterExpr( secondary ) );
+
+    PkgBitset matches = PkgFilterEngine::instance()->evaluate( expr );
+
+    for ( int id = matches.next( 0 ); id >= 0; id = matches.next( id + 1 ) )
+    {
+        ZyppSel selectable = SelectableIds::selectable( id );
+        emit filterMatch( selectable, tryCastToZyppPkg( selectable->theObj() ) );
+    }
+
+    emit filterFinished();
+}
+
+
+PkgFilterSource *
+YQPkgSecondaryFilterView::secondaryFilterSource() const
+{
+    if ( _searchFilterView->isVisible() )
+        return _searchFilterView;
+
+    if ( _statusFilterView->isVisible() )
+        return _statusFilterView;
+
+    return 0;
 }
 
 
@@ -21,6 +21,7 @@
 #include "YQZypp.h"
 #include <QWidget>
 
+class PkgFilterSource;
 class QY2ComboTabWidget;
 class YQPkgSearchFilterView;
 class YQPkgStatusFilterView;
@@ -28,6 +29,11 @@ class YQPkgStatusFilterView;
 
 /**
  * Abstract base class for filter views containing a secondary filter
+ *
+ * If the primary widget is a PkgFilterSource, the primary and the secondary
+ * filter are combined in the PkgFilterEngine as set operations on bitsets;
+ * otherwise each match of the primary filter is checked against the
+ * secondary filter.
  */
 class YQPkgSecondaryFilterView: public QWidget
 {
@@ -136,9 +142,22 @@ protected:
      **/
     virtual void primaryFilter() = 0;
 
+    /**
+     * Filter with the PkgFilterEngine: Combine the primary and the secondary
+     * filter and emit filterMatch() for each package in the result.
+     **/
+    void engineFilter();
+
+    /**
+     * Return the currently selected secondary filter as a PkgFilterSource
+     * or 0 if there is none ("All Packages").
+     **/
+    PkgFilterSource * secondaryFilterSource() const;
+
 
     // Data members
 
+    PkgFilterSource *       _primarySource;
     QY2ComboTabWidget *     _secondaryFilters;
     QWidget *               _allPackages;
     YQPkgSearchFilterView * _searchFilterView;
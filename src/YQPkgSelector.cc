@@ -38,20 +38,27 @@
 #include <QMenu>
 #include <QMenuBar>
 #include <QMessageBox>
+#include <QProgressBar>
 #include <QPushButton>
 #include <QSettings>
 #include <QShortcut>
 #include <QSplitter>
 #include <QTabWidget>
 #include <QTimer>
+#include <QTreeWidgetItemIterator>
 #include <QVBoxLayout>
 
 #include "Exception.h"
+#include "FilterPrefetcher.h"
 #include "LicenseCache.h"
 #include "Logger.h"
 #include "QY2CursorHelper.h"
 #include "MyrlynApp.h"
+#include "MyrlynRepoManager.h"
+#include "PkgIndex.h"
+#include "PoolGeneration.h"
 #include "RepoConfigDialog.h"
+#include "StartupTimer.h"
 #include "YQPkgChangeLogView.h"
 #include "YQPkgChangesDialog.h"
 #include "YQPkgClassificationFilterView.h"
@@ -73,6 +80,7 @@
 #include "YQPkgServiceFilterView.h"
 #include "YQPkgStatusFilterView.h"
 #include "YQPkgTechnicalDetailsView.h"
+#include "YQPkgTextDialog.h"
 #include "YQPkgUpdatesFilterView.h"
 #include "YQPkgVersionsView.h"
 #include "YQZypp.h"
@@ -81,7 +89,7 @@
 
 #include "YQPkgSelector.h"
 
-#define CHECK_DEPENDENCIES_ON_STARTUP          0
+#define CHECK_DEPENDENCIES_ON_STARTUP          1
 #define FORCE_SHOW_NEEDED_PATCHES              0
 #define ENABLE_PATCH_MENU                      0
 #define ENABLE_VERIFY_SYSTEM_MODE_ACTION       0
@@ -109,10 +117,15 @@ YQPkgSelector::YQPkgSelector( QWidget * parent )
     , _patternList(0)
     , _statusFilterView(0)
     , _langList(0)
+    , _filterPrefetcher(0)
     , _pkgVersionsView(0)
     , _notificationsArea(0)
     , _switchToRepoLabel(0)
     , _cancelSwitchingToRepoLabel(0)
+    , _reloadReposLabel(0)
+    , _verifyArea(0)
+    , _verifyProgressBar(0)
+    , _acceptButton(0)
     , _menuBar(0)
     , _pkgMenu(0)
     , _patchMenu(0)
@@ -133,11 +146,20 @@ YQPkgSelector::YQPkgSelector( QWidget * parent )
     _showChangesDialog = true;
 
     logDebug() << "Creating YQPkgSelector..." << endl;
+    StartupTimer::instance()->begin( "YQPkgSelector" );
+
+    // The repos are loaded now: Build the package index in one go before
+    // the filter views start using it.
+    PkgIndex::instance()->update();
 
     basicLayout();
     addMenus();         // Only after all widgets are created!
     readSettings();     // Only after menus are created!
     makeConnections();
+
+    // Showing the initial filter page fills the package list
+
+    StartupTimer::instance()->begin( "firstListFill" );
     _filters->readSettings();
 
     if ( _filters->tabCount() == 0 )
@@ -147,13 +169,18 @@ YQPkgSelector::YQPkgSelector( QWidget * parent )
     }
 
     overrideInitialPage(); // Only for very important special cases!
+    StartupTimer::instance()->end( "firstListFill" );
 
     if ( _filters->diskUsageList() )
         _filters->diskUsageList()->updateDiskUsage();
 
+    createFilterPrefetcher();
+
     _blockResolver = false;
     firstSolverRun();
+    startBackgroundRefresh();
 
+    StartupTimer::instance()->end( "YQPkgSelector" );
     logDebug() << "YQPkgSelector init done" << endl;
 }
 
@@ -179,9 +206,13 @@ void YQPkgSelector::showFallbackPages()
         if ( _searchFilterView  ) _filters->showPage( _searchFilterView  );
         if ( _patchFilterView   ) _filters->showPage( _patchFilterView   );
         if ( _updatesFilterView ) _filters->showPage( _updatesFilterView );
-        if ( _repoFilterView    ) _filters->showPage( _repoFilterView    );
-        if ( _serviceFilterView ) _filters->showPage( _serviceFilterView );
-        if ( _patternList       ) _filters->showPage( _patternList       );
+
+        // Lazy pages: Their content is only created when they are selected
+
+        if ( _filters->findPage( "repos"    ) ) _filters->showPage( "repos"    );
+        if ( _filters->findPage( "services" ) ) _filters->showPage( "services" );
+        if ( _filters->findPage( "patterns" ) ) _filters->showPage( "patterns" );
+
         if ( _statusFilterView  ) _filters->showPage( _statusFilterView  );
     }
 
@@ -198,15 +229,17 @@ void YQPkgSelector::overrideInitialPage()
     // Don't add any generic fallback here; that would kill the effect of
     // writing and reading the page configuration to and from the settings.
 
-    if ( _pkgClassificationFilterView && anyRetractedPkgInstalled() )
+    if ( anyRetractedPkgInstalled() )
     {
         // Exceptional case: If the system has any retracted package installed,
         // switch to that filter view and show those packages.  This should
         // happen only very, very rarely.
 
         logInfo() << "Found installed retracted packages; switching to that view" << endl;
-        _filters->showPage( _pkgClassificationFilterView );
-        _pkgClassificationFilterView->showPkgClass( YQPkgClassRetractedInstalled );
+        _filters->showPage( "package_classification" ); // Creates the view
+
+        if ( _pkgClassificationFilterView )
+            _pkgClassificationFilterView->showPkgClass( YQPkgClassRetractedInstalled );
 
         // Also show a pop-up warning?
         //
@@ -234,10 +267,192 @@ void YQPkgSelector::firstSolverRun()
 
     // Fire up the first dependency check in the main loop.
     // Don't do this right away - wait until all initializations are finished.
+    //
+    // This runs in a worker process so the user can already browse.
 
-    if ( _pkgConflictDialog && ! MyrlynApp::isOptionSet( OptNoVerify ) )
-        QTimer::singleShot( 0, _pkgConflictDialog, SLOT( verifySystemWithBusyPopup() ) );
+    bool verify = _pkgConflictDialog && ! MyrlynApp::isOptionSet( OptNoVerify );
+
+    if ( verify )
+        QTimer::singleShot( 0, _pkgConflictDialog, SLOT( verifySystemInBackground() ) );
+#else
+    bool verify = false;
 #endif
+
+    // Classify all patches and cache their content while the GUI is idle.
+    // This is started again after each solver run.
+
+    if ( _patchFilterView )
+        QTimer::singleShot( 0, _patchFilterView->patchList(), SLOT( startBackgroundPass() ) );
+
+    // The startup is finished when the first background verify is finished
+    // (see backgroundVerifyFinished()) or right away without one.
+
+    if ( ! verify )
+        QTimer::singleShot( 0, this, SLOT( startupFinished() ) );
+}
+
+
+void YQPkgSelector::startBackgroundRefresh()
+{
+    MyrlynRepoManager * repoMan = MyrlynApp::instance() ? MyrlynApp::instance()->repoManager() : 0;
+
+    if ( ! repoMan || ! repoMan->backgroundRefreshPending() )
+        return;
+
+    connect( repoMan, SIGNAL( backgroundRefreshFinished( QStringList ) ),
+             this,    SLOT  ( backgroundRefreshFinished( QStringList ) ) );
+
+    // Don't commit anything based on outdated repo data
+
+    if ( _acceptButton )
+        _acceptButton->setEnabled( false );
+
+    _reloadReposLabel->setText( _( "Refreshing the repositories in the background..." ) );
+    _reloadReposLabel->show();
+    updateNotificationsArea();
+
+    // Wait until the package selector is visible
+    QTimer::singleShot( 0, repoMan, SLOT( startBackgroundRefresh() ) );
+}
+
+
+void YQPkgSelector::backgroundRefreshFinished( const QStringList & changedAliases )
+{
+    _changedRepos = changedAliases;
+
+    if ( _changedRepos.isEmpty() )
+    {
+        logInfo() << "No repo changed during the background refresh" << endl;
+        _reloadReposLabel->hide();
+
+        if ( _acceptButton )
+            _acceptButton->setEnabled( ! MyrlynApp::readOnlyMode() );
+    }
+    else
+    {
+        _reloadReposLabel->setText( _( "<p>New data for %1 repositories is available. "
+                                       "<a href=\"reload\">Reload now</a></p>" )
+                                    .arg( _changedRepos.size() ) );
+        _reloadReposLabel->show();
+    }
+
+    updateNotificationsArea();
+}
+
+
+void YQPkgSelector::reloadReposLinkActivated( const QString & link )
+{
+    if ( link != "reload" || _changedRepos.isEmpty() )
+        return;
+
+    busyCursor();
+    MyrlynApp::instance()->repoManager()->reloadRepos( _changedRepos );
+    _changedRepos.clear();
+    poolReloaded();
+    normalCursor();
+
+    _reloadReposLabel->hide();
+    updateNotificationsArea();
+
+    if ( _acceptButton )
+        _acceptButton->setEnabled( ! MyrlynApp::readOnlyMode() );
+}
+
+
+void YQPkgSelector::targetReloaded()
+{
+    logInfo() << "Updating the views after a target reload" << endl;
+
+    // The state after the commit is the new baseline for detecting changes
+
+    zyppPool().saveState<zypp::Package>();
+    zyppPool().saveState<zypp::Pattern>();
+    zyppPool().saveState<zypp::Patch  >();
+
+    PoolGeneration::invalidate();
+    PkgIndex::instance()->update();
+
+    if ( _pkgList )
+        _pkgList->clear(); // Drop all old selectables
+
+    emit poolReloadNotify();
+
+    reset(); // This fills the current page again
+}
+
+
+void YQPkgSelector::backgroundVerifyStarted()
+{
+    StartupTimer::instance()->begin( "firstSolverRun" ); // Only the first time
+
+    _verifyArea->show();
+    updateNotificationsArea();
+}
+
+
+void YQPkgSelector::backgroundVerifyFinished()
+{
+    _verifyArea->hide();
+    updateNotificationsArea();
+
+    StartupTimer::instance()->end( "firstSolverRun" );
+    startupFinished(); // Only the first time
+}
+
+
+void YQPkgSelector::verifyLinkActivated( const QString & link )
+{
+    if ( link == "cancel" && _pkgConflictDialog )
+        _pkgConflictDialog->cancelBackgroundVerify();
+}
+
+
+void YQPkgSelector::poolReloaded()
+{
+    logInfo() << "Updating the views after a pool reload" << endl;
+
+    // Remember the current package to keep the user's view
+
+    std::string currentName;
+    YQPkgObjListItem * currentItem = _pkgList ?
+        dynamic_cast<YQPkgObjListItem *>( _pkgList->currentItem() ) : 0;
+
+    if ( currentItem && currentItem->selectable() )
+        currentName = currentItem->selectable()->name();
+
+    PoolGeneration::invalidate();
+    PkgIndex::instance()->update();
+
+    if ( _pkgList )
+        _pkgList->clear(); // Drop all old selectables
+
+    emit poolReloadNotify();
+
+    if ( _filters )
+        _filters->reloadCurrentPage();
+
+    if ( _pkgList && ! currentName.empty() )
+    {
+        QTreeWidgetItemIterator it( _pkgList );
+
+        while ( *it )
+        {
+            YQPkgObjListItem * item = dynamic_cast<YQPkgObjListItem *>( *it );
+
+            if ( item && item->selectable() && item->selectable()->name() == currentName )
+            {
+                _pkgList->setCurrentItem( item );
+                _pkgList->scrollToItem( item );
+                break;
+            }
+
+            ++it;
+        }
+    }
+
+    updatePageLabels();
+    updateSwitchRepoLabels();
+    resolveDependencies();
 }
 
 
@@ -256,7 +471,10 @@ void YQPkgSelector::basicLayout()
     CHECK_NEW( _filters );
 
     layout->addWidget( _filters );
+
+    StartupTimer::instance()->begin( "createFilterViews" );
     createFilterViews();
+    StartupTimer::instance()->end( "createFilterViews" );
     updatePageLabels();
     _filters->showPage( 0 );
 
@@ -275,17 +493,56 @@ void YQPkgSelector::createFilterViews()
     createSearchFilterView();         // Package search
     createPatchFilterView();          // Patches - if patches available or F2
     createUpdatesFilterView();        // Package update
-    createRepoFilterView();
-    createServiceFilterView();        // Only if services available
-    createPatternsFilterView();
+
+    // The content of the next pages is expensive to set up. It is only
+    // created when the page is shown for the first time, or in the
+    // background by the FilterPrefetcher when the user is idle; see
+    // createPageContent().
+
+    _filters->addLazyPage( _( "&Repositories" ),
+                           "repos", Qt::CTRL + Qt::SHIFT + Qt::Key_R );
+
+    if ( YQPkgServiceFilterView::any_service() ) // Only if a service is present
+    {
+        _filters->addLazyPage( _( "Ser&vices" ), "services" );
+
+        // No shortcut - this isn't used nearly enough to waste another
+        // key combination on it. There are only 26 to choose from.
+    }
+
+    if ( ! zyppPool().empty<zypp::Pattern>() )
+    {
+        _filters->addLazyPage( _( "Pa&tterns" ),
+                               "patterns", Qt::CTRL + Qt::SHIFT + Qt::Key_T );
+    }
 
     // Not visible by default
 
-    createPkgClassificationFilterView();
-    createLanguagesFilterView();
+    _filters->addLazyPage( _( "Package Classi&fication" ),
+                           "package_classification", Qt::CTRL + Qt::SHIFT + Qt::Key_F );
+
+    _filters->addLazyPage( _( "&Languages" ),
+                           "languages", Qt::CTRL + Qt::SHIFT + Qt::Key_L );
 
     // This should be the last one
     createStatusFilterView();        // a.k.a. intallation summary
+
+    connect( _filters, SIGNAL( pageContentNeeded( QString ) ),
+             this,     SLOT  ( createPageContent( QString ) ) );
+}
+
+
+void YQPkgSelector::createPageContent( const QString & pageId )
+{
+    logDebug() << "Creating the content of filter page " << pageId << endl;
+
+    if      ( pageId == "repos"                  ) createRepoFilterView();
+    else if ( pageId == "services"               ) createServiceFilterView();
+    else if ( pageId == "patterns"               ) createPatternsFilterView();
+    else if ( pageId == "package_classification" ) createPkgClassificationFilterView();
+    else if ( pageId == "languages"              ) createLanguagesFilterView();
+    else
+        logError() << "No content for filter page " << pageId << endl;
 }
 
 
@@ -327,61 +584,72 @@ void YQPkgSelector::createUpdatesFilterView()
 
 void YQPkgSelector::createRepoFilterView()
 {
+    if ( _repoFilterView )
+        return;
+
     _repoFilterView = new YQPkgRepoFilterView( this );
     CHECK_NEW( _repoFilterView );
 
-    _filters->addPage( _( "&Repositories" ), _repoFilterView,
-                       "repos", Qt::CTRL + Qt::SHIFT + Qt::Key_R );
-
+    _filters->setPageContent( "repos", _repoFilterView );
+    connectRepoFilterView();
 }
 
 
 void YQPkgSelector::createServiceFilterView()
 {
-    if ( YQPkgServiceFilterView::any_service() ) // Only if a service is present
-    {
-        _serviceFilterView = new YQPkgServiceFilterView( this );
-        CHECK_NEW( _serviceFilterView );
+    if ( _serviceFilterView )
+        return;
 
-        _filters->addPage( _( "Ser&vices" ), _serviceFilterView, "services" );
+    _serviceFilterView = new YQPkgServiceFilterView( this );
+    CHECK_NEW( _serviceFilterView );
 
-        // No shortcut - this isn't used nearly enough to waste another
-        // key combination on it. There are only 26 to choose from.
-    }
+    _filters->setPageContent( "services", _serviceFilterView );
+    connectServiceFilterView();
 }
 
 
 void YQPkgSelector::createPatternsFilterView()
 {
-    if ( ! zyppPool().empty<zypp::Pattern>() )
-    {
-        _patternList = new YQPkgPatternList( this );
-        CHECK_NEW( _patternList );
+    if ( _patternList )
+        return;
 
-        _filters->addPage( _( "Pa&tterns" ), _patternList,
-                           "patterns", Qt::CTRL + Qt::SHIFT + Qt::Key_T );
-    }
+    _patternList = new YQPkgPatternList( this );
+    CHECK_NEW( _patternList );
+
+    _filters->setPageContent( "patterns", _patternList );
+    connectPatternList();
+
+    if ( _filterPrefetcher )
+        _filterPrefetcher->addFilter( _patternList, _patternList );
 }
 
 
 void YQPkgSelector::createPkgClassificationFilterView()
 {
+    if ( _pkgClassificationFilterView )
+        return;
+
     _pkgClassificationFilterView = new YQPkgClassificationFilterView( this );
     CHECK_NEW( _pkgClassificationFilterView );
 
-    _filters->addPage( _( "Package Classi&fication" ), _pkgClassificationFilterView,
-                       "package_classification", Qt::CTRL + Qt::SHIFT + Qt::Key_F );
+    _filters->setPageContent( "package_classification", _pkgClassificationFilterView );
+
+    if ( _pkgList )
+        connectFilter( _pkgClassificationFilterView, _pkgList, false );
 }
 
 
 void YQPkgSelector::createLanguagesFilterView()
 {
+    if ( _langList )
+        return;
+
     _langList = new YQPkgLangList( this );
     CHECK_NEW( _langList );
     _langList->setSizePolicy( QSizePolicy( QSizePolicy::Ignored, QSizePolicy::Ignored ) ); // hor/vert
 
-    _filters->addPage( _( "&Languages" ), _langList,
-                       "languages", Qt::CTRL + Qt::SHIFT + Qt::Key_L );
+    _filters->setPageContent( "languages", _langList );
+    connectLangList();
 }
 
 
@@ -470,8 +738,41 @@ YQPkgSelector::layoutNotifications( QWidget * parent )
     _cancelSwitchingToRepoLabel->setWordWrap( true );
     _cancelSwitchingToRepoLabel->setVisible( false );
 
+    _reloadReposLabel = new QLabel( _notificationsArea );
+    _reloadReposLabel->setTextFormat( Qt::RichText );
+    _reloadReposLabel->setWordWrap( true );
+    _reloadReposLabel->setVisible( false );
+
+    // Busy indicator and label for the system verification in the background
+
+    _verifyArea = new QWidget( _notificationsArea );
+    CHECK_NEW( _verifyArea );
+    _verifyArea->setVisible( false );
+
+    QHBoxLayout * verifyLayout = new QHBoxLayout( _verifyArea );
+    CHECK_NEW( verifyLayout );
+    verifyLayout->setContentsMargins( 0, 0, 0, 0 );
+
+    _verifyProgressBar = new QProgressBar( _verifyArea );
+    CHECK_NEW( _verifyProgressBar );
+    _verifyProgressBar->setRange( 0, 0 ); // No real progress: busy indicator
+    _verifyProgressBar->setTextVisible( false );
+    _verifyProgressBar->setMaximumWidth( 100 );
+
+    QLabel * verifyLabel = new QLabel( _verifyArea );
+    CHECK_NEW( verifyLabel );
+    verifyLabel->setTextFormat( Qt::RichText );
+    verifyLabel->setWordWrap( true );
+    verifyLabel->setText( _( "<p>Verifying the system dependencies in the background... "
+                             "<a href=\"cancel\">Cancel</a></p>" ) );
+
+    verifyLayout->addWidget( _verifyProgressBar );
+    verifyLayout->addWidget( verifyLabel, 1 ); // stretch
+
     notificationsLayout->addWidget( _switchToRepoLabel   );
     notificationsLayout->addWidget( _cancelSwitchingToRepoLabel );
+    notificationsLayout->addWidget( _reloadReposLabel );
+    notificationsLayout->addWidget( _verifyArea );
 
 
     // If the user clicks on a link on the label, we have to check
@@ -485,6 +786,12 @@ YQPkgSelector::layoutNotifications( QWidget * parent )
     connect( _cancelSwitchingToRepoLabel, SIGNAL( linkActivated( QString ) ),
              this,                        SLOT  ( switchToRepo ( QString ) ) );
 
+    connect( _reloadReposLabel,           SIGNAL( linkActivated           ( QString ) ),
+             this,                        SLOT  ( reloadReposLinkActivated( QString ) ) );
+
+    connect( verifyLabel,                 SIGNAL( linkActivated      ( QString ) ),
+             this,                        SLOT  ( verifyLinkActivated( QString ) ) );
+
     updateSwitchRepoLabels();
 }
 
@@ -623,13 +930,13 @@ YQPkgSelector::layoutButtons( QWidget *parent )
              this,          SLOT  ( reject()   ) );
 
 
-    QPushButton * accept_button = new QPushButton( _( "&Accept" ), button_box );
-    CHECK_NEW( accept_button );
-    layout->addWidget(accept_button);
-    accept_button->setSizePolicy( QSizePolicy( QSizePolicy::Fixed, QSizePolicy::Fixed ) ); // hor/vert
-    accept_button->setEnabled( ! MyrlynApp::readOnlyMode() );
+    _acceptButton = new QPushButton( _( "&Accept" ), button_box );
+    CHECK_NEW( _acceptButton );
+    layout->addWidget( _acceptButton );
+    _acceptButton->setSizePolicy( QSizePolicy( QSizePolicy::Fixed, QSizePolicy::Fixed ) ); // hor/vert
+    _acceptButton->setEnabled( ! MyrlynApp::readOnlyMode() );
 
-    connect( accept_button, SIGNAL( clicked() ),
+    connect( _acceptButton, SIGNAL( clicked() ),
              this,          SLOT  ( accept()   ) );
 
     button_box->setFixedHeight( button_box->sizeHint().height() );
@@ -832,6 +1139,7 @@ YQPkgSelector::addMenus()
     extrasMenu->addAction( _( "Show &Products"         ), this, SLOT( showProducts()    ) );
     extrasMenu->addAction( _( "Show P&ackage Changes"  ), this, SLOT( showAutoPkgList() ) );
     extrasMenu->addAction( _( "Show &History"          ), this, SLOT( showHistory()     ) );
+    extrasMenu->addAction( _( "Show Startup &Timing"   ), this, SLOT( showStartupTiming() ) );
 
     extrasMenu->addSeparator();
 
@@ -940,15 +1248,12 @@ YQPkgSelector::makeConnections()
 {
     connectFilter( _searchFilterView,            _pkgList, false );
     connectFilter( _updatesFilterView,           _pkgList, false );
-    connectFilter( _repoFilterView,              _pkgList, false );
-    connectFilter( _serviceFilterView,           _pkgList, false );
-    connectFilter( _patternList,                 _pkgList );
-    connectFilter( _pkgClassificationFilterView, _pkgList, false );
-    connectFilter( _langList,                    _pkgList );
     connectFilter( _statusFilterView,            _pkgList, false );
 
+    // The views of the lazy filter pages are connected when they are created;
+    // see createPageContent().
+
     connectPatchFilterView();
-    connectPatternList();
 
     if ( _searchFilterView && _pkgList )
     {
@@ -956,25 +1261,6 @@ YQPkgSelector::makeConnections()
                  _pkgList,              SLOT  ( message( const QString & ) ) );
     }
 
-    if ( _repoFilterView && _pkgList )
-    {
-        connect( _repoFilterView,       SIGNAL( filterNearMatch  ( ZyppSel, ZyppPkg ) ),
-                 _pkgList,              SLOT  ( addPkgItemDimmed ( ZyppSel, ZyppPkg ) ) );
-    }
-
-    if ( _serviceFilterView && _pkgList )
-    {
-        connect( _serviceFilterView,    SIGNAL( filterNearMatch  ( ZyppSel, ZyppPkg ) ),
-                 _pkgList,              SLOT  ( addPkgItemDimmed ( ZyppSel, ZyppPkg ) ) );
-    }
-
-
-    if ( _langList )
-    {
-        connect( _langList, SIGNAL( statusChanged()           ),
-                 this,      SLOT  ( autoResolveDependencies() ) );
-    }
-
     if ( _pkgList && _filters->diskUsageList() )
     {
         connect( _pkgList,                      SIGNAL( statusChanged()   ),
@@ -989,12 +1275,6 @@ YQPkgSelector::makeConnections()
     connect( _filters, SIGNAL( currentChanged( QWidget * ) ),
              this,     SLOT  ( updateSwitchRepoLabels()    ) );
 
-    if ( _repoFilterView )
-    {
-        connect( _repoFilterView, SIGNAL( filterStart()           ),
-                 this,            SLOT  ( updateSwitchRepoLabels() ) );
-    }
-
 
     //
     // Connect package conflict dialog
@@ -1008,17 +1288,17 @@ YQPkgSelector::makeConnections()
                      _pkgList,                  SLOT  ( updateItemStates() ) );
         }
 
-        if ( _patternList )
-        {
-            connect( _pkgConflictDialog,        SIGNAL( updatePackages()   ),
-                     _patternList,              SLOT  ( updateItemStates() ) );
-        }
-
         if ( _filters->diskUsageList() )
         {
             connect( _pkgConflictDialog,        SIGNAL( updatePackages()   ),
                      _filters->diskUsageList(), SLOT  ( updateDiskUsage()  ) );
         }
+
+        connect( _pkgConflictDialog,    SIGNAL( backgroundVerifyStarted()  ),
+                 this,                  SLOT  ( backgroundVerifyStarted()  ) );
+
+        connect( _pkgConflictDialog,    SIGNAL( backgroundVerifyFinished() ),
+                 this,                  SLOT  ( backgroundVerifyFinished() ) );
     }
 
 
@@ -1108,6 +1388,9 @@ YQPkgSelector::hotkeyAddPatchFilterView()
 
         createPatchFilterView( true ); // force
         connectPatchFilterView();
+
+        if ( _filterPrefetcher && _patchFilterView )
+            _filterPrefetcher->addFilter( _patchFilterView, _patchFilterView->patchList() );
     }
 
     _filters->showPage( _patchFilterView );
@@ -1129,9 +1412,15 @@ YQPkgSelector::connectPatchFilterView()
 
         if ( _pkgConflictDialog )
         {
-            connect( _pkgConflictDialog, SIGNAL( updatePackages()   ),
-                     patchList,          SLOT  ( updateItemStates() ) );
+            connect( _pkgConflictDialog, SIGNAL( updatePackages()      ),
+                     patchList,          SLOT  ( updateItemStates()    ) );
+
+            connect( _pkgConflictDialog, SIGNAL( updatePackages()      ),
+                     patchList,          SLOT  ( startBackgroundPass() ) );
         }
+
+        connect( this,      SIGNAL( poolReloadNotify() ),
+                 patchList, SLOT  ( fillList()         ) );
     }
 
     if ( _filters && _patchFilterView )
@@ -1145,9 +1434,11 @@ YQPkgSelector::connectPatchFilterView()
 void
 YQPkgSelector::connectPatternList()
 {
-    if ( ! _patternList )
+    if ( ! _patternList || ! _pkgList )
         return;
 
+    connectFilter( _patternList, _pkgList );
+
     connect( _patternList, SIGNAL( statusChanged()           ),
              this,         SLOT  ( autoResolveDependencies() ) );
 
@@ -1156,6 +1447,86 @@ YQPkgSelector::connectPatternList()
         connect( _pkgConflictDialog, SIGNAL( updatePackages()   ),
                  _patternList,       SLOT  ( updateItemStates() ) );
     }
+
+    // Fill the list again after a pool reload
+
+    connect( this,          SIGNAL( poolReloadNotify() ),
+             _patternList,  SLOT  ( fillList()         ) );
+}
+
+
+void
+YQPkgSelector::connectRepoFilterView()
+{
+    if ( ! _repoFilterView || ! _pkgList )
+        return;
+
+    connectFilter( _repoFilterView, _pkgList, false );
+
+    connect( _repoFilterView,   SIGNAL( filterNearMatch  ( ZyppSel, ZyppPkg ) ),
+             _pkgList,          SLOT  ( addPkgItemDimmed ( ZyppSel, ZyppPkg ) ) );
+
+    // Hide and show the upgrade label when the user selects repositories
+
+    connect( _repoFilterView,   SIGNAL( filterStart()           ),
+             this,              SLOT  ( updateSwitchRepoLabels() ) );
+
+    connect( this,                        SIGNAL( poolReloadNotify() ),
+             _repoFilterView->repoList(), SLOT  ( fillList()         ) );
+}
+
+
+void
+YQPkgSelector::connectServiceFilterView()
+{
+    if ( ! _serviceFilterView || ! _pkgList )
+        return;
+
+    connectFilter( _serviceFilterView, _pkgList, false );
+
+    connect( _serviceFilterView, SIGNAL( filterNearMatch  ( ZyppSel, ZyppPkg ) ),
+             _pkgList,           SLOT  ( addPkgItemDimmed ( ZyppSel, ZyppPkg ) ) );
+
+    connect( this,                              SIGNAL( poolReloadNotify() ),
+             _serviceFilterView->serviceList(), SLOT  ( fillList()         ) );
+}
+
+
+void
+YQPkgSelector::connectLangList()
+{
+    if ( ! _langList || ! _pkgList )
+        return;
+
+    connectFilter( _langList, _pkgList );
+
+    connect( _langList, SIGNAL( statusChanged()           ),
+             this,      SLOT  ( autoResolveDependencies() ) );
+
+    connect( this,      SIGNAL( poolReloadNotify() ),
+             _langList, SLOT  ( fillList()         ) );
+}
+
+
+void
+YQPkgSelector::createFilterPrefetcher()
+{
+    if ( ! _filters )
+        return;
+
+    _filterPrefetcher = new FilterPrefetcher( _filters );
+    CHECK_NEW( _filterPrefetcher );
+
+    if ( _updatesFilterView )
+        _filterPrefetcher->addFilter( _updatesFilterView, _updatesFilterView );
+
+    if ( _patchFilterView )
+        _filterPrefetcher->addFilter( _patchFilterView, _patchFilterView->patchList() );
+
+    if ( _patternList )
+        _filterPrefetcher->addFilter( _patternList, _patternList );
+
+    _filterPrefetcher->restartIdleTimer();
 }
 
 
@@ -1165,6 +1536,7 @@ YQPkgSelector::reset()
     logDebug() << "Reset" << endl;
 
     resetResolver();
+    PoolGeneration::invalidate();
     LicenseCache::confirmed()->clear();
 
     if ( _patchFilterView )
@@ -1191,10 +1563,37 @@ YQPkgSelector::configRepos()
 {
     logDebug() << endl;
 
+    MyrlynRepoManager * repoMan = MyrlynApp::instance()->repoManager();
+
+    if ( repoMan->backgroundRefreshRunning() )
+    {
+        // The refresh workers still use the repos that the dialog might
+        // change or delete
+
+        QMessageBox::information( this, // parent
+                                  "",   // window title
+                                  _( "The repositories are still being refreshed in the background.\n"
+                                     "Please try again when that is finished." ) );
+        return;
+    }
+
     RepoConfigDialog dialog;
     dialog.exec();
 
-    // FIXME: Make sure to restart the program after changing anything about repos.
+    const QStringList & changedRepos = dialog.changedRepos();
+
+    if ( changedRepos.isEmpty() )
+        return;
+
+    // Only refresh and load (or unload) the repos that changed; the target
+    // and all other repos remain in the pool as they are.
+
+    logInfo() << "Applying changes to repos " << changedRepos << endl;
+
+    busyCursor();
+    repoMan->applyRepoChanges( changedRepos );
+    poolReloaded();
+    normalCursor();
 }
 
 
@@ -1264,12 +1663,15 @@ YQPkgSelector::updateSwitchRepoLabels()
     if ( ! _repoFilterView || ! _repoFilterView->isVisible() )
     {
         if ( _notificationsArea )
-            _notificationsArea->hide();
+        {
+            _switchToRepoLabel->hide();
+            _cancelSwitchingToRepoLabel->hide();
+            updateNotificationsArea();
+        }
 
         return;
     }
 
-    _notificationsArea->show();
     _switchToRepoLabel->setText("");
     _cancelSwitchingToRepoLabel->setText("");
 
@@ -1327,8 +1729,22 @@ YQPkgSelector::updateSwitchRepoLabels()
     _switchToRepoLabel->setVisible( ! _switchToRepoLabel->text().isEmpty() );
     _cancelSwitchingToRepoLabel->setVisible( ! _cancelSwitchingToRepoLabel->text().isEmpty() );
 
-    _notificationsArea->setVisible( _switchToRepoLabel->isVisible() ||
-                                    _cancelSwitchingToRepoLabel->isVisible() );
+    updateNotificationsArea();
+}
+
+
+void
+YQPkgSelector::updateNotificationsArea()
+{
+    if ( ! _notificationsArea )
+        return;
+
+    // Use isHidden(), not isVisible(): The area itself might be hidden
+
+    _notificationsArea->setVisible( ! _switchToRepoLabel->isHidden()          ||
+                                    ! _cancelSwitchingToRepoLabel->isHidden() ||
+                                    ! _reloadReposLabel->isHidden()           ||
+                                    ! _verifyArea->isHidden() );
 }
 
 
@@ -1377,6 +1793,28 @@ YQPkgSelector::showProducts()
 }
 
 
+void
+YQPkgSelector::startupFinished()
+{
+    StartupTimer::instance()->finish();
+}
+
+
+void
+YQPkgSelector::showStartupTiming()
+{
+    StartupTimer * timer = StartupTimer::instance();
+
+    QString html = YQPkgTextDialog::htmlHeading( _( "Startup Timing" ) );
+    html += "<pre>" + YQPkgTextDialog::htmlEscape( timer->summary() ) + "</pre>";
+
+    if ( timer->isFinished() )
+        html += "<p>" + _( "Full report: %1" ).arg( timer->reportFileName() ) + "</p>";
+
+    YQPkgTextDialog::showText( this, html );
+}
+
+
 void
 YQPkgSelector::showHistory()
 {
@@ -1411,6 +1849,8 @@ YQPkgSelector::installRecommendedPkgs()
     zypp::getZYpp()->resolver()->setIgnoreAlreadyRecommended( false );
     resolveDependencies();
 
+    PoolGeneration::invalidate();
+
     if ( _filters && _statusFilterView )
     {
         _filters->showPage( _statusFilterView );
@@ -1533,7 +1973,7 @@ YQPkgSelector::installSubPkgs( const QString & suffix )
 
                     if ( ! subPkg->installedObj() )
                     {
-                        subPkg->setStatus( S_Install );
+                        PkgIndex::setStatus( subPkg, S_Install );
                         logInfo() << "Installing subpackage " << subPkgName << endl;
                     }
                     break;
@@ -1546,12 +1986,12 @@ YQPkgSelector::installSubPkgs( const QString & suffix )
 
                     if ( ! subPkg->installedObj() )
                     {
-                        subPkg->setStatus( S_Install );
+                        PkgIndex::setStatus( subPkg, S_Install );
                         logInfo() << "Installing subpackage " << subPkgName << endl;
                     }
                     else
                     {
-                        subPkg->setStatus( S_Update );
+                        PkgIndex::setStatus( subPkg, S_Update );
                         logInfo() << "Updating subpackage " << subPkgName << endl;
                     }
                     break;
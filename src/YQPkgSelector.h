@@ -20,16 +20,19 @@
 
 #include <QWidget>
 #include <QColor>
+#include <QStringList>
 
 #include "YQPkgSelectorBase.h"
 #include "YQPkgObjList.h"
 
 class QLabel;
+class QProgressBar;
 class QPushButton;
 class QTabWidget;
 class QMenu;
 class QMenuBar;
 
+class FilterPrefetcher;
 class YQPkgChangeLogView;
 class YQPkgDependenciesView;
 class YQPkgDescriptionView;
@@ -86,6 +89,21 @@ public slots:
      **/
     void configRepos();
 
+    /**
+     * Update all views after repos were reloaded into the pool while the
+     * package selector is open: Fill the filter lists again, reload the
+     * current filter page and restore the current package if it still
+     * exists, and run the dependency resolver.
+     **/
+    void poolReloaded();
+
+    /**
+     * Update all views after the target was reloaded after a commit
+     * (see MyrlynRepoManager::reloadTargetIfChanged()). This includes
+     * reset().
+     **/
+    void targetReloaded();
+
     /**
      * Resolve package dependencies manually.
      *
@@ -192,6 +210,12 @@ protected slots:
      **/
     void hotkeyAddPatchFilterView();
 
+    /**
+     * Create the view for the lazy filter page 'pageId' and connect it.
+     * This is triggered by the filter tab when the page is needed.
+     **/
+    void createPageContent( const QString & pageId );
+
     /**
      * Set the status of all installed packages (all in the pool, not only
      * those currently displayed in the package list) to "update", if there is
@@ -216,6 +240,18 @@ protected slots:
      **/
     void showHistory();
 
+    /**
+     * Show a summary of the startup phase timers.
+     **/
+    void showStartupTiming();
+
+    /**
+     * Notification that the startup is finished: Write the startup report.
+     * This is called after the first background verify or, without one,
+     * from the event loop right after the constructor.
+     **/
+    void startupFinished();
+
     /**
      * a link in the repo upgrade label was clicked
      **/
@@ -237,6 +273,38 @@ protected slots:
      **/
     void openActionUrl();
 
+    /**
+     * Notification that the background repos refresh of a fast start is
+     * finished. If any repos changed, offer to reload them.
+     **/
+    void backgroundRefreshFinished( const QStringList & changedAliases );
+
+    /**
+     * A link in the repo reload notification was clicked.
+     **/
+    void reloadReposLinkActivated( const QString & link );
+
+    /**
+     * Notification that the system verification in the background started
+     * or finished: Show or hide its progress notification.
+     **/
+    void backgroundVerifyStarted();
+    void backgroundVerifyFinished();
+
+    /**
+     * A link in the system verification notification was clicked.
+     **/
+    void verifyLinkActivated( const QString & link );
+
+
+signals:
+
+    /**
+     * Emitted by poolReloaded() to make the filter lists fill themselves
+     * again with the new selectables.
+     **/
+    void poolReloadNotify();
+
 public:
 
     /**
@@ -265,6 +333,19 @@ protected:
      **/
     void firstSolverRun();
 
+    /**
+     * If the repos were loaded from their old caches (fast start), refresh
+     * them in the background. Accepting is disabled until that is done and
+     * any changed repos are reloaded.
+     **/
+    void startBackgroundRefresh();
+
+    /**
+     * Show or hide the notifications area depending on whether any of its
+     * labels has something to show.
+     **/
+    void updateNotificationsArea();
+
 
     // Layout methods - create and layout widgets
 
@@ -279,7 +360,10 @@ protected:
     void        layoutMenuBar      ( QWidget * parent );
 
 
-    // Create the various filter views
+    // Create the various filter views.
+    //
+    // The views for the repos, services, patterns, package classification
+    // and languages pages are created lazily; see createPageContent().
 
     void createSearchFilterView();
     void createPatchFilterView( bool force = false );
@@ -343,6 +427,27 @@ protected:
      **/
     void connectPatternList();
 
+    /**
+     * Connect the repo filter view.
+     **/
+    void connectRepoFilterView();
+
+    /**
+     * Connect the service filter view.
+     **/
+    void connectServiceFilterView();
+
+    /**
+     * Connect the language list / filter view.
+     **/
+    void connectLangList();
+
+    /**
+     * Create the idle-time prefetcher for the expensive filter views and
+     * register those views with it.
+     **/
+    void createFilterPrefetcher();
+
     /**
      * Set the status of all installed packages (all in the pool, not only
      * those currently displayed in the package list) to "update" and switch to
@@ -400,11 +505,18 @@ protected:
     YQPkgStatusFilterView *             _statusFilterView;
     YQPkgLangList *                     _langList;
 
+    FilterPrefetcher *                  _filterPrefetcher;
+
     // Other widgets
     YQPkgVersionsView *                 _pkgVersionsView;
     QWidget *                           _notificationsArea;
     QLabel *                            _switchToRepoLabel;
     QLabel *                            _cancelSwitchingToRepoLabel;
+    QLabel *                            _reloadReposLabel;
+    QWidget *                           _verifyArea;
+    QProgressBar *                      _verifyProgressBar;
+    QPushButton *                       _acceptButton;
+    QStringList                         _changedRepos;
 
     // Menus
     QMenuBar *                          _menuBar;
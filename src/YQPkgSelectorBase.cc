@@ -24,9 +24,11 @@
 
 #include "LicenseCache.h"
 #include "Logger.h"
+#include "PkgIndex.h"
 #include "PkgTasks.h"
 #include "QY2CursorHelper.h"
 #include "MyrlynApp.h"
+#include "SelectableIds.h"
 #include "YQPkgChangesDialog.h"
 #include "YQPkgConflictDialog.h"
 #include "YQPkgDiskUsageList.h"
@@ -307,7 +309,20 @@ bool YQPkgSelectorBase::showPendingLicenseAgreements()
     allConfirmed = showPendingLicenseAgreements( zyppPatchesBegin(), zyppPatchesEnd() );
 #endif
 
-    allConfirmed = showPendingLicenseAgreements( zyppPkgBegin(), zyppPkgEnd() ) && allConfirmed;
+    // Find the packages to be installed or updated in the package index;
+    // the licenses need zypp calls, so they are only checked here for those
+    // few packages.
+
+    PkgIndex::StatusMask toInstall =
+        PkgIndex::statusBit( S_Install     ) |
+        PkgIndex::statusBit( S_AutoInstall ) |
+        PkgIndex::statusBit( S_Update      ) |
+        PkgIndex::statusBit( S_AutoUpdate  );
+
+    PkgBitset pkgs = PkgIndex::instance()->withStatus( toInstall );
+
+    for ( int id = pkgs.next( 0 ); id >= 0; id = pkgs.next( id + 1 ) )
+        allConfirmed = showPendingLicenseAgreement( SelectableIds::selectable( id ) ) && allConfirmed;
 
     return allConfirmed;
 }
@@ -318,46 +333,52 @@ bool YQPkgSelectorBase::showPendingLicenseAgreements( ZyppPoolIterator begin, Zy
     bool allConfirmed = true;
 
     for ( ZyppPoolIterator it = begin; it != end; ++it )
+        allConfirmed = showPendingLicenseAgreement( *it ) && allConfirmed;
+
+    return allConfirmed;
+}
+
+
+bool YQPkgSelectorBase::showPendingLicenseAgreement( ZyppSel sel )
+{
+    bool confirmed = true;
+
+    switch ( sel->status() )
     {
-        ZyppSel sel = (*it);
+        case S_Install:
+        case S_AutoInstall:
+        case S_Update:
+        case S_AutoUpdate:
 
-        switch ( sel->status() )
-        {
-            case S_Install:
-            case S_AutoInstall:
-            case S_Update:
-            case S_AutoUpdate:
+            if ( sel->candidateObj() )
+            {
+                string licenseText = sel->candidateObj()->licenseToConfirm();
 
-                if ( sel->candidateObj() )
+                if ( ! licenseText.empty() )
                 {
-                    string licenseText = sel->candidateObj()->licenseToConfirm();
-
-                    if ( ! licenseText.empty() )
+                    if (  sel->hasLicenceConfirmed() )
+                    {
+                        logInfo() << "Resolvable " << sel->name()
+                                  << "'s  license is already confirmed" << endl;
+                    }
+                    else if ( LicenseCache::confirmed()->contains( licenseText ) )
                     {
-                        if (  sel->hasLicenceConfirmed() )
-                        {
-                            logInfo() << "Resolvable " << sel->name()
-                                      << "'s  license is already confirmed" << endl;
-                        }
-                        else if ( LicenseCache::confirmed()->contains( licenseText ) )
-                        {
-                            logInfo() << "License verbatim confirmed before: " << sel->name() << endl;
-                        }
-                        else
-                        {
-                            logDebug() << "Showing license agreement for resolvable " << sel->name() << endl;
-                            allConfirmed = YQPkgObjListItem::showLicenseAgreement( sel ) && allConfirmed;
-                        }
+                        logInfo() << "License verbatim confirmed before: " << sel->name() << endl;
+                    }
+                    else
+                    {
+                        logDebug() << "Showing license agreement for resolvable " << sel->name() << endl;
+                        confirmed = YQPkgObjListItem::showLicenseAgreement( sel );
                     }
                 }
-                break;
+            }
+            break;
 
-            default:
-                break;
-        }
+        default:
+            break;
     }
 
-    return allConfirmed;
+    return confirmed;
 }
 
 
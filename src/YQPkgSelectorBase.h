@@ -181,6 +181,14 @@ protected:
     bool showPendingLicenseAgreements( ZyppPoolIterator begin,
                                        ZyppPoolIterator end );
 
+    /**
+     * Show the license agreement of one selectable if it will be installed
+     * or updated and the user has not confirmed it yet.
+     *
+     * Returns 'false' if the license was not confirmed.
+     **/
+    bool showPendingLicenseAgreement( ZyppSel selectable );
+
     /**
      * Event handler for keyboard input - for debugging and testing.
      *
@@ -48,6 +48,11 @@ public:
      */
     static bool any_service();
 
+    /**
+     * Return the service list inside this filter view.
+     **/
+    YQPkgServiceList * serviceList() const { return _serviceList; }
+
 protected:
 
     virtual void primaryFilter();
@@ -29,6 +29,7 @@
 
 #include "Logger.h"
 #include "QY2IconLoader.h"
+#include "SelectableIds.h"
 #include "YQPkgFilters.h"
 #include "YQi18n.h"
 #include "utf8.h"
@@ -117,6 +118,42 @@ YQPkgServiceList::filter()
 {
     emit filterStart();
 
+    PkgBitset matches( SelectableIds::count() );
+    filterBits( matches, 0 );
+
+    for ( int id = matches.next( 0 ); id >= 0; id = matches.next( id + 1 ) )
+    {
+        ZyppSel selectable = SelectableIds::selectable( id );
+        emit filterMatch( selectable, tryCastToZyppPkg( selectable->theObj() ) );
+    }
+
+    emit filterFinished();
+}
+
+
+QString
+YQPkgServiceList::filterKey() const
+{
+    QString key( "service:" );
+
+    for ( QTreeWidgetItem * item: selectedItems() )
+    {
+        YQPkgServiceListItem * serviceItem = dynamic_cast<YQPkgServiceListItem *>( item );
+
+        if ( serviceItem )
+            key += QString::fromUtf8( serviceItem->zyppService().c_str() ) + " ";
+    }
+
+    return key;
+}
+
+
+void
+YQPkgServiceList::filterBits( PkgBitset &       result,
+                              const PkgBitset * candidates )
+{
+    Q_UNUSED( candidates ); // The PoolQuery is cheap enough
+
     // logInfo() << "Collecting packages in selected services..." << endl;
 
     //
@@ -155,13 +192,14 @@ YQPkgServiceList::filter()
                            query.selectableEnd(),
                            [&](const zypp::ui::Selectable::Ptr &selectable)
                                {
-                                   emit filterMatch( selectable, tryCastToZyppPkg( selectable->theObj() ) );
+                                   int id = SelectableIds::id( selectable );
+
+                                   if ( id >= 0 )
+                                       result.set( id );
                                }
                            );
         }
     }
-
-    emit filterFinished();
 }
 
 
@@ -239,11 +277,7 @@ YQPkgServiceListItem::~YQPkgServiceListItem()
 ZyppProduct
 YQPkgServiceListItem::singleProduct( ZyppService zyppService )
 {
-    return YQPkgFilters::singleProductFilter( [&](const zypp::PoolItem & item)
-        {
-            // filter the products from the requested service
-            return item.resolvable()->repoInfo().service() == zyppService;
-        });
+    return YQPkgFilters::singleServiceProduct( zyppService );
 }
 
 
@@ -20,6 +20,7 @@
 
 #include <string>
 #include "QY2ListView.h"
+#include "PkgFilterEngine.h"
 #include "YQZypp.h"
 
 
@@ -36,7 +37,7 @@ typedef std::string ZyppService;
 /**
  * A widget to display a list of libzypp services.
  **/
-class YQPkgServiceList : public QY2ListView
+class YQPkgServiceList : public QY2ListView, public PkgFilterSource
 {
     Q_OBJECT
 
@@ -52,6 +53,26 @@ public:
      **/
     virtual ~YQPkgServiceList();
 
+    /**
+     * Return a key identifying the currently selected services.
+     *
+     * Implemented from PkgFilterSource.
+     **/
+    virtual QString filterKey() const override;
+
+    /**
+     * Implemented from PkgFilterSource.
+     **/
+    virtual int filterCost() const override { return 1; }
+
+    /**
+     * Set the bits of all packages from the repositories of the selected services.
+     *
+     * Implemented from PkgFilterSource.
+     **/
+    virtual void filterBits( PkgBitset &       result,
+                             const PkgBitset * candidates ) override;
+
 
 public slots:
 
@@ -19,6 +19,8 @@
 
 #include "Exception.h"
 #include "Logger.h"
+#include "PkgIndex.h"
+#include "SelectableIds.h"
 #include "YQIconPool.h"
 #include "YQPkgStatusFilterView.h"
 
@@ -114,23 +116,27 @@ YQPkgStatusFilterView::filter()
 
     emit filterStart();
 
-    for ( ZyppPoolIterator it = zyppPkgBegin();
-          it != zyppPkgEnd();
-          ++it )
+    PkgBitset matches = PkgIndex::instance()->withStatus( statusMask() );
+
+    for ( int id = matches.next( 0 ); id >= 0; id = matches.next( id + 1 ) )
     {
-        ZyppSel selectable = *it;
+        ZyppSel selectable = SelectableIds::selectable( id );
+
+        // Prefer the candidate, then the installed object. If there is
+        // neither, use any other instance.
+
+        ZyppObj zyppObj = selectable->candidateObj();
 
-        bool match =
-            check( selectable, selectable->candidateObj() ) ||
-            check( selectable, selectable->installedObj() );
+        if ( ! zyppObj )
+            zyppObj = selectable->installedObj();
 
-        // If there is neither an installed nor a candidate package, check
-        // any other instance.
+        if ( ! zyppObj )
+            zyppObj = selectable->theObj();
 
-        if ( ! match                      &&
-             ! selectable->candidateObj() &&
-             ! selectable->installedObj()   )
-            check( selectable,  selectable->theObj() );
+        ZyppPkg zyppPkg = tryCastToZyppPkg( zyppObj );
+
+        if ( zyppPkg )
+            emit filterMatch( selectable, zyppPkg );
     }
 
     emit filterFinished();
@@ -141,12 +147,29 @@ bool
 YQPkgStatusFilterView::check( ZyppSel selectable,
                               ZyppObj zyppObj )
 {
-    bool match = false;
-
     if ( ! zyppObj )
         return false;
 
-    switch ( selectable->status() )
+    bool match = statusMatch( selectable->status() );
+
+    if ( match )
+    {
+        ZyppPkg zyppPkg = tryCastToZyppPkg( zyppObj );
+
+        if ( zyppPkg )
+            emit filterMatch( selectable, zyppPkg );
+    }
+
+    return match;
+}
+
+
+bool
+YQPkgStatusFilterView::statusMatch( ZyppStatus status ) const
+{
+    bool match = false;
+
+    switch ( status )
     {
         case S_Install:       match = _ui->showInstall->isChecked();       break;
         case S_Update:        match = _ui->showUpdate->isChecked();        break;
@@ -163,15 +186,58 @@ YQPkgStatusFilterView::check( ZyppSel selectable,
             // catch unhandled enum states
     }
 
-    if ( match )
+    return match;
+}
+
+
+PkgIndex::StatusMask
+YQPkgStatusFilterView::statusMask() const
+{
+    PkgIndex::StatusMask mask = 0;
+
+    ZyppStatus allStates[] =
     {
-        ZyppPkg zyppPkg = tryCastToZyppPkg( zyppObj );
+        S_Install, S_Update, S_Del, S_AutoInstall, S_AutoUpdate,
+        S_AutoDel, S_Protected, S_Taboo, S_KeepInstalled, S_NoInst
+    };
 
-        if ( zyppPkg )
-            emit filterMatch( selectable, zyppPkg );
+    for ( ZyppStatus status: allStates )
+    {
+        if ( statusMatch( status ) )
+            mask |= PkgIndex::statusBit( status );
     }
 
-    return match;
+    return mask;
+}
+
+
+QString
+YQPkgStatusFilterView::filterKey() const
+{
+    QString key( "status:" );
+
+    key += _ui->showInstall->isChecked()       ? "i" : "-";
+    key += _ui->showUpdate->isChecked()        ? "u" : "-";
+    key += _ui->showDel->isChecked()           ? "d" : "-";
+    key += _ui->showAutoInstall->isChecked()   ? "I" : "-";
+    key += _ui->showAutoUpdate->isChecked()    ? "U" : "-";
+    key += _ui->showAutoDel->isChecked()       ? "D" : "-";
+    key += _ui->showProtected->isChecked()     ? "p" : "-";
+    key += _ui->showTaboo->isChecked()         ? "t" : "-";
+    key += _ui->showKeepInstalled->isChecked() ? "k" : "-";
+    key += _ui->showNoInst->isChecked()        ? "n" : "-";
+
+    return key;
+}
+
+
+void
+YQPkgStatusFilterView::filterBits( PkgBitset &       result,
+                                   const PkgBitset * candidates )
+{
+    Q_UNUSED( candidates ); // Checking all packages is cheap enough
+
+    result = PkgIndex::instance()->withStatus( statusMask() );
 }
 
 
@@ -19,6 +19,8 @@
 #define YQPkgStatusFilterView_h
 
 #include <QWidget>
+#include "PkgFilterEngine.h"
+#include "PkgIndex.h"
 #include "YQZypp.h"
 
 
@@ -33,7 +35,7 @@
 /**
  * Filter view for packages by status
  **/
-class YQPkgStatusFilterView : public QWidget
+class YQPkgStatusFilterView : public QWidget, public PkgFilterSource
 {
     Q_OBJECT
 
@@ -55,6 +57,26 @@ public:
     bool check( ZyppSel selectable,
                 ZyppObj pkg );
 
+    /**
+     * Return a key identifying the currently checked states.
+     *
+     * Implemented from PkgFilterSource.
+     **/
+    virtual QString filterKey() const override;
+
+    /**
+     * Implemented from PkgFilterSource.
+     **/
+    virtual int filterCost() const override { return 1; }
+
+    /**
+     * Set the bits of all packages with one of the checked states.
+     *
+     * Implemented from PkgFilterSource.
+     **/
+    virtual void filterBits( PkgBitset &       result,
+                             const PkgBitset * candidates ) override;
+
 
 public slots:
 
@@ -126,6 +148,16 @@ protected:
      **/
     void fixupIcons();
 
+    /**
+     * Return 'true' if the check box for 'status' is checked.
+     **/
+    bool statusMatch( ZyppStatus status ) const;
+
+    /**
+     * Return a PkgIndex status mask for all checked states.
+     **/
+    PkgIndex::StatusMask statusMask() const;
+
 
 
     // Data members
@@ -72,7 +72,7 @@ YQPkgTechnicalDetailsView::showDetails( ZyppSel selectable )
 
     html_text += htmlEnd();
 
-    setHtml( html_text );
+    setDetailsHtml( html_text );
 }
 
 
@@ -15,8 +15,13 @@
  */
 
 
+#include <limits>
+
 #include "Exception.h"
 #include "Logger.h"
+#include "PkgIndex.h"
+#include "PoolGeneration.h"
+#include "SelectableIds.h"
 #include "YQPkgConflictDialog.h"
 #include "YQPkgUpdatesFilterView.h"
 
@@ -28,6 +33,8 @@
 YQPkgUpdatesFilterView::YQPkgUpdatesFilterView( QWidget * parent )
     : QWidget( parent )
     , _ui( new Ui::UpdatesFilterView )  // Use the Qt designer .ui form (XML)
+    , _prefetchId( -1 )
+    , _prefetchGeneration( -1 )
 {
     CHECK_NEW( _ui );
     _ui->setupUi( this ); // Actually create the widgets from the .ui form
@@ -79,6 +86,11 @@ void YQPkgUpdatesFilterView::doDistUpgrade()
 
 void YQPkgUpdatesFilterView::refreshList()
 {
+    // The user explicitly asked for it, so don't trust any prefetched result
+
+    _prefetched.clear();
+    _prefetchGeneration = -1;
+
     filter();
 }
 
@@ -100,40 +112,66 @@ YQPkgUpdatesFilterView::filter()
 
     emit filterStart();
 
-    for ( ZyppPoolIterator it = zyppPkgBegin();
-          it != zyppPkgEnd();
-          ++it )
-    {
-        ZyppSel selectable = *it;
+    // If the updates were not prefetched in idle time, do all of the
+    // remaining work now in one go.
 
-        if ( isUpdateAvailableFor( selectable ) )
-        {
-            ZyppObj installed = selectable->installedObj();
-            ZyppPkg zyppPkg   = tryCastToZyppPkg( installed );
+    if ( ! _prefetched.isValid() )
+        prefetchSlice( std::numeric_limits<int>::max() );
 
-            if ( zyppPkg )
-                emit filterMatch( selectable, zyppPkg );
-        }
-    }
+    for ( const PkgMatchList::PkgMatch & match: _prefetched.matches() )
+        emit filterMatch( match.first, match.second );
 
     emit filterFinished();
 }
 
 
-int
-YQPkgUpdatesFilterView::countUpdates()
+bool
+YQPkgUpdatesFilterView::prefetchValid() const
 {
-    int count = 0;
+    return _prefetched.isValid();
+}
 
-    for ( ZyppPoolIterator it = zyppPkgBegin();
-          it != zyppPkgEnd();
-          ++it )
+
+bool
+YQPkgUpdatesFilterView::prefetchSlice( int maxItems )
+{
+    int generation = PoolGeneration::current();
+
+    if ( generation != _prefetchGeneration )
     {
-        if ( isUpdateAvailableFor( *it ) )
-            ++count;
+        // Start over: Package states or the pool content changed, so the
+        // partial result is worthless, and the iterator might be invalid.
+
+        _prefetched.clear();
+        _prefetchBits       = PkgIndex::instance()->withFlags( PkgIndex::UpdateAvailable );
+        _prefetchId         = _prefetchBits.next( 0 );
+        _prefetchGeneration = generation;
     }
 
-    return count;
+    for ( int count = 0;
+          count < maxItems && _prefetchId >= 0;
+          ++count, _prefetchId = _prefetchBits.next( _prefetchId + 1 ) )
+    {
+        ZyppSel selectable = SelectableIds::selectable( _prefetchId );
+        ZyppPkg zyppPkg    = tryCastToZyppPkg( selectable->installedObj() );
+
+        if ( zyppPkg )
+            _prefetched.add( selectable, zyppPkg );
+    }
+
+    if ( _prefetchId >= 0 )
+        return false;
+
+    _prefetched.setGeneration( generation );
+
+    return true;
+}
+
+
+int
+YQPkgUpdatesFilterView::countUpdates()
+{
+    return PkgIndex::instance()->countFlags( PkgIndex::UpdateAvailable );
 }
 
 
@@ -20,6 +20,8 @@
 
 
 #include <QWidget>
+#include "FilterPrefetcher.h"
+#include "PkgBitset.h"
 #include "YQZypp.h"
 
 
@@ -35,8 +37,10 @@
 /**
  * Filter view for packages that can be updated with push buttons
  * for "Package Update", "Dist Update", "Refresh List".
+ *
+ * The list of updates can be prefetched while the GUI is idle.
  **/
-class YQPkgUpdatesFilterView : public QWidget
+class YQPkgUpdatesFilterView : public QWidget, public PrefetchableFilter
 {
     Q_OBJECT
 
@@ -80,6 +84,22 @@ public:
      **/
     virtual QSize minimumSizeHint() const override;
 
+    /**
+     * Return 'true' if the prefetched list of updates is valid for the
+     * current pool generation.
+     *
+     * Implemented from PrefetchableFilter.
+     **/
+    virtual bool prefetchValid() const override;
+
+    /**
+     * Check the next 'maxItems' packages for updates. Return 'true' if all
+     * packages are checked.
+     *
+     * Implemented from PrefetchableFilter.
+     **/
+    virtual bool prefetchSlice( int maxItems ) override;
+
 
 public slots:
 
@@ -142,6 +162,11 @@ protected:
     // Data members
 
     Ui::UpdatesFilterView * _ui;
+
+    PkgMatchList            _prefetched;
+    PkgBitset               _prefetchBits;
+    int                     _prefetchId;
+    int                     _prefetchGeneration;
 };
 
 
@@ -36,7 +36,10 @@
 #include <zypp/sat/SolvableType.h>
 #include <zypp/ui/Status.h>
 
+#include "Exception.h"
 #include "Logger.h"
+#include "PkgIndex.h"
+#include "PoolGeneration.h"
 #include "YQIconPool.h"
 #include "YQZypp.h"
 #include "YQi18n.h"
@@ -51,12 +54,42 @@
 
 YQPkgVersionsView::YQPkgVersionsView( QWidget * parent )
     : QScrollArea( parent )
+    , _content( 0 )
     , _buttonGroup( 0 )
     , _layout( 0 )
+    , _pkgNameLabel( 0 )
+    , _shownGeneration( -1 )
+    , _pendingDetails( false )
 {
     _selectable          = 0;
     _isMixedMultiVersion = false;
     setFrameStyle( QFrame::NoFrame );
+    setWidgetResizable( true );
+
+    _content = new QWidget( this );
+    CHECK_NEW( _content );
+
+    _buttonGroup = new QButtonGroup( _content );
+    CHECK_NEW( _buttonGroup );
+
+    _layout = new QVBoxLayout( _content );
+    CHECK_NEW( _layout );
+
+    _pkgNameLabel = new QLabel( _content );
+    CHECK_NEW( _pkgNameLabel );
+
+    QFont font = _pkgNameLabel->font();
+    font.setBold( true );
+
+    QFontMetrics fm( font) ;
+    font.setPixelSize( (int) ( fm.height() * 1.1 ) );
+    _pkgNameLabel->setFont( font );
+    _pkgNameLabel->hide();
+
+    _layout->addWidget( _pkgNameLabel );
+    _layout->addStretch();
+
+    setWidget( _content );
 
     _parentTab = dynamic_cast<QTabWidget *>( parent );
 
@@ -86,7 +119,6 @@ void
 YQPkgVersionsView::showDetailsIfVisible( ZyppSel selectable )
 {
     _selectable = selectable;
-    _isMixedMultiVersion = isMixedMultiVersion( selectable );
 
     if ( _parentTab )   // Is this view embedded into a tab widget?
     {
@@ -101,48 +133,58 @@ YQPkgVersionsView::showDetailsIfVisible( ZyppSel selectable )
             showDetails( selectable );
         }
     }
-    else                // No tab parent - simply show data unconditionally.
+    else if ( isVisible() )
     {
         showDetails( selectable );
     }
+    else                // Wait until this view is shown
+    {
+        _pendingDetails = true;
+    }
 }
 
 
 void
-YQPkgVersionsView::showDetails( ZyppSel selectable )
+YQPkgVersionsView::showEvent( QShowEvent * event )
 {
-    _selectable          = selectable;
-    _isMixedMultiVersion = isMixedMultiVersion( selectable );
-    QWidget * content    = widget();
+    QScrollArea::showEvent( event );
 
-    delete content; // This recursively deletes all child widgets and qobjects
+    if ( _pendingDetails && ! _parentTab )
+        showDetails( _selectable );
+}
 
-    content      = new QWidget( this );
-    _buttonGroup = new QButtonGroup( content );
-    _layout      = new QVBoxLayout( content );
-    content->setLayout( _layout );
 
-    if ( ! selectable )
+void
+YQPkgVersionsView::showDetails( ZyppSel selectable )
+{
+    _selectable     = selectable;
+    _pendingDetails = false;
+
+    if ( selectable == _shownSelectable &&
+         PoolGeneration::current() == _shownGeneration )
     {
-        setWidget( content );   // Prevent mem leak
-        return;
+        return; // Nothing changed since the last time
     }
 
-    QLabel * pkgNameLabel = new QLabel( this );
-
-    if ( ! selectable->theObj() )
-        return;
+    _shownSelectable     = selectable;
+    _shownGeneration     = PoolGeneration::current();
+    _isMixedMultiVersion = isMixedMultiVersion( selectable );
 
-    _layout->addWidget( pkgNameLabel );
+    // Hide the rows while rebinding them to avoid intermediate repaints
+    // and geometry updates
 
-    QFont font = pkgNameLabel->font();
-    font.setBold( true );
+    _content->setUpdatesEnabled( false );
+    hideAllRows();
 
-    QFontMetrics fm( font) ;
-    font.setPixelSize( (int) ( fm.height() * 1.1 ) );
+    if ( ! selectable || ! selectable->theObj() )
+    {
+        _pkgNameLabel->hide();
+        _content->setUpdatesEnabled( true );
+        return;
+    }
 
-    pkgNameLabel->setFont( font );
-    pkgNameLabel->setText( fromUTF8(selectable->theObj()->name().c_str()) );
+    _pkgNameLabel->setText( fromUTF8( selectable->theObj()->name().c_str() ) );
+    _pkgNameLabel->show();
 
     if ( selectable->multiversionInstall() ) // at least one (!) PoolItem is multiversion
     {
@@ -150,19 +192,16 @@ YQPkgVersionsView::showDetails( ZyppSel selectable )
         // Find installed and available objects (for multiversion view)
         //
         {
+            int index = 0;
+
             for ( zypp::ui::Selectable::picklist_iterator it = selectable->picklistBegin();
                   it != selectable->picklistEnd();
                   ++it )
             {
-                YQPkgMultiVersion * version = new YQPkgMultiVersion( this, selectable, *it );
-
-                _layout->addWidget( version );
+                YQPkgMultiVersion * version = multiVersionRow( index++ );
 
-                connect( version, SIGNAL( statusChanged() ),
-                         this,    SIGNAL( statusChanged() ) );
-
-                connect( this,    SIGNAL( statusChanged() ),
-                         version, SLOT  ( update()        ) );
+                version->setZyppPoolItem( selectable, *it );
+                version->show();
             }
         }
     }
@@ -172,6 +211,8 @@ YQPkgVersionsView::showDetails( ZyppSel selectable )
         // Fill installed objects
         //
         {
+            int index = 0;
+
             for ( zypp::ui::Selectable::installed_iterator it = selectable->installedBegin();
                   it != selectable->installedEnd();
                   ++it )
@@ -196,22 +237,15 @@ YQPkgVersionsView::showDetails( ZyppSel selectable )
                         .arg( fromUTF8( (*it)->vendor().c_str() ) ) ;
                 }
 
-                QWidget * installedVersion = new QWidget( this );
-                QHBoxLayout * instLayout = new QHBoxLayout( installedVersion );
-                instLayout->setContentsMargins( 0, 0, 0, 0 );
-
-                QLabel * icon = new QLabel( installedVersion );
-                icon->setPixmap( YQIconPool::pkgSatisfied() );
-                instLayout->addWidget( icon );
-
-                QLabel * textLabel = new QLabel( text, installedVersion );
-                instLayout->addWidget( textLabel );
-                instLayout->addStretch();
+                QLabel * textLabel = installedRow( index++ );
+                textLabel->setText( text );
 
                 if ( retracted )
                     setRetractedColor( textLabel );
+                else
+                    textLabel->setPalette( QPalette() );
 
-                _layout->addWidget( installedVersion );
+                textLabel->parentWidget()->show();
             }
         }
 
@@ -220,17 +254,16 @@ YQPkgVersionsView::showDetails( ZyppSel selectable )
         // Fill available objects
         //
         {
+            int index = 0;
+
             for ( zypp::ui::Selectable::available_iterator it = selectable->availableBegin();
                   it != selectable->availableEnd();
                   ++it)
             {
-                YQPkgVersion *radioButton = new YQPkgVersion( this, selectable, *it );
-
-                connect( radioButton, SIGNAL( clicked( bool )            ),
-                         this,        SLOT  ( checkForChangedCandidate() ) );
+                YQPkgVersion * radioButton = versionRow( index++ );
 
-                _buttonGroup->addButton( radioButton );
-                _layout->addWidget( radioButton );
+                radioButton->setZyppObj( selectable, *it );
+                radioButton->show();
 
                 if ( ! _buttonGroup->checkedButton() &&
                      selectable->hasCandidateObj() &&
@@ -243,13 +276,104 @@ YQPkgVersionsView::showDetails( ZyppSel selectable )
         }
     }
 
-    _layout->addStretch();
+    _content->setUpdatesEnabled( true );
+}
+
+
+void
+YQPkgVersionsView::hideAllRows()
+{
+    for ( QLabel * label: _installedLabels )
+        label->parentWidget()->hide();
+
+    // An exclusive button group does not allow unchecking its checked button
+
+    _buttonGroup->setExclusive( false );
+
+    for ( YQPkgVersion * version: _versionRows )
+    {
+        version->setChecked( false );
+        version->hide();
+    }
+
+    _buttonGroup->setExclusive( true );
+
+    for ( YQPkgMultiVersion * version: _multiVersionRows )
+        version->hide();
+}
 
-    // This really needs to wait until this point, or the content will never
-    // get its correct size and become visible.
 
-    setWidget( content );
-    content->show();
+QLabel *
+YQPkgVersionsView::installedRow( int index )
+{
+    while ( _installedLabels.size() <= index )
+    {
+        QWidget * installedVersion = new QWidget( _content );
+        CHECK_NEW( installedVersion );
+
+        QHBoxLayout * instLayout = new QHBoxLayout( installedVersion );
+        instLayout->setContentsMargins( 0, 0, 0, 0 );
+
+        QLabel * icon = new QLabel( installedVersion );
+        icon->setPixmap( YQIconPool::pkgSatisfied() );
+        instLayout->addWidget( icon );
+
+        QLabel * textLabel = new QLabel( installedVersion );
+        instLayout->addWidget( textLabel );
+        instLayout->addStretch();
+
+        // Installed rows come right after the package name label
+
+        _layout->insertWidget( 1 + _installedLabels.size(), installedVersion );
+        _installedLabels << textLabel;
+    }
+
+    return _installedLabels.at( index );
+}
+
+
+YQPkgVersion *
+YQPkgVersionsView::versionRow( int index )
+{
+    while ( _versionRows.size() <= index )
+    {
+        YQPkgVersion * radioButton = new YQPkgVersion( _content, ZyppSel(), ZyppObj() );
+        CHECK_NEW( radioButton );
+
+        connect( radioButton, SIGNAL( clicked( bool )            ),
+                 this,        SLOT  ( checkForChangedCandidate() ) );
+
+        _buttonGroup->addButton( radioButton );
+        _layout->insertWidget( 1 + _installedLabels.size() + _versionRows.size(),
+                               radioButton );
+        _versionRows << radioButton;
+    }
+
+    return _versionRows.at( index );
+}
+
+
+YQPkgMultiVersion *
+YQPkgVersionsView::multiVersionRow( int index )
+{
+    while ( _multiVersionRows.size() <= index )
+    {
+        YQPkgMultiVersion * version = new YQPkgMultiVersion( this, ZyppSel(), ZyppPoolItem() );
+        CHECK_NEW( version );
+
+        connect( version, SIGNAL( statusChanged() ),
+                 this,    SIGNAL( statusChanged() ) );
+
+        connect( this,    SIGNAL( statusChanged() ),
+                 version, SLOT  ( update()        ) );
+
+        // Multiversion rows go last, right before the stretch
+
+        _layout->insertWidget( _layout->count() - 1, version );
+        _multiVersionRows << version;
+    }
+
+    return _multiVersionRows.at( index );
 }
 
 
@@ -340,6 +464,8 @@ YQPkgVersionsView::checkForChangedCandidate()
                 // Set candidate
 
                 _selectable->setCandidate( newCandidate );
+                PoolGeneration::invalidate();
+                PkgIndex::instance()->statusChanged( _selectable );
                 emit candidateChanged( newCandidate );
                 return;
             }
@@ -531,9 +657,23 @@ YQPkgVersion::YQPkgVersion( QWidget * parent,
                             ZyppSel   selectable,
                             ZyppObj   zyppObj )
     : QRadioButton( parent )
-    , _selectable( selectable )
-    , _zyppObj( zyppObj )
 {
+    setZyppObj( selectable, zyppObj );
+}
+
+
+void
+YQPkgVersion::setZyppObj( ZyppSel selectable, ZyppObj zyppObj )
+{
+    _selectable = selectable;
+    _zyppObj    = zyppObj;
+
+    if ( ! zyppObj )
+    {
+        setText( "" );
+        return;
+    }
+
     if ( zyppObj->isRetracted() )
     {
         // Translators: %1 is a package version, %2 the package architecture,
@@ -556,6 +696,8 @@ YQPkgVersion::YQPkgVersion( QWidget * parent,
     }
     else
     {
+        setPalette( QPalette() );
+
         // Translators: %1 is a package version, %2 the package architecture,
         // %3 describes the repository where it comes from,
         // %4 is the repository's priority
@@ -600,9 +742,26 @@ YQPkgMultiVersion::YQPkgMultiVersion( YQPkgVersionsView * parent,
                                       ZyppPoolItem        zyppPoolItem )
     : QCheckBox( parent )
     , _parent( parent )
-    , _selectable( selectable )
-    , _zyppPoolItem( zyppPoolItem )
 {
+    setZyppPoolItem( selectable, zyppPoolItem );
+
+    connect( this, SIGNAL( toggled( bool)    ),
+             this, SLOT  ( slotIconClicked() ) );
+}
+
+
+void
+YQPkgMultiVersion::setZyppPoolItem( ZyppSel selectable, ZyppPoolItem zyppPoolItem )
+{
+    _selectable   = selectable;
+    _zyppPoolItem = zyppPoolItem;
+
+    if ( ! zyppPoolItem )
+    {
+        setText( "" );
+        return;
+    }
+
     setText (_( "%1-%2 from %3 with priority %4 and vendor %5" )
              .arg( fromUTF8( zyppPoolItem->edition().asString().c_str() ) )
              .arg( fromUTF8( zyppPoolItem->arch().asString().c_str() ) )
@@ -610,8 +769,7 @@ YQPkgMultiVersion::YQPkgMultiVersion( YQPkgVersionsView * parent,
              .arg( zyppPoolItem->repository().info().priority() )
              .arg( fromUTF8( zyppPoolItem->vendor().c_str() ) ));
 
-    connect( this, SIGNAL( toggled( bool)    ),
-             this, SLOT  ( slotIconClicked() ) );
+    update();
 }
 
 
@@ -696,6 +854,8 @@ void YQPkgMultiVersion::setStatus( ZyppStatus newStatus )
 {
     logInfo() << "Setting pick status to " << newStatus << endl;
     _selectable->setPickStatus( _zyppPoolItem, newStatus );
+    PoolGeneration::invalidate();
+    PkgIndex::instance()->statusChanged( _selectable );
 }
 
 
@@ -32,6 +32,8 @@
 class QTabWidget;
 class QVBoxLayout;
 class QButtonGroup;
+class QLabel;
+class YQPkgVersion;
 class YQPkgMultiVersion;
 
 
@@ -39,6 +41,10 @@ class YQPkgMultiVersion;
  * Package version selector: Display a list of available versions from
  * all the different installation sources and let the user change the candidate
  * version for installation / update.
+ *
+ * The row widgets are kept in pools and rebound to the data of the next
+ * selectable instead of being deleted and recreated on every selection
+ * change.
  **/
 class YQPkgVersionsView: public QScrollArea
 {
@@ -142,9 +148,36 @@ protected:
 
     /**
      * Show details for the specified package.
+     *
+     * This does nothing if the same selectable is already shown and the
+     * pool did not change since then.
      **/
     void showDetails( ZyppSel selectable );
 
+    /**
+     * Show pending details when this view becomes visible and it is not
+     * embedded into a QTabWidget.
+     *
+     * Reimplemented from QWidget.
+     **/
+    virtual void showEvent( QShowEvent * event ) override;
+
+    /**
+     * Return row widget no. 'index' from the respective pool, creating and
+     * connecting it if the pool is not large enough yet.
+     *
+     * For installed versions, this is the text label; the row widget
+     * is its parent.
+     **/
+    QLabel *            installedRow   ( int index );
+    YQPkgVersion *      versionRow     ( int index );
+    YQPkgMultiVersion * multiVersionRow( int index );
+
+    /**
+     * Hide all row widgets and uncheck all version radio buttons.
+     **/
+    void hideAllRows();
+
     /**
      * Ask user if he really wants to install incompatible package versions.
      * Return 'true' if he hits [Continue], 'false' if [Cancel].
@@ -167,8 +200,22 @@ protected:
     QTabWidget  *  _parentTab;
     ZyppSel        _selectable;
     bool           _isMixedMultiVersion;
+    QWidget *      _content;
     QButtonGroup * _buttonGroup;
     QVBoxLayout *  _layout;
+    QLabel *       _pkgNameLabel;
+
+    // Widget pools
+
+    QList<QLabel *>            _installedLabels;
+    QList<YQPkgVersion *>      _versionRows;
+    QList<YQPkgMultiVersion *> _multiVersionRows;
+
+    // What is currently shown
+
+    ZyppSel        _shownSelectable;
+    int            _shownGeneration;
+    bool           _pendingDetails;
 };
 
 
@@ -189,6 +236,11 @@ public:
      **/
     virtual ~YQPkgVersion();
 
+    /**
+     * Rebind this item to another ZYPP object and update its text.
+     **/
+    void setZyppObj( ZyppSel selectable, ZyppObj zyppObj );
+
     /**
      * Returns the original ZYPP object
      **/
@@ -236,6 +288,11 @@ public:
      **/
     virtual ~YQPkgMultiVersion();
 
+    /**
+     * Rebind this item to another pool item and update its text.
+     **/
+    void setZyppPoolItem( ZyppSel selectable, ZyppPoolItem zyppPoolItem );
+
     /**
      * Returns the original ZYPP object
      **/
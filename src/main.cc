@@ -16,12 +16,17 @@
 
 
 #include <iostream>	// cerr
+#include <string.h>	// strcmp()
 
 #include <QApplication>
 #include <QObject>
 
 #include "Logger.h"
 #include "MyrlynApp.h"
+#include "MyrlynRepoManager.h"
+#include "RepoProber.h"
+#include "SolverWorker.h"
+#include "StartupTimer.h"
 
 
 using std::cerr;
@@ -44,6 +49,8 @@ void usage()
 	 << "  -n | --dry-run\n"
 	 << "  -d | --download-only\n"
          << "  -f | --no-repo-refresh\n"
+         << "  -s | --fast-start\n"
+         << "  --no-verify\n"
 	 << "  -h | --help \n"
 	 << "\n"
 	 << "Debugging options:\n"
@@ -52,6 +59,7 @@ void usage()
 	 << "  --fake-commit\n"
 	 << "  --fake-summary\n"
          << "  --slow-repo-refresh\n"
+         << "  --serial-repo-refresh\n"
 	 << "\n"
 	 << std::endl;
 
@@ -95,10 +103,13 @@ parseCommandLineOptions( QStringList & argList )
     if ( commandLineOption( "--dry-run",            "-n", argList ) ) optFlags |= OptDryRun;
     if ( commandLineOption( "--download-only",      "-d", argList ) ) optFlags |= OptDownloadOnly;
     if ( commandLineOption( "--no-repo-refresh",    "-f", argList ) ) optFlags |= OptNoRepoRefresh;
+    if ( commandLineOption( "--fast-start",         "-s", argList ) ) optFlags |= OptFastStart;
+    if ( commandLineOption( "--no-verify",          "" ,  argList ) ) optFlags |= OptNoVerify;
     if ( commandLineOption( "--fake-root",          "" ,  argList ) ) optFlags |= OptFakeRoot;
     if ( commandLineOption( "--fake-commit",        "" ,  argList ) ) optFlags |= OptFakeCommit;
     if ( commandLineOption( "--fake-summary",       "" ,  argList ) ) optFlags |= OptFakeSummary;
     if ( commandLineOption( "--slow-repo-refresh",  "" ,  argList ) ) optFlags |= OptSlowRepoRefresh;
+    if ( commandLineOption( "--serial-repo-refresh", "" , argList ) ) optFlags |= OptSerialRepoRefresh;
     if ( commandLineOption( "--help",               "-h", argList ) ) usage(); // this will exit
 
     if ( ! argList.isEmpty() )
@@ -122,8 +133,84 @@ void logVersion()
 }
 
 
+/**
+ * Refresh one repo in a worker process that the MyrlynRepoManager started
+ * for a parallel repos refresh:
+ *
+ *   myrlyn --refresh-repo-worker <alias> [--slow-repo-refresh]
+ *
+ * Return the exit code for the process.
+ **/
+int refreshRepoWorker( int argc, char *argv[] )
+{
+    QString alias = QString::fromUtf8( argv[2] );
+    bool    slow  = argc > 3 && strcmp( argv[3], "--slow-repo-refresh" ) == 0;
+
+    // Use a separate log file for each worker: They run at the same time.
+
+    Logger logger( "/tmp/myrlyn-$USER", QString( "myrlyn-refresh-%1.log" ).arg( alias ) );
+    logVersion();
+
+    return MyrlynRepoManager::refreshRepoWorker( alias, slow );
+}
+
+
+/**
+ * Verify the system dependencies in a worker process that a SolverWorker
+ * started:
+ *
+ *   myrlyn --solver-worker [<resolver flag>...] [--repo <alias>...]
+ *
+ * Return the exit code for the process.
+ **/
+int solverWorker( int argc, char *argv[] )
+{
+    QStringList args;
+
+    for ( int i=2; i < argc; i++ )
+        args << QString::fromUtf8( argv[i] );
+
+    Logger logger( "/tmp/myrlyn-$USER", "myrlyn-solver.log" );
+    logVersion();
+
+    return SolverWorker::runWorker( args );
+}
+
+
+/**
+ * Probe one candidate URL for a repo in a worker process that a RepoProber
+ * started:
+ *
+ *   myrlyn --probe-repo-worker <no> <url>
+ *
+ * Return the exit code for the process.
+ **/
+int probeRepoWorker( int argc, char *argv[] )
+{
+    QString no  = QString::fromUtf8( argv[2] );
+    QString url = QString::fromUtf8( argv[3] );
+
+    // Use a separate log file for each worker: They run at the same time.
+
+    Logger logger( "/tmp/myrlyn-$USER", QString( "myrlyn-probe-%1.log" ).arg( no ) );
+    logVersion();
+
+    return RepoProber::runWorker( url );
+}
+
+
 int main( int argc, char *argv[] )
 {
+    if ( argc > 2 && strcmp( argv[1], "--refresh-repo-worker" ) == 0 )
+        return refreshRepoWorker( argc, argv );
+
+    if ( argc > 1 && strcmp( argv[1], "--solver-worker" ) == 0 )
+        return solverWorker( argc, argv );
+
+    if ( argc > 3 && strcmp( argv[1], "--probe-repo-worker" ) == 0 )
+        return probeRepoWorker( argc, argv );
+
+    StartupTimer::instance(); // Start the clock for the startup phases
     Logger logger( "/tmp/myrlyn-$USER", "myrlyn.log" );
     logVersion();
 